@@ -0,0 +1,202 @@
+/**
+ * \file affinity.cpp
+ * \brief Implementation of thread pinning.
+ */
+
+#include "cowichan.hpp"
+
+#if defined(__linux__)
+#include <sched.h>
+#include <cstdio>
+#endif
+
+/**
+ * Mode used by affinity_pin.
+ */
+static PinMode pinMode = PIN_NONE;
+
+PinMode affinity_mode()
+{
+  return pinMode;
+}
+
+#if defined(__linux__)
+
+/**
+ * \brief One processor of the initial set and where it sits.
+ */
+struct Processor {
+  int cpu;      ///< processor number.
+  int package;  ///< physical package (socket).
+  int core;     ///< core within the package.
+  int sibling;  ///< hardware thread within the core, counted from 0.
+  int coreRank; ///< rank of the core within the package, counted from 0.
+};
+
+/**
+ * Processors the program was started on.
+ */
+static cpu_set_t initialSet;
+
+/**
+ * Processors of the initial set in compact and scatter order (empty until
+ * the first call to affinity_set_mode).
+ */
+static std::vector<int> compactOrder, scatterOrder;
+
+/**
+ * Read one topology value of a processor from sysfs.
+ * \param cpu processor number.
+ * \param name file in the topology directory.
+ * \return The value, or -1 if it cannot be read.
+ */
+static int read_topology(int cpu, const char* name)
+{
+  char path[128];
+  int value = -1;
+
+  snprintf (path, sizeof(path),
+      "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+  FILE* file = fopen (path, "r");
+  if (file != NULL) {
+    if (fscanf (file, "%d", &value) != 1) {
+      value = -1;
+    }
+    fclose (file);
+  }
+  return value;
+}
+
+static bool compact_before(const Processor& a, const Processor& b)
+{
+  if (a.package != b.package) {
+    return a.package < b.package;
+  }
+  if (a.core != b.core) {
+    return a.core < b.core;
+  }
+  return a.cpu < b.cpu;
+}
+
+static bool scatter_before(const Processor& a, const Processor& b)
+{
+  if (a.sibling != b.sibling) {
+    return a.sibling < b.sibling;
+  }
+  if (a.coreRank != b.coreRank) {
+    return a.coreRank < b.coreRank;
+  }
+  if (a.package != b.package) {
+    return a.package < b.package;
+  }
+  return a.cpu < b.cpu;
+}
+
+/**
+ * Record the initial processor set and both pin orders.
+ */
+static void find_processors()
+{
+  std::vector<Processor> processors;
+
+  if (sched_getaffinity (0, sizeof(initialSet), &initialSet) != 0) {
+    return;
+  }
+
+  try {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET (cpu, &initialSet)) {
+        Processor processor;
+        processor.cpu = cpu;
+        // without topology every processor is a core of its own
+        processor.package = std::max (read_topology (cpu,
+            "physical_package_id"), 0);
+        processor.core = read_topology (cpu, "core_id");
+        if (processor.core < 0) {
+          processor.core = cpu;
+        }
+        processors.push_back (processor);
+      }
+    }
+
+    std::sort (processors.begin(), processors.end(), compact_before);
+    for (size_t i = 0; i < processors.size(); i++) {
+      Processor& processor = processors[i];
+      processor.sibling = 0;
+      processor.coreRank = 0;
+      if (i > 0) {
+        const Processor& previous = processors[i - 1];
+        if (processor.package == previous.package) {
+          if (processor.core == previous.core) {
+            processor.sibling = previous.sibling + 1;
+            processor.coreRank = previous.coreRank;
+          }
+          else {
+            processor.coreRank = previous.coreRank + 1;
+          }
+        }
+      }
+      compactOrder.push_back (processor.cpu);
+    }
+
+    std::sort (processors.begin(), processors.end(), scatter_before);
+    for (size_t i = 0; i < processors.size(); i++) {
+      scatterOrder.push_back (processors[i].cpu);
+    }
+  }
+  catch (...) {out_of_memory();}
+}
+
+void affinity_set_mode(PinMode mode)
+{
+  // first call comes from the main thread, before any thread is pinned
+  if (compactOrder.empty()) {
+    find_processors ();
+  }
+  pinMode = mode;
+}
+
+int affinity_cpu(index_t slot)
+{
+  const std::vector<int>& order = (pinMode == PIN_SCATTER) ? scatterOrder
+      : compactOrder;
+
+  if ((pinMode == PIN_NONE) || order.empty()) {
+    return -1;
+  }
+  return order[slot % order.size()];
+}
+
+void affinity_pin(index_t slot)
+{
+  int cpu = affinity_cpu (slot);
+
+  if (cpu < 0) {
+    if (!compactOrder.empty()) {
+      sched_setaffinity (0, sizeof(initialSet), &initialSet);
+    }
+    return;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO (&set);
+  CPU_SET (cpu, &set);
+  sched_setaffinity (0, sizeof(set), &set);
+}
+
+#else                // no thread affinity
+
+void affinity_set_mode(PinMode mode)
+{
+  pinMode = mode;
+}
+
+int affinity_cpu(index_t /* slot */)
+{
+  return -1;
+}
+
+void affinity_pin(index_t /* slot */) { }
+
+#endif
+
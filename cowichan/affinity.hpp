@@ -0,0 +1,50 @@
+/**
+ * \file affinity.hpp
+ * \brief Pinning of worker threads to processors.
+ */
+
+#ifndef __affinity_hpp__
+#define __affinity_hpp__
+
+/**
+ * \brief How worker threads are placed on processors.
+ *
+ * Thread (or process) i of an implementation is given slot i; each slot maps
+ * to one processor of the set the program was started on, in an order that
+ * depends on the mode. Slots beyond the number of processors wrap around.
+ */
+enum PinMode {
+  PIN_NONE,     ///< leave placement to the operating system.
+  PIN_COMPACT,  ///< fill the hardware threads of a core, then the next core.
+  PIN_SCATTER   ///< one thread per package in turn, then per core, then
+                ///< hardware threads of the same core last.
+};
+
+/**
+ * Set the pin mode used by later calls to affinity_pin.
+ * \param mode pin mode.
+ */
+void affinity_set_mode(PinMode mode);
+
+/**
+ * \return The current pin mode.
+ */
+PinMode affinity_mode();
+
+/**
+ * Pin the calling thread to the processor of a slot in the current mode, or
+ * with PIN_NONE give it back the processors the program was started on.
+ * Does nothing where thread affinity is not supported.
+ * \param slot thread (or process) number, starting from 0.
+ */
+void affinity_pin(index_t slot);
+
+/**
+ * \param slot thread (or process) number, starting from 0.
+ * \return The processor of the slot in the current mode, or -1 for PIN_NONE
+ * and where thread affinity is not supported.
+ */
+int affinity_cpu(index_t slot);
+
+#endif
+
@@ -0,0 +1,466 @@
+/**
+ * \file benchmark.cpp
+ * \brief Implementation of the kernel timing harness.
+ */
+
+#include "benchmark.hpp"
+#include <fstream>
+
+/**
+ * Print a size or count, or none in its place if it is 0 (not used or not
+ * measured).
+ * \param out stream to print to.
+ * \param value the size.
+ * \param none what to print for 0.
+ */
+template <class T>
+static void print_measured(std::ostream& out, T value, const char* none)
+{
+  if (value > 0) {
+    out << value;
+  }
+  else {
+    out << none;
+  }
+}
+
+Benchmark::Benchmark(const std::string& name, index_t nr, index_t nc,
+    index_t n, index_t threads): name(name), nr(nr), nc(nc), n(n),
+    threads(threads), peakBytes(0), flops(0.0), baseline(NULL)
+{
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    counterSums[i] = 0.0;
+    counterRuns[i] = 0;
+  }
+}
+
+void Benchmark::add(double seconds)
+{
+  samples.push_back(seconds);
+}
+
+void Benchmark::addPeak(size_t bytes)
+{
+  peakBytes = std::max(peakBytes, bytes);
+}
+
+void Benchmark::addCounters(const PerfSample& start, const PerfSample& end,
+    double flops)
+{
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    if (start.valid[i] && end.valid[i]) {
+      counterSums[i] += (double)(end.value[i] - start.value[i]);
+      counterRuns[i]++;
+    }
+  }
+  this->flops = flops;
+}
+
+double Benchmark::counter(PerfCounter counter) const
+{
+  if (counterRuns[counter] == 0) {
+    return 0.0;
+  }
+  return counterSums[counter] / (double)counterRuns[counter];
+}
+
+double Benchmark::ipc() const
+{
+  if (!hasIpc()) {
+    return 0.0;
+  }
+  return counter(PERF_INSTRUCTIONS) / counter(PERF_CYCLES);
+}
+
+double Benchmark::bytesPerFlop() const
+{
+  if (!hasBytesPerFlop()) {
+    return 0.0;
+  }
+  return counter(PERF_LLC_MISSES) * CACHE_LINE_SIZE / flops;
+}
+
+double Benchmark::speedup() const
+{
+  if (!hasScaling()) {
+    return 0.0;
+  }
+  return baseline->median() / median();
+}
+
+double Benchmark::efficiency() const
+{
+  if (!hasScaling()) {
+    return 0.0;
+  }
+  return speedup() / (double)threads;
+}
+
+double Benchmark::serialFraction() const
+{
+  if (!hasSerialFraction()) {
+    return 0.0;
+  }
+  double p = (double)threads;
+  return (1.0 / speedup() - 1.0 / p) / (1.0 - 1.0 / p);
+}
+
+bool Benchmark::matches(const std::string& name, index_t nr, index_t nc,
+    index_t n, index_t threads) const
+{
+  return (this->name == name) && (this->nr == nr) && (this->nc == nc)
+      && (this->n == n) && (this->threads == threads);
+}
+
+double Benchmark::min() const
+{
+  if (samples.empty()) {
+    return 0.0;
+  }
+  return *std::min_element(samples.begin(), samples.end());
+}
+
+double Benchmark::max() const
+{
+  if (samples.empty()) {
+    return 0.0;
+  }
+  return *std::max_element(samples.begin(), samples.end());
+}
+
+double Benchmark::mean() const
+{
+  if (samples.empty()) {
+    return 0.0;
+  }
+
+  double sum = 0.0;
+  std::vector<double>::const_iterator it;
+  for (it = samples.begin(); it != samples.end(); ++it) {
+    sum += *it;
+  }
+  return sum / (double)samples.size();
+}
+
+double Benchmark::stddev() const
+{
+  if (samples.size() < 2) {
+    return 0.0;
+  }
+
+  double m = mean();
+  double sum = 0.0;
+  std::vector<double>::const_iterator it;
+  for (it = samples.begin(); it != samples.end(); ++it) {
+    sum += (*it - m) * (*it - m);
+  }
+  return sqrt(sum / (double)(samples.size() - 1));
+}
+
+double Benchmark::percentile(double p) const
+{
+  if (samples.empty()) {
+    return 0.0;
+  }
+
+  std::vector<double> sorted(samples);
+  std::sort(sorted.begin(), sorted.end());
+
+  // nearest rank: ceil(p / 100 * count), counted from 1
+  index_t rank = (index_t)ceil(p / 100.0 * (double)sorted.size());
+  if (rank < 1) {
+    rank = 1;
+  }
+  if (rank > (index_t)sorted.size()) {
+    rank = (index_t)sorted.size();
+  }
+  return sorted[rank - 1];
+}
+
+double Benchmark::median() const
+{
+  if (samples.empty()) {
+    return 0.0;
+  }
+
+  std::vector<double> sorted(samples);
+  std::sort(sorted.begin(), sorted.end());
+
+  size_t mid = sorted.size() / 2;
+  if (sorted.size() % 2 == 0) {
+    return (sorted[mid - 1] + sorted[mid]) / 2.0;
+  }
+  return sorted[mid];
+}
+
+void Benchmark::printJSON(std::ostream& out) const
+{
+  out << "{\"name\": \"" << name << "\", \"nr\": ";
+  print_measured(out, nr, "null");
+  out << ", \"nc\": ";
+  print_measured(out, nc, "null");
+  out << ", \"n\": ";
+  print_measured(out, n, "null");
+  out << ", \"threads\": " << threads
+      << ", \"repeats\": " << count()
+      << ", \"min\": " << min() << ", \"median\": " << median()
+      << ", \"p95\": " << percentile(95.0) << ", \"max\": " << max()
+      << ", \"mean\": " << mean() << ", \"stddev\": " << stddev()
+      << ", \"peak_bytes\": ";
+  print_measured(out, peakBytes, "null");
+  out << ", \"samples\": [";
+  for (size_t i = 0; i < samples.size(); i++) {
+    out << (i == 0 ? "" : ", ") << samples[i];
+  }
+  out << "], \"counters\": {";
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    out << "\"" << PerfCounters::name((PerfCounter)i) << "\": ";
+    if (hasCounter((PerfCounter)i)) {
+      out << counter((PerfCounter)i) << ", ";
+    }
+    else {
+      out << "null, ";
+    }
+  }
+  out << "\"ipc\": ";
+  if (hasIpc()) {
+    out << ipc();
+  }
+  else {
+    out << "null";
+  }
+  out << ", \"bytes_per_flop\": ";
+  if (hasBytesPerFlop()) {
+    out << bytesPerFlop();
+  }
+  else {
+    out << "null";
+  }
+  out << "}, \"speedup\": ";
+  if (hasScaling()) {
+    out << speedup() << ", \"efficiency\": " << efficiency();
+  }
+  else {
+    out << "null, \"efficiency\": null";
+  }
+  out << ", \"serial_fraction\": ";
+  if (hasSerialFraction()) {
+    out << serialFraction();
+  }
+  else {
+    out << "null";
+  }
+  out << "}";
+}
+
+void Benchmark::printCSV(std::ostream& out) const
+{
+  // empty fields for sizes the kernel does not use
+  out << name << ",";
+  print_measured(out, nr, "");
+  out << ",";
+  print_measured(out, nc, "");
+  out << ",";
+  print_measured(out, n, "");
+  out << "," << threads << "," << count() << ","
+      << min() << "," << median() << "," << percentile(95.0) << "," << max()
+      << "," << mean() << "," << stddev() << ",";
+  print_measured(out, peakBytes, "");
+  // empty fields for counters that were not read
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    out << ",";
+    if (hasCounter((PerfCounter)i)) {
+      out << counter((PerfCounter)i);
+    }
+  }
+  out << ",";
+  if (hasIpc()) {
+    out << ipc();
+  }
+  out << ",";
+  if (hasBytesPerFlop()) {
+    out << bytesPerFlop();
+  }
+  out << ",";
+  if (hasScaling()) {
+    out << speedup() << "," << efficiency();
+  }
+  else {
+    out << ",";
+  }
+  out << ",";
+  if (hasSerialFraction()) {
+    out << serialFraction();
+  }
+  out << std::endl;
+}
+
+void Benchmark::printText(std::ostream& out) const
+{
+  out << name << " (";
+  if (nr > 0) {
+    out << nr << "x" << nc << ", ";
+  }
+  if (n > 0) {
+    out << "n " << n << ", ";
+  }
+  out << threads << " threads): ";
+  if (count() == 1) {
+    out << min() << " seconds";
+  }
+  else {
+    out << "min " << min() << ", median " << median() << ", p95 "
+        << percentile(95.0) << ", stddev " << stddev() << " seconds ("
+        << count() << " runs)";
+  }
+  if (peakBytes > 0) {
+    out << ", peak " << (double)peakBytes / (1 << 20) << " MB";
+  }
+  if (hasIpc()) {
+    out << ", IPC " << ipc();
+  }
+  if (hasBytesPerFlop()) {
+    out << ", " << bytesPerFlop() << " bytes/flop";
+  }
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    if ((i != PERF_CYCLES) && (i != PERF_INSTRUCTIONS)
+        && hasCounter((PerfCounter)i)) {
+      out << ", " << PerfCounters::name((PerfCounter)i) << " "
+          << counter((PerfCounter)i);
+    }
+  }
+  if (hasScaling() && (threads != 1)) {
+    out << ", speedup " << speedup() << ", efficiency " << efficiency();
+  }
+  if (hasSerialFraction()) {
+    out << ", serial fraction " << serialFraction();
+  }
+  out << std::endl;
+}
+
+/*****************************************************************************/
+
+BenchmarkSuite::BenchmarkSuite(): warmups(BENCHMARK_WARMUPS),
+    repeats(BENCHMARK_REPEATS), format(BENCHMARK_TEXT),
+    counters(PERF_COUNTERS) { }
+
+BenchmarkSuite::~BenchmarkSuite()
+{
+  std::vector<Benchmark*>::iterator it;
+  for (it = benchmarks.begin(); it != benchmarks.end(); ++it) {
+    delete *it;
+  }
+}
+
+Benchmark* BenchmarkSuite::find(const char* name, index_t nr, index_t nc,
+    index_t n, index_t threads)
+{
+  std::vector<Benchmark*>::iterator it;
+  for (it = benchmarks.begin(); it != benchmarks.end(); ++it) {
+    if ((*it)->matches(name, nr, nc, n, threads)) {
+      return *it;
+    }
+  }
+
+  Benchmark* benchmark = NULL;
+  try {
+    benchmark = new Benchmark(name, nr, nc, n, threads);
+    benchmarks.push_back(benchmark);
+  }
+  catch (...) {out_of_memory();}
+
+  // link 1-thread baselines and the other thread counts in either order
+  for (it = benchmarks.begin(); it != benchmarks.end(); ++it) {
+    if ((*it)->matches(name, nr, nc, n, 1)) {
+      benchmark->setBaseline(*it);
+    }
+    if ((threads == 1) && (*it)->matches(name, nr, nc, n,
+        (*it)->getThreads())) {
+      (*it)->setBaseline(benchmark);
+    }
+  }
+
+  return benchmark;
+}
+
+void BenchmarkSuite::record(const char* name, index_t nr, index_t nc,
+    index_t n, index_t threads, index_t run, INT64 start, INT64 end)
+{
+  if (run < warmups) {
+    return;
+  }
+  find(name, nr, nc, n, threads)->add(((double)(end - start))
+      / ((double)get_freq()));
+}
+
+void BenchmarkSuite::recordCounters(const char* name, index_t nr,
+    index_t nc, index_t n, index_t threads, index_t run,
+    const PerfSample& start, const PerfSample& end, double flops)
+{
+  if (run < warmups) {
+    return;
+  }
+  find(name, nr, nc, n, threads)->addCounters(start, end, flops);
+}
+
+void BenchmarkSuite::recordPeak(const char* name, index_t nr, index_t nc,
+    index_t n, index_t threads, size_t bytes)
+{
+  find(name, nr, nc, n, threads)->addPeak(bytes);
+}
+
+void BenchmarkSuite::report(std::ostream& out, BenchmarkFormat format) const
+{
+  std::streamsize precision = out.precision(9);
+  std::vector<Benchmark*>::const_iterator it;
+
+  switch (format) {
+  case BENCHMARK_TEXT:
+    out.precision(5);
+    for (it = benchmarks.begin(); it != benchmarks.end(); ++it) {
+      (*it)->printText(out);
+    }
+    break;
+
+  case BENCHMARK_JSON:
+    out << "{\"warmups\": " << warmups << ", \"benchmarks\": [" << std::endl;
+    for (it = benchmarks.begin(); it != benchmarks.end(); ++it) {
+      out << "  ";
+      (*it)->printJSON(out);
+      out << ((it + 1 == benchmarks.end()) ? "" : ",") << std::endl;
+    }
+    out << "]}" << std::endl;
+    break;
+
+  case BENCHMARK_CSV:
+    out << "name,nr,nc,n,threads,repeats,min,median,p95,max,mean,stddev,"
+        << "peak_bytes";
+    for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+      out << "," << PerfCounters::name((PerfCounter)i);
+    }
+    out << ",ipc,bytes_per_flop,speedup,efficiency,serial_fraction"
+        << std::endl;
+    for (it = benchmarks.begin(); it != benchmarks.end(); ++it) {
+      (*it)->printCSV(out);
+    }
+    break;
+  }
+
+  out.precision(precision);
+  out.flush();
+}
+
+void BenchmarkSuite::report() const
+{
+  if (output.empty()) {
+    report(std::cout, format);
+  }
+  else {
+    std::ofstream out(output.c_str());
+    if (!out) {
+      bad_argument("Cannot open output file", output.c_str());
+    }
+    report(out, format);
+  }
+}
+
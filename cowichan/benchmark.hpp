@@ -0,0 +1,400 @@
+/**
+ * \file benchmark.hpp
+ * \brief Kernel timing harness for Cowichan programs.
+ */
+
+#ifndef __benchmark_hpp__
+#define __benchmark_hpp__
+
+#include "cowichan.hpp"
+#include <vector>
+#include <ostream>
+
+/**
+ * \brief Report formats understood by BenchmarkSuite::report.
+ */
+enum BenchmarkFormat {
+  BENCHMARK_TEXT, ///< human readable summary.
+  BENCHMARK_JSON, ///< one JSON document with samples.
+  BENCHMARK_CSV   ///< one line per benchmark, with a header line.
+};
+
+/**
+ * \brief Timing samples of one kernel at one problem size.
+ *
+ * Samples are wall-clock seconds measured with the monotonic clock behind
+ * get_ticks(). Warmup runs are never added.
+ */
+class Benchmark {
+public:
+
+  /**
+   * Construct an empty benchmark.
+   * \param name kernel (or chain step) name.
+   * \param nr number of rows for rectangular matrices (0 if not used).
+   * \param nc number of columns for rectangular matrices (0 if not used).
+   * \param n number of rows/columns for square matrices, vectors and points
+   * (0 if not used).
+   * \param threads number of threads.
+   */
+  Benchmark(const std::string& name, index_t nr, index_t nc, index_t n,
+      index_t threads);
+
+  /**
+   * Add a sample.
+   * \param seconds elapsed time of one run.
+   */
+  void add(double seconds);
+
+  /**
+   * Record the peak memory use of the runs.
+   * \param bytes peak bytes allocated (the largest value is kept).
+   */
+  void addPeak(size_t bytes);
+
+  /**
+   * \return Peak bytes allocated, or 0 if not measured.
+   */
+  size_t peak() const { return peakBytes; }
+
+  /**
+   * Add the hardware counters of one run.
+   * \param start counters before the run.
+   * \param end counters after the run.
+   * \param flops nominal floating point operations of the run (0 if not
+   * known).
+   */
+  void addCounters(const PerfSample& start, const PerfSample& end,
+      double flops);
+
+  /**
+   * \param counter a counter.
+   * \return Whether the counter was read in any run.
+   */
+  bool hasCounter(PerfCounter counter) const {
+    return counterRuns[counter] > 0;
+  }
+
+  /**
+   * \param counter a counter.
+   * \return Mean counter value per run (0 if never read).
+   */
+  double counter(PerfCounter counter) const;
+
+  /**
+   * \return Whether cycles and instructions were both counted.
+   */
+  bool hasIpc() const {
+    return hasCounter(PERF_CYCLES) && hasCounter(PERF_INSTRUCTIONS)
+        && (counterSums[PERF_CYCLES] > 0.0);
+  }
+
+  /**
+   * \return Instructions per cycle (0 if not counted).
+   */
+  double ipc() const;
+
+  /**
+   * \return Whether last level cache misses were counted for a kernel with
+   * a known number of floating point operations.
+   */
+  bool hasBytesPerFlop() const {
+    return hasCounter(PERF_LLC_MISSES) && (flops > 0.0);
+  }
+
+  /**
+   * \return Bytes fetched from memory (one cache line per last level cache
+   * miss) per floating point operation (0 if not known).
+   */
+  double bytesPerFlop() const;
+
+  /**
+   * Set the 1-thread benchmark of the same kernel and size, which scaling
+   * figures are relative to.
+   * \param baseline the 1-thread benchmark.
+   */
+  void setBaseline(const Benchmark* baseline) { this->baseline = baseline; }
+
+  /**
+   * \return Whether speedup and efficiency are known (there is a 1-thread
+   * baseline and both have samples).
+   */
+  bool hasScaling() const {
+    return (baseline != NULL) && (count() > 0) && (baseline->count() > 0)
+        && (median() > 0.0);
+  }
+
+  /**
+   * \return Speedup over the baseline, T1 / Tp of the median times (0 if
+   * not known).
+   */
+  double speedup() const;
+
+  /**
+   * \return Parallel efficiency, speedup / threads (0 if not known).
+   */
+  double efficiency() const;
+
+  /**
+   * \return Whether the serial fraction is known (scaling is known and
+   * there is more than one thread).
+   */
+  bool hasSerialFraction() const {
+    return hasScaling() && (threads > 1) && (speedup() > 0.0);
+  }
+
+  /**
+   * Karp-Flatt metric: the serial fraction e = (1/S - 1/p) / (1 - 1/p) that
+   * explains speedup S on p threads by Amdahl's law. An e that grows with p
+   * points at parallel overhead rather than inherently serial work.
+   * \return Experimentally determined serial fraction (0 if not known).
+   */
+  double serialFraction() const;
+
+  /**
+   * \return Number of threads.
+   */
+  index_t getThreads() const { return threads; }
+
+  /**
+   * Check whether this benchmark matches a kernel and problem size.
+   * \param name kernel name.
+   * \param nr number of rows.
+   * \param nc number of columns.
+   * \param n square matrix size.
+   * \param threads number of threads.
+   * \return Whether all fields are equal.
+   */
+  bool matches(const std::string& name, index_t nr, index_t nc,
+      index_t n, index_t threads) const;
+
+  /**
+   * \return Number of samples.
+   */
+  index_t count() const { return (index_t)samples.size(); }
+
+  /**
+   * \return Fastest sample.
+   */
+  double min() const;
+
+  /**
+   * \return Slowest sample.
+   */
+  double max() const;
+
+  /**
+   * \return Arithmetic mean of the samples.
+   */
+  double mean() const;
+
+  /**
+   * \return Sample standard deviation (0 for fewer than 2 samples).
+   */
+  double stddev() const;
+
+  /**
+   * Nearest-rank percentile.
+   * \param p percentile in [0, 100].
+   * \return The smallest sample such that at least p percent of the samples
+   * are less than or equal to it.
+   */
+  double percentile(double p) const;
+
+  /**
+   * \return Median sample (mean of the middle two for an even count).
+   */
+  double median() const;
+
+  /**
+   * Print this benchmark as one JSON object.
+   * \param out stream to print to.
+   */
+  void printJSON(std::ostream& out) const;
+
+  /**
+   * Print this benchmark as one CSV line.
+   * \param out stream to print to.
+   */
+  void printCSV(std::ostream& out) const;
+
+  /**
+   * Print this benchmark as a human readable line.
+   * \param out stream to print to.
+   */
+  void printText(std::ostream& out) const;
+
+private:
+
+  /**
+   * Kernel name.
+   */
+  std::string name;
+
+  /**
+   * Problem size at the time of the runs; sizes the kernel does not use are
+   * 0 and are not reported.
+   */
+  index_t nr, nc, n;
+
+  /**
+   * Number of threads at the time of the runs.
+   */
+  index_t threads;
+
+  /**
+   * Measured runs, in seconds, in the order they were taken.
+   */
+  std::vector<double> samples;
+
+  /**
+   * Peak bytes allocated during the runs.
+   */
+  size_t peakBytes;
+
+  /**
+   * Sum of each counter over the runs that read it, and number of such runs.
+   */
+  double counterSums[NUM_PERF_COUNTERS];
+  index_t counterRuns[NUM_PERF_COUNTERS];
+
+  /**
+   * Nominal floating point operations of one run.
+   */
+  double flops;
+
+  /**
+   * 1-thread benchmark of the same kernel and size (NULL if none).
+   */
+  const Benchmark* baseline;
+
+};
+
+/**
+ * \brief Collection of benchmarks taken by one Cowichan program.
+ *
+ * Each kernel is run warmups + repeats times; only the last repeats runs are
+ * recorded.
+ */
+class BenchmarkSuite {
+public:
+
+  /**
+   * Construct an empty suite with BENCHMARK_WARMUPS warmup runs and
+   * BENCHMARK_REPEATS recorded runs, reporting text on std::cout.
+   */
+  BenchmarkSuite();
+
+  ~BenchmarkSuite();
+
+  /**
+   * Number of unrecorded runs before the recorded ones.
+   */
+  index_t warmups;
+
+  /**
+   * Number of recorded runs.
+   */
+  index_t repeats;
+
+  /**
+   * Report format.
+   */
+  BenchmarkFormat format;
+
+  /**
+   * File to write the report to (std::cout if empty).
+   */
+  std::string output;
+
+  /**
+   * Read hardware counters around every kernel.
+   */
+  bool counters;
+
+  /**
+   * \return Total number of runs per kernel.
+   */
+  index_t runs() const { return warmups + repeats; }
+
+  /**
+   * Record one run, unless it is a warmup run.
+   * \param name kernel name.
+   * \param nr number of rows.
+   * \param nc number of columns.
+   * \param n square matrix size.
+   * \param threads number of threads.
+   * \param run run number, starting from 0 (warmup runs come first).
+   * \param start tick count before the kernel.
+   * \param end tick count after the kernel.
+   */
+  void record(const char* name, index_t nr, index_t nc, index_t n,
+      index_t threads, index_t run, INT64 start, INT64 end);
+
+  /**
+   * Record the peak memory use of a benchmark.
+   * \param name kernel name.
+   * \param nr number of rows.
+   * \param nc number of columns.
+   * \param n square matrix size.
+   * \param threads number of threads.
+   * \param bytes peak bytes allocated.
+   */
+  void recordPeak(const char* name, index_t nr, index_t nc, index_t n,
+      index_t threads, size_t bytes);
+
+  /**
+   * Record the hardware counters of one run, unless it is a warmup run.
+   * \param name kernel name.
+   * \param nr number of rows.
+   * \param nc number of columns.
+   * \param n square matrix size.
+   * \param threads number of threads.
+   * \param run run number, starting from 0 (warmup runs come first).
+   * \param start counters before the kernel.
+   * \param end counters after the kernel.
+   * \param flops nominal floating point operations of the kernel.
+   */
+  void recordCounters(const char* name, index_t nr, index_t nc, index_t n,
+      index_t threads, index_t run, const PerfSample& start,
+      const PerfSample& end, double flops);
+
+  /**
+   * Print all benchmarks.
+   * \param out stream to print to.
+   * \param format report format.
+   */
+  void report(std::ostream& out, BenchmarkFormat format) const;
+
+  /**
+   * Print all benchmarks in format to output (or std::cout).
+   */
+  void report() const;
+
+private:
+
+  /**
+   * Benchmarks in the order they were first recorded.
+   */
+  std::vector<Benchmark*> benchmarks;
+
+  /**
+   * Find a benchmark, creating it if needed.
+   * \param name kernel name.
+   * \param nr number of rows.
+   * \param nc number of columns.
+   * \param n square matrix size.
+   * \param threads number of threads.
+   * \return The benchmark.
+   */
+  Benchmark* find(const char* name, index_t nr, index_t nc, index_t n,
+      index_t threads);
+
+  // not copyable
+  BenchmarkSuite(const BenchmarkSuite&);
+  BenchmarkSuite& operator=(const BenchmarkSuite&);
+
+};
+
+#endif
+
@@ -0,0 +1,121 @@
+/**
+ * \file bit_matrix.cpp
+ * \brief Implementation of the bit-packed boolean matrix.
+ */
+
+#include "cowichan.hpp"
+
+BitMatrix::BitMatrix(index_t nr, index_t nc): words(NULL), nr(nr), nc(nc),
+    wordsPerRow(bit_row_words(nc))
+{
+  words = NEW_VECTOR_SZ(UINT64, nr * wordsPerRow);
+  memset(words, 0, nr * wordsPerRow * sizeof(UINT64));
+}
+
+BitMatrix::~BitMatrix()
+{
+  DELETE_ARRAY(words);
+}
+
+index_t BitMatrix::count() const
+{
+  index_t sum = 0;
+  for (index_t i = 0; i < nr * wordsPerRow; i++) {
+    sum += popcount64(words[i]);
+  }
+  return sum;
+}
+
+void BitMatrix::pack(const bool* matrix, index_t first, index_t last)
+{
+  for (index_t r = first; r < last; r++) {
+    const bool* cells = matrix + r * nc;
+    UINT64* out = row(r);
+    for (index_t i = 0; i < wordsPerRow; i++) {
+      index_t base = i * BITS_PER_WORD;
+      index_t bits = std::min((index_t)BITS_PER_WORD, nc - base);
+      UINT64 word = 0;
+      for (index_t j = 0; j < bits; j++) {
+        word |= (UINT64)cells[base + j] << j;
+      }
+      out[i] = word;
+    }
+  }
+}
+
+void BitMatrix::unpack(bool* matrix, index_t first, index_t last) const
+{
+  for (index_t r = first; r < last; r++) {
+    bool* cells = matrix + r * nc;
+    const UINT64* in = row(r);
+    for (index_t i = 0; i < wordsPerRow; i++) {
+      index_t base = i * BITS_PER_WORD;
+      index_t bits = std::min((index_t)BITS_PER_WORD, nc - base);
+      UINT64 word = in[i];
+      for (index_t j = 0; j < bits; j++) {
+        cells[base + j] = (word >> j) & 1;
+      }
+    }
+  }
+}
+
+/**
+ * Add one neighbour bit-plane to a bit-sliced counter, 64 cells at a time.
+ * s0 and s1 hold the low bits of the count, s2 is set once it reaches 4.
+ */
+static inline void add_neighbours(UINT64 x, UINT64& s0, UINT64& s1,
+    UINT64& s2)
+{
+  UINT64 c0 = s0 & x;
+  s0 ^= x;
+  UINT64 c1 = s1 & c0;
+  s1 ^= c0;
+  s2 |= c1;
+}
+
+/**
+ * Add the three horizontal neighbours of one row of cells (left, centre if
+ * requested, right) to the counter.
+ */
+static inline void add_row(const UINT64* row, index_t i, index_t words,
+    bool centre, UINT64& s0, UINT64& s1, UINT64& s2)
+{
+  UINT64 w = row[i];
+  UINT64 before = (i > 0) ? row[i - 1] : 0;
+  UINT64 after = (i < words - 1) ? row[i + 1] : 0;
+
+  add_neighbours((w << 1) | (before >> (BITS_PER_WORD - 1)), s0, s1, s2);
+  add_neighbours((w >> 1) | (after << (BITS_PER_WORD - 1)), s0, s1, s2);
+  if (centre) {
+    add_neighbours(w, s0, s1, s2);
+  }
+}
+
+index_t life_row(const UINT64* above, const UINT64* cells,
+    const UINT64* below, UINT64* out, index_t words, UINT64 lastMask)
+{
+  index_t alive = 0;
+
+  for (index_t i = 0; i < words; i++) {
+    UINT64 s0 = 0, s1 = 0, s2 = 0;
+
+    add_row(cells, i, words, false, s0, s1, s2);
+    if (above != NULL) {
+      add_row(above, i, words, true, s0, s1, s2);
+    }
+    if (below != NULL) {
+      add_row(below, i, words, true, s0, s1, s2);
+    }
+
+    // alive with 3 peers, or with 2 peers if already alive
+    UINT64 word = s1 & ~s2 & (s0 | cells[i]);
+    if (i == words - 1) {
+      word &= lastMask;
+    }
+    out[i] = word;
+    alive += popcount64(word);
+  }
+
+  return alive;
+}
+
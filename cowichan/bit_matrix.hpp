@@ -0,0 +1,239 @@
+/**
+ * \file bit_matrix.hpp
+ * \brief Bit-packed boolean matrix.
+ */
+
+#ifndef __bit_matrix_hpp__
+#define __bit_matrix_hpp__
+
+/**
+ * Number of cells in a BitMatrix word.
+ */
+#define BITS_PER_WORD 64
+
+/**
+ * Count the set bits in a word.
+ * \param word the word.
+ * \return Number of set bits.
+ */
+inline index_t popcount64(UINT64 word)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+  return (index_t)__popcnt64(word);
+#elif defined(__GNUC__)
+  return (index_t)__builtin_popcountll(word);
+#else
+  index_t count = 0;
+  for (; word != 0; word &= word - 1) {
+    count++;
+  }
+  return count;
+#endif
+}
+
+/**
+ * Find the lowest set bit of a word.
+ * \param word the word (not 0).
+ * \return Index of the lowest set bit.
+ */
+inline index_t lowest_bit64(UINT64 word)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+  unsigned long index;
+  _BitScanForward64(&index, word);
+  return (index_t)index;
+#elif defined(__GNUC__)
+  return (index_t)__builtin_ctzll(word);
+#else
+  index_t index = 0;
+  for (; (word & 1) == 0; word >>= 1) {
+    index++;
+  }
+  return index;
+#endif
+}
+
+/**
+ * \param nc number of columns.
+ * \return Number of words in a packed row of nc cells.
+ */
+inline index_t bit_row_words(index_t nc)
+{
+  return (nc + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+/**
+ * \param nc number of columns.
+ * \return Mask of the valid bits in the last word of a packed row.
+ */
+inline UINT64 bit_last_mask(index_t nc)
+{
+  index_t used = nc % BITS_PER_WORD;
+  return (used == 0) ? ~(UINT64)0 : (((UINT64)1 << used) - 1);
+}
+
+/**
+ * \brief Boolean matrix stored one bit per cell.
+ *
+ * Each row starts on a 64-bit word; bit j of word i holds column
+ * i * BITS_PER_WORD + j. Bits past the last column are always clear, so
+ * whole words can be counted and combined without masking. A 15000x15000
+ * matrix takes 28 MB instead of the 225 MB of a BoolMatrix.
+ */
+class BitMatrix {
+public:
+
+  /**
+   * Allocate a cleared matrix.
+   * \param nr number of rows.
+   * \param nc number of columns.
+   */
+  BitMatrix(index_t nr, index_t nc);
+
+  ~BitMatrix();
+
+  /**
+   * \return Number of rows.
+   */
+  index_t rows() const { return nr; }
+
+  /**
+   * \return Number of columns.
+   */
+  index_t cols() const { return nc; }
+
+  /**
+   * \return Number of words per row.
+   */
+  index_t rowWords() const { return wordsPerRow; }
+
+  /**
+   * \param r row.
+   * \return First word of row r.
+   */
+  UINT64* row(index_t r) const { return words + r * wordsPerRow; }
+
+  /**
+   * \return Mask of the valid bits in the last word of a row.
+   */
+  UINT64 lastWordMask() const { return bit_last_mask(nc); }
+
+  /**
+   * Read a cell.
+   * \param r row.
+   * \param c column.
+   * \return Cell value.
+   */
+  bool get(index_t r, index_t c) const {
+    return (row(r)[c / BITS_PER_WORD] >> (c % BITS_PER_WORD)) & 1;
+  }
+
+  /**
+   * Write a cell.
+   * \param r row.
+   * \param c column.
+   * \param value cell value.
+   */
+  void set(index_t r, index_t c, bool value) {
+    UINT64 bit = (UINT64)1 << (c % BITS_PER_WORD);
+    UINT64& word = row(r)[c / BITS_PER_WORD];
+    word = value ? (word | bit) : (word & ~bit);
+  }
+
+  /**
+   * \return Number of set cells.
+   */
+  index_t count() const;
+
+  /**
+   * Copy rows [first, last) from a BoolMatrix with the same size.
+   * \param matrix source matrix.
+   * \param first first row.
+   * \param last one past the last row.
+   */
+  void pack(const bool* matrix, index_t first, index_t last);
+
+  /**
+   * Copy rows [first, last) to a BoolMatrix with the same size.
+   * \param matrix destination matrix.
+   * \param first first row.
+   * \param last one past the last row.
+   */
+  void unpack(bool* matrix, index_t first, index_t last) const;
+
+  /**
+   * Copy a whole BoolMatrix with the same size.
+   * \param matrix source matrix.
+   */
+  void pack(const bool* matrix) { pack(matrix, 0, nr); }
+
+  /**
+   * Copy to a whole BoolMatrix with the same size.
+   * \param matrix destination matrix.
+   */
+  void unpack(bool* matrix) const { unpack(matrix, 0, nr); }
+
+  /**
+   * Exchange contents with another matrix of the same size.
+   * \param other the other matrix.
+   */
+  void swap(BitMatrix& other) {
+    UINT64* tmp = words;
+    words = other.words;
+    other.words = tmp;
+  }
+
+private:
+
+  /**
+   * Packed cells.
+   */
+  UINT64* words;
+
+  /**
+   * Matrix size.
+   */
+  index_t nr, nc;
+
+  /**
+   * Words per row.
+   */
+  index_t wordsPerRow;
+
+  // not copyable
+  BitMatrix(const BitMatrix&);
+  BitMatrix& operator=(const BitMatrix&);
+
+};
+
+/**
+ * Compute one packed row of the next game of life generation, 64 cells at a
+ * time. Cells outside the matrix count as dead.
+ * \param above row above in the current generation (NULL for the first row).
+ * \param cells row in the current generation.
+ * \param below row below in the current generation (NULL for the last row).
+ * \param out row in the next generation.
+ * \param words number of words per row.
+ * \param lastMask mask of the valid bits in the last word.
+ * \return Number of alive cells in out.
+ */
+index_t life_row(const UINT64* above, const UINT64* cells,
+    const UINT64* below, UINT64* out, index_t words, UINT64 lastMask);
+
+/**
+ * Compute one row of the next game of life generation, 64 cells at a time.
+ * Cells outside the matrix count as dead.
+ * \param current current generation.
+ * \param next next generation (same size as current).
+ * \param r row.
+ * \return Number of alive cells in row r of next.
+ */
+inline index_t life_row(const BitMatrix& current, BitMatrix& next, index_t r)
+{
+  return life_row((r > 0) ? current.row(r - 1) : NULL, current.row(r),
+      (r < current.rows() - 1) ? current.row(r + 1) : NULL, next.row(r),
+      current.rowWords(), current.lastWordMask());
+}
+
+#endif
+
@@ -0,0 +1,145 @@
+/**
+ * \file chain_dag.cpp
+ * \brief Chain steps 9 to 13 with the gauss and sor branches run
+ * concurrently.
+ * \see Cowichan::chainSolveConcurrent
+ */
+
+#include "cowichan.hpp"
+#include "benchmark.hpp"
+
+/**
+ * \brief Solves with gauss, then multiplies the solution back.
+ *
+ * Times are kept here and recorded by the main thread after both branches
+ * have finished.
+ */
+class Cowichan::GaussBranch: public ChainBranch {
+public:
+
+  GaussBranch(Cowichan* cowichan, Matrix matrix, Matrix work, Vector target,
+      Vector solution): cowichan(cowichan), matrix(matrix), work(work),
+      target(target), solution(solution) { }
+
+  void run() {
+    gaussStart = get_ticks();
+    cowichan->gauss(work, target, solution);
+    productStart = gaussEnd = get_ticks();
+    // target is free once gauss is done
+    cowichan->product(matrix, solution, target);
+    productEnd = get_ticks();
+  }
+
+  INT64 gaussStart, gaussEnd, productStart, productEnd;
+
+private:
+
+  Cowichan* cowichan;
+  Matrix matrix, work;
+  Vector target, solution;
+
+};
+
+/**
+ * \brief Solves with sor, then multiplies the solution back.
+ */
+class Cowichan::SorBranch: public ChainBranch {
+public:
+
+  SorBranch(Cowichan* cowichan, Matrix matrix, Vector target,
+      Vector solution): cowichan(cowichan), matrix(matrix), target(target),
+      solution(solution) { }
+
+  void run() {
+    sorStart = get_ticks();
+    cowichan->sor(matrix, target, solution);
+    productStart = sorEnd = get_ticks();
+    cowichan->product(matrix, solution, target);
+    productEnd = get_ticks();
+  }
+
+  INT64 sorStart, sorEnd, productStart, productEnd;
+
+private:
+
+  Cowichan* cowichan;
+  Matrix matrix;
+  Vector target, solution;
+
+};
+
+void Cowichan::chainSolveConcurrent(Matrix matrix3, Vector vector3)
+{
+  INT64 start, end;
+
+  // STEPS 9 to 12: gauss and product || sor and product
+
+  // initialize: gauss eliminates in place, so it gets its own copies
+  Matrix matrix4 = NULL;
+  Vector vector4 = NULL;
+  Vector vector5 = NULL;
+  Vector vector6 = NULL;
+
+  try {
+    matrix4 = chainNew<real>(CHAIN_MATRIX4, n, n);
+    vector4 = chainNew<real>(CHAIN_VECTOR4, n, 1);
+    vector5 = chainNew<real>(CHAIN_VECTOR5, n, 1);
+    vector6 = chainNew<real>(CHAIN_VECTOR6, n, 1);
+  }
+  catch (...) {out_of_memory();}
+
+  memcpy (matrix4, matrix3, (size_t)n * n * sizeof(real));
+  memcpy (vector6, vector3, n * sizeof(real));
+
+  GaussBranch gaussBranch (this, matrix3, matrix4, vector6, vector4);
+  SorBranch sorBranch (this, matrix3, vector3, vector5);
+
+  // execute: gauss (2/3 n^3) usually takes far longer than sor
+  index_t sorThreads = std::max ((index_t)1,
+      threads * CHAIN_DAG_SOR_SHARE / 100);
+  start = get_ticks ();
+  runBranches (gaussBranch, sorBranch, std::max ((index_t)1,
+      threads - sorThreads));
+  end = get_ticks ();
+
+  // the branches overlap, so hardware counters are not split between steps
+  recordTime (GAUSS, gaussBranch.gaussStart, gaussBranch.gaussEnd);
+  recordTime (SOR, sorBranch.sorStart, sorBranch.sorEnd);
+  recordTime (CHAIN_PRODUCT_GAUSS, gaussBranch.productStart,
+      gaussBranch.productEnd);
+  recordTime (CHAIN_PRODUCT_SOR, sorBranch.productStart,
+      sorBranch.productEnd);
+  recordTime (CHAIN_BRANCHES, start, end);
+
+  print_vector<real> (vector4);
+  checkpoint (GAUSS, vector4, n, 1);
+  print_vector<real> (vector5);
+  checkpoint (SOR, vector5, n, 1);
+  print_vector<real> (vector6);
+  checkpoint (CHAIN_PRODUCT_GAUSS, vector6, n, 1);
+  print_vector<real> (vector3);
+  checkpoint (CHAIN_PRODUCT_SOR, vector3, n, 1);
+
+  // clean up
+  chainDelete(matrix3);
+  chainDelete(matrix4);
+  chainDelete(vector4);
+  chainDelete(vector5);
+
+  // STEP 13: vecdiff
+
+  // execute
+  start = startKernel ();
+  real maxDiff = vecdiff (vector6, vector3);
+  end = get_ticks ();
+  record (VECDIFF, start, end);
+#ifdef OUTPUT_DATA
+  std::cout << maxDiff;
+#endif
+  checkpoint (VECDIFF, &maxDiff, 1, 1);
+
+  // clean up
+  chainDelete(vector3);
+  chainDelete(vector6);
+}
+
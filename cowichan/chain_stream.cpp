@@ -0,0 +1,742 @@
+/**
+ * \file chain_stream.cpp
+ * \brief Out-of-core and lazy chain steps 1 to 5.
+ * \see Cowichan::chainPointsStream
+ * \see Cowichan::chainPointsLazy
+ */
+
+#include "cowichan.hpp"
+
+namespace
+{
+
+/**
+ * \brief Fills a band of the randmat matrix after half.
+ */
+class RandmatHalfTask : public RowTask {
+public:
+
+  /**
+   * \param band the band.
+   * \param offset matrix row of the first band row.
+   * \param nr number of matrix rows.
+   * \param seed random seed.
+   */
+  RandmatHalfTask(const MatrixView<INT_TYPE>& band, index_t offset,
+      index_t nr, INT_TYPE seed): band(band), offset(offset), nr(nr),
+      seed(seed) { }
+
+  index_t run(index_t first, index_t last) {
+    index_t nc = band.cols();
+    index_t middle_r = (nr + 1) / 2;
+    index_t middle_c = (nc + 1) / 2;
+
+    for (index_t r = first; r < last; r++) {
+      // generate the row that half moves here, in order
+      index_t source = half_source(offset + r, middle_r);
+      INT_TYPE* even = band.row(r);
+      randmat_fill(even, middle_c, seed, (UINT64)source * nc, 2);
+      randmat_fill(even + middle_c, nc / 2, seed, (UINT64)source * nc + 1, 2);
+    }
+    return 0;
+  }
+
+private:
+
+  MatrixView<INT_TYPE> band;
+  index_t offset, nr;
+  INT_TYPE seed;
+
+};
+
+/**
+ * \brief Fills a band of the mandel matrix after half.
+ */
+class MandelHalfTask : public RowTask {
+public:
+
+  /**
+   * \param band the band.
+   * \param offset matrix row of the first band row.
+   * \param nr number of matrix rows.
+   * \param x x-coordinates of the columns after half (see mandel_columns).
+   * \param y0 y-coordinate of the lower left corner.
+   * \param dy extent of the region along the y axis.
+   * \param row0 lattice row of matrix row 0 (see Cowichan::mandelRow0).
+   * \param maxIter maximum number of iterations.
+   * \param infinity squared magnitude considered divergent.
+   */
+  MandelHalfTask(const MatrixView<INT_TYPE>& band, index_t offset,
+      index_t nr, const real* x, real y0, real dy, index_t row0,
+      index_t maxIter, real infinity): band(band), offset(offset), nr(nr),
+      x(x), y0(y0), dy(dy / (nr - 1)), row0(row0), maxIter(maxIter),
+      infinity(infinity) { }
+
+  index_t run(index_t first, index_t last) {
+    index_t middle_r = (nr + 1) / 2;
+
+    for (index_t r = first; r < last; r++) {
+      // compute the points that half would move here
+      index_t previous_r = half_source(offset + r, middle_r);
+      mandel_row (band.row(r), x, band.cols(),
+          mandel_coordinate (y0, row0 + previous_r, dy), maxIter, infinity);
+    }
+    return 0;
+  }
+
+private:
+
+  MatrixView<INT_TYPE> band;
+  index_t offset, nr;
+  const real* x;
+  real y0, dy;
+  index_t row0;
+  index_t maxIter;
+  real infinity;
+
+};
+
+/**
+ * \brief Thresholds a band into packed rows.
+ */
+class ThreshTask : public RowTask {
+public:
+
+  /**
+   * \param values band of the matrix.
+   * \param mask the same band of the packed mask.
+   * \param retain cells greater than this value are set.
+   */
+  ThreshTask(const MatrixView<INT_TYPE>& values, UINT64* mask,
+      index_t retain): values(values), mask(mask), retain(retain) { }
+
+  index_t run(index_t first, index_t last) {
+    index_t words = bit_row_words(values.cols());
+    for (index_t r = first; r < last; r++) {
+      thresh_bits(mask + r * words, values.row(r), values.cols(), retain);
+    }
+    return 0;
+  }
+
+private:
+
+  MatrixView<INT_TYPE> values;
+  UINT64* mask;
+  index_t retain;
+
+};
+
+/**
+ * \brief Counts the values of the lazy randmat matrix, with one histogram
+ * per block of rows.
+ */
+class LazyHistogramTask : public RowTask {
+public:
+
+  /**
+   * \param view the matrix.
+   * \param blocks number of blocks of rows.
+   * \param counts a histogram per block.
+   */
+  LazyHistogramTask(const RandmatHalfView& view, index_t blocks,
+      ThreshHistogram* counts): view(view), blocks(blocks),
+      counts(counts) { }
+
+  index_t run(index_t first, index_t last) {
+    index_t nr = view.rows(), nc = view.cols();
+    std::vector<INT_TYPE> row (nc);
+    MatrixView<INT_TYPE> values (&row[0], 1, nc);
+
+    for (index_t b = first; b < last; b++) {
+      for (index_t r = b * nr / blocks; r < (b + 1) * nr / blocks; r++) {
+        view.row(r, &row[0]);
+        counts[b].count(values, 0, 1);
+      }
+    }
+    return 0;
+  }
+
+private:
+
+  const RandmatHalfView& view;
+  index_t blocks;
+  ThreshHistogram* counts;
+
+};
+
+/**
+ * \brief Thresholds rows of the lazy randmat matrix into a packed mask.
+ */
+class LazyThreshTask : public RowTask {
+public:
+
+  /**
+   * \param view the matrix.
+   * \param mask the packed mask.
+   * \param retain cells greater than this value are set.
+   */
+  LazyThreshTask(const RandmatHalfView& view, BitMatrix& mask,
+      index_t retain): view(view), mask(mask), retain(retain) { }
+
+  index_t run(index_t first, index_t last) {
+    std::vector<INT_TYPE> row (view.cols());
+    for (index_t r = first; r < last; r++) {
+      view.row(r, &row[0]);
+      thresh_bits(mask.row(r), &row[0], view.cols(), retain);
+    }
+    return 0;
+  }
+
+private:
+
+  const RandmatHalfView& view;
+  BitMatrix& mask;
+  index_t retain;
+
+};
+
+/**
+ * \brief Computes the next life generation of a band of packed rows.
+ */
+class LifeTask : public RowTask {
+public:
+
+  /**
+   * \param in current generation, the band plus the rows next to it.
+   * \param inRows number of rows in in.
+   * \param shift row of in holding the first band row (0 or 1).
+   * \param out next generation of the band.
+   * \param nc number of columns.
+   */
+  LifeTask(const UINT64* in, index_t inRows, index_t shift, UINT64* out,
+      index_t nc): in(in), inRows(inRows), shift(shift), out(out),
+      words(bit_row_words(nc)), lastMask(bit_last_mask(nc)) { }
+
+  index_t run(index_t first, index_t last) {
+    index_t alive = 0;
+    for (index_t r = first; r < last; r++) {
+      index_t row = r + shift;
+      alive += life_row((row > 0) ? in + (row - 1) * words : NULL,
+          in + row * words,
+          (row < inRows - 1) ? in + (row + 1) * words : NULL,
+          out + r * words, words, lastMask);
+    }
+    return alive;
+  }
+
+private:
+
+  const UINT64* in;
+  index_t inRows, shift;
+  UINT64* out;
+  index_t words;
+  UINT64 lastMask;
+
+};
+
+/**
+ * \brief Selects the points of winnow without storing the candidates: the
+ * first pass counts the candidates of each weight, the second picks the
+ * selected ones. Both passes visit the candidates in row-major order, which
+ * breaks ties between equal weights as the WeightedPoint order does.
+ */
+class WinnowPicker {
+public:
+
+  /**
+   * \param vMax largest weight.
+   * \param n number of points to select.
+   */
+  WinnowPicker(INT_TYPE vMax, index_t n): counts(vMax + 1, 0), len(0),
+      n(n) { }
+
+  /**
+   * First pass: count a candidate.
+   * \param weight its weight.
+   */
+  void count(INT_TYPE weight) {
+    counts[weight]++;
+    len++;
+  }
+
+  /**
+   * Between the passes: find the weight of every selected point and its
+   * index among the candidates of that weight.
+   */
+  void plan() {
+    index_t i, w;
+    index_t vMax = (index_t)counts.size() - 1;
+
+    if (len < n) {
+      not_enough_points();
+    }
+
+    // point i is candidate len - 1 - (n - 1 - i) * stride in order of weight
+    std::vector<index_t> before (vMax + 2, 0);
+    for (w = 0; w <= vMax; w++) {
+      before[w + 1] = before[w] + counts[w];
+    }
+
+    index_t stride = len / n;
+    selected.resize (n);
+    for (i = 0; i < n; i++) {
+      index_t rank = len - 1 - (n - 1 - i) * stride;
+      Selection& s = selected[i];
+      s.weight = (INT_TYPE)(std::upper_bound (before.begin(), before.end(),
+          rank) - before.begin() - 1);
+      s.index = rank - before[s.weight];
+      s.point = i;
+    }
+    std::sort (selected.begin(), selected.end());
+
+    // next selection of each weight
+    cursor.assign (vMax + 1, n);
+    for (i = n - 1; i >= 0; i--) {
+      cursor[selected[i].weight] = i;
+    }
+    std::fill (counts.begin(), counts.end(), 0);
+  }
+
+  /**
+   * Second pass: pick a candidate if it is selected.
+   * \param weight its weight.
+   * \param r its row.
+   * \param c its column.
+   * \param points where the selected points go.
+   */
+  void pick(INT_TYPE weight, index_t r, index_t c, PointVector points) {
+    index_t k = cursor[weight];
+    if ((k < n) && (selected[k].weight == weight)
+        && (selected[k].index == counts[weight])) {
+      points[selected[k].point] = Point((real)c, (real)r);
+      cursor[weight]++;
+    }
+    counts[weight]++;
+  }
+
+private:
+
+  /**
+   * \brief A selected point: the index-th cell of weight weight in
+   * row-major order becomes point number point.
+   */
+  struct Selection {
+    INT_TYPE weight;
+    index_t index;
+    index_t point;
+
+    bool operator<(const Selection& rhs) const {
+      return (weight < rhs.weight)
+          || ((weight == rhs.weight) && (index < rhs.index));
+    }
+  };
+
+  std::vector<index_t> counts;
+  index_t len, n;
+  std::vector<Selection> selected;
+  std::vector<index_t> cursor;
+
+};
+
+/**
+ * Copy a scratch file to a matrix file, band by band.
+ * \param saved the matrix file (deleted), or NULL to do nothing.
+ * \param file the scratch file.
+ * \param nr number of rows.
+ * \param band number of rows per band.
+ * \param rowBytes bytes per row in file.
+ * \param packed whether file holds packed rows (see BitMatrix).
+ */
+void save_bands(MatrixFileWriter* saved, ScratchFile& file, index_t nr,
+    index_t band, size_t rowBytes, bool packed)
+{
+  for (index_t first = 0; (saved != NULL) && (first < nr); first += band) {
+    index_t rows = std::min (band, nr - first);
+    ScratchWindow window (file, first * rowBytes, rows * rowBytes);
+    if (packed) {
+      saved->writeBits ((const UINT64*) window.data(), rows);
+    }
+    else {
+      saved->write (window.data(), rows);
+    }
+  }
+  delete saved;
+}
+
+/**
+ * Write the lazy randmat matrix to a matrix file, row by row.
+ * \param saved the matrix file (deleted), or NULL to do nothing.
+ * \param view the matrix.
+ */
+void save_rows(MatrixFileWriter* saved, const RandmatHalfView& view)
+{
+  if (saved != NULL) {
+    std::vector<INT_TYPE> row (view.cols());
+    for (index_t r = 0; r < view.rows(); r++) {
+      view.row(r, &row[0]);
+      saved->write (&row[0], 1);
+    }
+  }
+  delete saved;
+}
+
+#ifdef OUTPUT_DATA
+void print_rows(const MatrixView<INT_TYPE>& values)
+{
+  for (index_t r = 0; r < values.rows(); r++) {
+    for (index_t c = 0; c < values.cols(); c++) {
+      std::cout << values(r, c) << "\t";
+    }
+    std::cout << std::endl;
+  }
+}
+
+void print_rows(const UINT64* bits, index_t rows, index_t nc)
+{
+  index_t words = bit_row_words(nc);
+  for (index_t r = 0; r < rows; r++) {
+    for (index_t c = 0; c < nc; c++) {
+      bool set = (bits[r * words + c / BITS_PER_WORD] >> (c % BITS_PER_WORD))
+          & 1;
+      std::cout << (set ? "x" : " ");
+    }
+    std::cout << std::endl;
+  }
+}
+
+void print_rows(const RandmatHalfView& view)
+{
+  std::vector<INT_TYPE> row (view.cols());
+  for (index_t r = 0; r < view.rows(); r++) {
+    view.row(r, &row[0]);
+    print_rows (MatrixView<INT_TYPE>(&row[0], 1, view.cols()));
+  }
+}
+
+void print_end()
+{
+  std::cout << std::endl;
+}
+#else
+void print_rows(const MatrixView<INT_TYPE>& /* values */) { }
+void print_rows(const RandmatHalfView& /* view */) { }
+void print_rows(const UINT64* /* bits */, index_t /* rows */,
+    index_t /* nc */) { }
+void print_end() { }
+#endif
+
+}
+
+/*****************************************************************************/
+
+void Cowichan::chainPointsStream(bool use_randmat, bool use_thresh,
+    PointVector points)
+{
+  INT64 start, end;
+  index_t first, rows, r, c, w, i;
+
+  if (!use_thresh) {
+    bad_argument ("The streaming chain cannot run", INVPERC);
+  }
+
+  index_t words = bit_row_words (nc);
+  size_t intRow = nc * sizeof(INT_TYPE);
+  size_t bitRow = words * sizeof(UINT64);
+
+  // rows per band, so that a band of the matrix and of two masks fit
+  index_t band = (index_t) (streamBudget / (intRow + 2 * bitRow));
+  band = std::max ((index_t)1, std::min (band, nr));
+
+  ScratchFile* matrix = NULL;
+  ScratchFile* current = NULL;
+  ScratchFile* next = NULL;
+
+  try {
+    matrix = new ScratchFile(scratchDir, nr * intRow);
+    current = new ScratchFile(scratchDir, nr * bitRow);
+    next = new ScratchFile(scratchDir, nr * bitRow);
+  }
+  catch (...) {out_of_memory();}
+
+  // STEPS 1 and 2: mandel or randmat in half order, counting values as we go
+
+  ThreshHistogram counts;
+  real* columns = NULL;
+
+  if (!use_randmat) {
+    try {
+      columns = NEW_VECTOR_SZ(real, nc);
+    }
+    catch (...) {out_of_memory();}
+    mandel_columns (columns, nc, mandelX0, mandelDx / (nc - 1), mandelCol0,
+        true);
+  }
+
+  start = startKernel ();
+  for (first = 0; first < nr; first += band) {
+    rows = std::min (band, nr - first);
+    ScratchWindow window (*matrix, first * intRow, rows * intRow);
+    MatrixView<INT_TYPE> values ((INT_TYPE*) window.data(), rows, nc);
+
+    if (use_randmat) {
+      RandmatHalfTask task (values, first, nr, seed);
+      parallelRows (rows, task);
+    }
+    else {
+      MandelHalfTask task (values, first, nr, columns, mandelY0, mandelDy,
+          mandelRow0, mandelMaxIter, mandelInfinity);
+      parallelRows (rows, task);
+    }
+
+    counts.count (values, 0, rows);
+    print_rows (values);
+  }
+  end = get_ticks ();
+  record (use_randmat ? RANDMAT_HALF : MANDEL_HALF, start, end);
+  print_end ();
+  if (columns != NULL) {
+    DELETE_ARRAY(columns);
+  }
+
+  save_bands (openCheckpoint (use_randmat ? RANDMAT_HALF : MANDEL_HALF,
+      MATRIX_FILE_INT, sizeof(INT_TYPE), nr, nc), *matrix, nr, band, intRow,
+      false);
+
+  // STEP 3: thresh
+
+  start = startKernel ();
+  std::vector<index_t> hist (counts.bins(), 0);
+  INT_TYPE vMax = 0;
+  counts.add (&hist[0], 0, counts.bins());
+  for (i = 0; i < counts.bins(); i++) {
+    if (hist[i] > 0) {
+      vMax = (INT_TYPE)i;
+    }
+  }
+  index_t retain = thresh_level (&hist[0], counts.bins(),
+      (index_t)(threshPercent * nc * nr));
+
+  for (first = 0; first < nr; first += band) {
+    rows = std::min (band, nr - first);
+    ScratchWindow window (*matrix, first * intRow, rows * intRow);
+    ScratchWindow mask (*current, first * bitRow, rows * bitRow);
+
+    ThreshTask task (MatrixView<INT_TYPE>((INT_TYPE*) window.data(), rows,
+        nc), (UINT64*) mask.data(), retain);
+    parallelRows (rows, task);
+    print_rows ((UINT64*) mask.data(), rows, nc);
+  }
+  end = get_ticks ();
+  record (THRESH, start, end);
+  print_end ();
+  save_bands (openCheckpoint (THRESH, MATRIX_FILE_BOOL, sizeof(bool), nr,
+      nc), *current, nr, band, bitRow, true);
+
+  // STEP 4: life, with one row of overlap on each side of a band
+
+  start = startKernel ();
+  for (i = 0; i < lifeIterations; i++) {
+    index_t alive = 0;
+
+    for (first = 0; first < nr; first += band) {
+      rows = std::min (band, nr - first);
+      index_t low = std::max ((index_t)0, first - 1);
+      index_t high = std::min (nr, first + rows + 1);
+      ScratchWindow in (*current, low * bitRow, (high - low) * bitRow);
+      ScratchWindow out (*next, first * bitRow, rows * bitRow);
+
+      LifeTask task ((UINT64*) in.data(), high - low, first - low,
+          (UINT64*) out.data(), nc);
+      alive += parallelRows (rows, task);
+    }
+
+    if (alive == 0) {
+      no_cells_alive();
+    }
+
+    // swap files (ping-pong approach)
+    std::swap (current, next);
+  }
+  end = get_ticks ();
+  record (LIFE, start, end);
+
+  for (first = 0; first < nr; first += band) {
+    rows = std::min (band, nr - first);
+    ScratchWindow mask (*current, first * bitRow, rows * bitRow);
+    print_rows ((UINT64*) mask.data(), rows, nc);
+  }
+  print_end ();
+  save_bands (openCheckpoint (LIFE, MATRIX_FILE_BOOL, sizeof(bool), nr, nc),
+      *current, nr, band, bitRow, true);
+
+  // STEP 5: winnow
+
+  start = startKernel ();
+
+  // count the candidates of each weight
+  WinnowPicker picker (vMax, n);
+  for (first = 0; first < nr; first += band) {
+    rows = std::min (band, nr - first);
+    ScratchWindow window (*matrix, first * intRow, rows * intRow);
+    ScratchWindow mask (*current, first * bitRow, rows * bitRow);
+    MatrixView<INT_TYPE> values ((INT_TYPE*) window.data(), rows, nc);
+    const UINT64* bits = (const UINT64*) mask.data();
+
+    for (r = 0; r < rows; r++) {
+      for (w = 0; w < words; w++) {
+        for (UINT64 word = bits[r * words + w]; word != 0; word &= word - 1) {
+          picker.count (values(r, w * BITS_PER_WORD + lowest_bit64(word)));
+        }
+      }
+    }
+  }
+  picker.plan ();
+
+  // pick the selected candidates
+  for (first = 0; first < nr; first += band) {
+    rows = std::min (band, nr - first);
+    ScratchWindow window (*matrix, first * intRow, rows * intRow);
+    ScratchWindow mask (*current, first * bitRow, rows * bitRow);
+    MatrixView<INT_TYPE> values ((INT_TYPE*) window.data(), rows, nc);
+    const UINT64* bits = (const UINT64*) mask.data();
+
+    for (r = 0; r < rows; r++) {
+      for (w = 0; w < words; w++) {
+        for (UINT64 word = bits[r * words + w]; word != 0; word &= word - 1) {
+          c = w * BITS_PER_WORD + lowest_bit64(word);
+          picker.pick (values(r, c), first + r, c, points);
+        }
+      }
+    }
+  }
+  end = get_ticks ();
+  record (WINNOW, start, end);
+  print_vector(points);
+  checkpoint (WINNOW, points, n, 1);
+
+  // clean up
+  delete matrix;
+  delete current;
+  delete next;
+}
+
+
+void Cowichan::chainPointsLazy(bool use_randmat, bool use_thresh,
+    PointVector points)
+{
+  INT64 start, end;
+  index_t r, c, w, i, b;
+
+  if (!use_randmat) {
+    bad_argument ("The lazy chain cannot run", MANDEL);
+  }
+  if (!use_thresh) {
+    bad_argument ("The lazy chain cannot run", INVPERC);
+  }
+
+  // STEPS 1 and 2: randmat in half order, as a view
+
+  RandmatHalfView* view = NULL;
+
+  start = startKernel ();
+  try {
+    view = new RandmatHalfView(nr, nc, seed);
+  }
+  catch (...) {out_of_memory();}
+  end = get_ticks ();
+  record (RANDMAT_HALF, start, end);
+  print_rows (*view);
+  print_end ();
+  save_rows (openCheckpoint (RANDMAT_HALF, MATRIX_FILE_INT, sizeof(INT_TYPE),
+      nr, nc), *view);
+
+  // STEP 3: thresh, generating the matrix once for the histogram and once
+  // for the mask
+
+  BitMatrix* mask = NULL;
+
+  try {
+    mask = new BitMatrix(nr, nc);
+  }
+  catch (...) {out_of_memory();}
+
+  start = startKernel ();
+  index_t blocks = std::max ((index_t)1, std::min (threads, nr));
+  ThreshHistogram* counts = NULL;
+  try {
+    counts = new ThreshHistogram[blocks];
+  }
+  catch (...) {out_of_memory();}
+  LazyHistogramTask histogram (*view, blocks, counts);
+  parallelRows (blocks, histogram);
+
+  index_t bins = 0;
+  for (b = 0; b < blocks; b++) {
+    bins = std::max (bins, counts[b].bins());
+  }
+  std::vector<index_t> hist (bins, 0);
+  INT_TYPE vMax = 0;
+  for (b = 0; b < blocks; b++) {
+    counts[b].add (&hist[0], 0, bins);
+  }
+  delete[] counts;
+  for (i = 0; i < bins; i++) {
+    if (hist[i] > 0) {
+      vMax = (INT_TYPE)i;
+    }
+  }
+
+  index_t retain = thresh_level (&hist[0], bins,
+      (index_t)(threshPercent * nc * nr));
+
+  LazyThreshTask task (*view, *mask, retain);
+  parallelRows (nr, task);
+  end = get_ticks ();
+  record (THRESH, start, end);
+  print_bool_rect_matrix (*mask);
+  checkpoint (THRESH, *mask);
+
+  // STEP 4: life
+
+  start = startKernel ();
+  lifeBits (*mask);
+  end = get_ticks ();
+  record (LIFE, start, end);
+  print_bool_rect_matrix (*mask);
+  checkpoint (LIFE, *mask);
+
+  // STEP 5: winnow, looking up the value of every set cell
+
+  start = startKernel ();
+
+  // count the candidates of each weight
+  WinnowPicker picker (vMax, n);
+  for (r = 0; r < nr; r++) {
+    const UINT64* RESTRICT bits = mask->row(r);
+    for (w = 0; w < mask->rowWords(); w++) {
+      for (UINT64 word = bits[w]; word != 0; word &= word - 1) {
+        picker.count ((*view)(r, w * BITS_PER_WORD + lowest_bit64(word)));
+      }
+    }
+  }
+  picker.plan ();
+
+  // pick the selected candidates
+  for (r = 0; r < nr; r++) {
+    const UINT64* RESTRICT bits = mask->row(r);
+    for (w = 0; w < mask->rowWords(); w++) {
+      for (UINT64 word = bits[w]; word != 0; word &= word - 1) {
+        c = w * BITS_PER_WORD + lowest_bit64(word);
+        picker.pick ((*view)(r, c), r, c, points);
+      }
+    }
+  }
+  end = get_ticks ();
+  record (WINNOW, start, end);
+  print_vector(points);
+  checkpoint (WINNOW, points, n, 1);
+
+  // clean up
+  delete view;
+  delete mask;
+}
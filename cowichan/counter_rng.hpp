@@ -0,0 +1,82 @@
+/**
+ * \file counter_rng.hpp
+ * \brief Counter-based pseudorandom numbers for problem inputs.
+ */
+
+#ifndef __counter_rng_hpp__
+#define __counter_rng_hpp__
+
+/**
+ * Increment of the SplitMix64 sequence (2^64 / golden ratio).
+ */
+#define COUNTER_RNG_GAMMA 0x9E3779B97F4A7C15ULL
+
+/**
+ * SplitMix64 output function: a bijective mix of all 64 bits.
+ * \param x the state.
+ * \return The mixed state.
+ */
+inline UINT64 counter_rng_mix(UINT64 x)
+{
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+/**
+ * Key of one independent sequence of numbers.
+ * \param seed random seed.
+ * \param stream which input of the problem the sequence fills.
+ * \return The key, to be passed to counter_rng.
+ */
+inline UINT64 counter_rng_key(UINT64 seed, UINT64 stream)
+{
+  return counter_rng_mix(counter_rng_mix(seed) + stream * COUNTER_RNG_GAMMA);
+}
+
+/**
+ * Element i of a sequence: the (i + 1)th output of SplitMix64 started at the
+ * key. Every element is computed on its own, so an input can be filled in
+ * any order and by any number of threads with the same result.
+ * \param key key of the sequence (see counter_rng_key).
+ * \param i element number.
+ * \return 64 random bits.
+ */
+inline UINT64 counter_rng(UINT64 key, UINT64 i)
+{
+  return counter_rng_mix(key + (i + 1) * COUNTER_RNG_GAMMA);
+}
+
+/**
+ * \param bits output of counter_rng.
+ * \param m limit (at most 2^32).
+ * \return Integer in [0, m), from the high bits by multiply and shift.
+ */
+inline INT_TYPE counter_rng_int(UINT64 bits, UINT64 m)
+{
+  return (INT_TYPE)(((bits >> 32) * m) >> 32);
+}
+
+/**
+ * \param bits output of counter_rng.
+ * \return true or false with equal probability.
+ */
+inline bool counter_rng_bool(UINT64 bits)
+{
+  return (bits >> 63) != 0;
+}
+
+/**
+ * \param bits output of counter_rng.
+ * \param mean mean.
+ * \param range range.
+ * \return Number ~ U[mean - range, mean + range).
+ */
+inline real counter_rng_uniform(UINT64 bits, real mean, real range)
+{
+  double unit = (double)(bits >> 11) * (1.0 / 9007199254740992.0); // 2^-53
+  return (real)(unit * (2.0 * range) - range + mean);
+}
+
+#endif
+
@@ -5,12 +5,10 @@
  */
 
 #include "cowichan.hpp"
-
-real uniform(real mean, real range) {
-  return (rand() / (real)RAND_MAX) * (2.0f * range) - range + mean;
-}
-
-/*****************************************************************************/
+#include "benchmark.hpp"
+#include <fstream>
+#include <utility>
+#include <sstream>
 
 void out_of_memory() {
   std::cout << "--- Out of memory! ---";
@@ -27,6 +25,11 @@ void no_cells_alive() {
   exit(1);
 }
 
+void bad_argument(const char* message, const char* arg) {
+  std::cout << "--- " << message << ": " << arg << " ---";
+  exit(1);
+}
+
 #ifdef OUTPUT_DATA
 void Cowichan::print_vector(PointVector points)
 {
@@ -61,8 +64,22 @@ void Cowichan::print_vector(PointVector /* points */) { }
     }
     std::cout << std::endl;
   }
+
+  void Cowichan::print_bool_rect_matrix(const BitMatrix& matrix)
+  {
+    index_t r, c;
+
+    for (r = 0; r < nr; r++) {
+      for (c = 0; c < nc; c++) {
+        std::cout << (matrix.get(r, c) ? "x" : " ");
+      }
+      std::cout << std::endl;
+    }
+    std::cout << std::endl;
+  }
 #else
   void Cowichan::print_bool_rect_matrix(BoolMatrix /* matrix */) { }
+  void Cowichan::print_bool_rect_matrix(const BitMatrix& /* matrix */) { }
 #endif
 
 /*****************************************************************************/
@@ -75,8 +92,9 @@ INT64 get_ticks ()
     count = GetTickCount (); // ms
   }
 #else                // Linux
-  tms tm;
-  count = times (&tm);
+  timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  count = (INT64) ts.tv_sec * 1000000000 + (INT64) ts.tv_nsec; // ns
 #endif               // end of Windows/Linux definitions
   return count;
 }
@@ -89,7 +107,7 @@ INT64 get_freq ()
     freq = 1000; // ms
   }
 #else                // Linux
-  freq = sysconf (_SC_CLK_TCK);
+  freq = 1000000000; // ns
 #endif               // end of Windows/Linux definitions
   return freq;
 }
@@ -102,16 +120,6 @@ void print_elapsed_time (INT64 start, INT64 end)
   std::cout.flush();
 }
 
-void timeInfo(INT64 *start, INT64 *end, std::string message) {
-  *start = *end;
-  *end = get_ticks();
-  #ifdef TEST_TIME
-    std::cout << message << ": ";
-    print_elapsed_time(*start, *end);
-    std::cout << std::endl;
-  #endif
-}
-
 /*****************************************************************************/
 
 const char* Cowichan::CHAIN = "chain";
@@ -129,554 +137,1273 @@ const char* Cowichan::GAUSS = "gauss";
 const char* Cowichan::SOR = "sor";
 const char* Cowichan::PRODUCT = "product";
 const char* Cowichan::VECDIFF = "vecdiff";
+const char* Cowichan::RANDMAT_HALF = "randmat+half";
+const char* Cowichan::MANDEL_HALF = "mandel+half";
+const char* Cowichan::CHAIN_BRANCHES = "gauss||sor";
+const char* Cowichan::CHAIN_PRODUCT_GAUSS = "product(gauss)";
+const char* Cowichan::CHAIN_PRODUCT_SOR = "product(sor)";
+
+Cowichan::Cowichan(): benchmarks(NULL), counters(NULL), benchmarkRun(0), useRandmat(false),
+    useThresh(true), chainArena(CHAIN_ARENA), chainFusion(CHAIN_FUSION),
+    chainDag(CHAIN_DAG), chainStream(false), chainLazy(false), streamBudget(STREAM_BUDGET), scratchDir(SCRATCH_DIR),
+    checkpointCount(0), chainPlan(NULL), chainMemory(NULL), mandelCache(NULL)
+{
+  setDefaults (CHAIN);
+}
+
+Cowichan::~Cowichan()
+{
+  delete benchmarks;
+  delete counters;
+  delete mandelCache;
+}
+
+index_t Cowichan::setNumThreads(index_t /* threads */)
+{
+  return 1;
+}
+
+void Cowichan::pinThreads()
+{
+  affinity_pin (0);
+}
+
+void Cowichan::firstTouch(void* /* array */, index_t /* rows */,
+    size_t /* rowBytes */) { }
+
+index_t Cowichan::parallelRows(index_t rows, RowTask& task)
+{
+  return task.run (0, rows);
+}
+
+void Cowichan::runBranches(ChainBranch& first, ChainBranch& second,
+    index_t /* firstThreads */)
+{
+  first.run ();
+  second.run ();
+}
+
+void Cowichan::randmatHalf(IntMatrix matrix)
+{
+  IntMatrix unshuffled = NULL;
+  try {
+    unshuffled = NEW_MATRIX_RECT(INT_TYPE);
+  }
+  catch (...) {out_of_memory();}
+
+  randmat (unshuffled);
+  half (unshuffled, matrix);
+
+  DELETE_ARRAY(unshuffled);
+}
+
+void Cowichan::mandelHalf(IntMatrix matrix)
+{
+  IntMatrix unshuffled = NULL;
+  try {
+    unshuffled = NEW_MATRIX_RECT(INT_TYPE);
+  }
+  catch (...) {out_of_memory();}
+
+  computeMandel (unshuffled);
+  half (unshuffled, matrix);
+
+  DELETE_ARRAY(unshuffled);
+}
+
+void Cowichan::threshBits(IntMatrix matrix, BitMatrix& mask)
+{
+  BoolMatrix unpacked = NULL;
+  try {
+    unpacked = NEW_MATRIX_RECT(bool);
+  }
+  catch (...) {out_of_memory();}
+
+  thresh (matrix, unpacked);
+  mask.pack (unpacked);
+
+  DELETE_ARRAY(unpacked);
+}
+
+void Cowichan::lifeBits(BitMatrix& world)
+{
+  BoolMatrix first = NULL;
+  BoolMatrix second = NULL;
+  try {
+    first = NEW_MATRIX_RECT(bool);
+    second = NEW_MATRIX_RECT(bool);
+  }
+  catch (...) {out_of_memory();}
+
+  world.unpack (first);
+  life (first, second);
+  world.pack (second);
+
+  DELETE_ARRAY(first);
+  DELETE_ARRAY(second);
+}
+
+void Cowichan::winnowBits(IntMatrix matrix, const BitMatrix& mask,
+    PointVector points)
+{
+  BoolMatrix unpacked = NULL;
+  try {
+    unpacked = NEW_MATRIX_RECT(bool);
+  }
+  catch (...) {out_of_memory();}
+
+  mask.unpack (unpacked);
+  winnow (matrix, unpacked, points);
+
+  DELETE_ARRAY(unpacked);
+}
+
+/**
+ * Get the value of the command line option at argv[i] and advance i past it.
+ * \param argc number of command line arguments.
+ * \param argv command line arguments.
+ * \param i index of the option name.
+ * \return The option value.
+ */
+static const char* option_value(int argc, char* argv[], int& i)
+{
+  if (i + 1 >= argc) {
+    bad_argument("Missing value for option", argv[i]);
+  }
+  return argv[++i];
+}
+
+/**
+ * Parse a positive (or, if allowed, zero) count.
+ * \param arg string to parse.
+ * \param allowZero whether zero is accepted.
+ * \return The count.
+ */
+static index_t parse_count(const std::string& arg, bool allowZero)
+{
+  char* end;
+  long long value = strtoll(arg.c_str(), &end, 10);
+  if (arg.empty() || (*end != '\0') || (value < (allowZero ? 0 : 1))) {
+    bad_argument("Invalid count", arg.c_str());
+  }
+  return (index_t)value;
+}
+
+/**
+ * Parse a whole number, which may be negative.
+ * \param arg string to parse.
+ * \return The number.
+ */
+static index_t parse_integer(const std::string& arg)
+{
+  char* end;
+  long long value = strtoll(arg.c_str(), &end, 10);
+  if (arg.empty() || (*end != '\0')) {
+    bad_argument("Invalid integer", arg.c_str());
+  }
+  return (index_t)value;
+}
+
+/**
+ * Parse a real number.
+ * \param arg string to parse.
+ * \return The number.
+ */
+static double parse_real(const std::string& arg)
+{
+  char* end;
+  double value = strtod(arg.c_str(), &end);
+  if (arg.empty() || (*end != '\0')) {
+    bad_argument("Invalid number", arg.c_str());
+  }
+  return value;
+}
+
+/**
+ * Parse a comma-separated list of positive counts.
+ * \param arg string to parse.
+ * \return The counts.
+ */
+static std::vector<index_t> parse_list(const std::string& arg)
+{
+  std::vector<index_t> list;
+  std::string::size_type start = 0, comma;
+
+  do {
+    comma = arg.find(',', start);
+    list.push_back(parse_count(arg.substr(start, comma - start), false));
+    start = comma + 1;
+  } while (comma != std::string::npos);
+
+  return list;
+}
+
+/**
+ * Remove leading and trailing white space.
+ * \param str string to trim.
+ * \return The trimmed string.
+ */
+static std::string trim(const std::string& str)
+{
+  const char* space = " \t\r\n";
+  std::string::size_type first = str.find_first_not_of(space);
+  if (first == std::string::npos) {
+    return "";
+  }
+  return str.substr(first, str.find_last_not_of(space) - first + 1);
+}
 
 void Cowichan::main (int argc, char* argv[], bool use_randmat, bool use_thresh)
 {
-  if ((argc == 1) || (strcmp (argv[1], CHAIN) == 0)) {
-    chain (use_randmat, use_thresh);
+  const char* problem = CHAIN;
+  std::vector<std::pair<std::string, std::string> > settings;
+  int i = 1;
+
+  if ((argc > 1) && (strncmp (argv[1], "--", 2) != 0)) {
+    problem = argv[1];
+    i = 2;
   }
-  else {
-    INT64 start, end;
-
-    if (strcmp (argv[1], MANDEL) == 0) {
-      // set up
-      nr = MANDEL_NR;
-      nc = MANDEL_NC;
-      mandelX0 = MANDEL_X0;
-      mandelY0 = MANDEL_Y0;
-      mandelDx = MANDEL_DX;
-      mandelDy = MANDEL_DY;
-
-      // initialize
-      IntMatrix matrix = NULL;
-
-      try {
-        matrix = NEW_MATRIX_RECT(INT_TYPE);
+
+  // collect settings in order, expanding configuration files in place
+  for (; i < argc; i++) {
+    if (strcmp (argv[i], "--help") == 0) {
+      usage (argv[0]);
+    }
+    if (strncmp (argv[i], "--", 2) != 0) {
+      bad_argument ("Unknown option", argv[i]);
+    }
+    const char* name = argv[i] + 2;
+    const char* value = option_value (argc, argv, i);
+    if (strcmp (name, "config") == 0) {
+      readConfig (value, settings);
+    }
+    else {
+      settings.push_back (std::make_pair (std::string (name),
+          std::string (value)));
+    }
+  }
+
+  try {
+    benchmarks = new BenchmarkSuite();
+  }
+  catch (...) {out_of_memory();}
+
+  std::vector<std::pair<std::string, std::string> >::const_iterator it;
+  std::vector<index_t> sizes, threadCounts;
+  std::vector<index_t>::const_iterator size, threadCount;
+
+  // apply once to validate the settings and pick up the sweep grid
+  setDefaults (problem);
+  for (it = settings.begin(); it != settings.end(); ++it) {
+    if (!setOption (it->first, it->second)) {
+      bad_argument ("Unknown option", it->first.c_str());
+    }
+  }
+  sizes = sweepSizes;
+  threadCounts = sweepThreads;
+
+  // before any worker thread exists, so that they inherit the counters
+  if (benchmarks->counters) {
+    try {
+      counters = new PerfCounters();
+    }
+    catch (...) {out_of_memory();}
+
+    if (!counters->any()) {
+      std::cerr << "--- Hardware counters not available ---" << std::endl;
+      delete counters;
+      counters = NULL;
+    }
+  }
+  if (sizes.empty()) {
+    sizes.push_back (0);
+  }
+  if (threadCounts.empty()) {
+    threadCounts.push_back (0);
+  }
+
+  for (threadCount = threadCounts.begin(); threadCount != threadCounts.end();
+      ++threadCount) {
+    for (size = sizes.begin(); size != sizes.end(); ++size) {
+      // defaults, then settings, then the grid point
+      setDefaults (problem);
+      useRandmat = use_randmat;
+      useThresh = use_thresh;
+      for (it = settings.begin(); it != settings.end(); ++it) {
+        setOption (it->first, it->second);
       }
-      catch (...) {out_of_memory();}
+      if (*size != 0) {
+        nr = nc = n = *size;
+      }
+      if (*threadCount != 0) {
+        threads = *threadCount;
+      }
+      threads = setNumThreads (threads);
+      pinThreads ();
 
-      // execute
+      run (problem);
+    }
+  }
+
+#ifdef TEST_TIME
+  benchmarks->report ();
+#else
+  if (!benchmarks->output.empty()) {
+    benchmarks->report ();
+  }
+#endif
+}
+
+void Cowichan::setDefaults(const char* problem)
+{
+  nr = ALL_NR;
+  nc = ALL_NC;
+  n = ALL_N;
+  lifeIterations = LIFE_ITERATIONS;
+  mandelX0 = MANDEL_X0;
+  mandelY0 = MANDEL_Y0;
+  mandelDx = MANDEL_DX;
+  mandelDy = MANDEL_DY;
+  mandelMaxIter = MANDEL_MAX_ITER;
+  mandelInfinity = MANDEL_INFINITY;
+  mandelSubdivide = MANDEL_SUBDIVIDE;
+  mandelTileRows = MANDEL_TILE_ROWS;
+  mandelTileCols = MANDEL_TILE_COLS;
+  mandelCacheBytes = MANDEL_CACHE;
+  mandelPanRows = 0;
+  mandelPanCols = 0;
+  mandelRow0 = 0;
+  mandelCol0 = 0;
+  threshPercent = THRESH_PERCENT;
+  invpercNFill = INVPERC_NFILL;
+  invpercQueue = INVPERC_QUEUE;
+  seed = RAND_SEED;
+  sorOmega = SOR_OMEGA;
+  sorTolerance = SOR_TOLERANCE;
+  sorMaxIters = SOR_MAX_ITERS;
+  threads = NUM_THREADS;
+  chainArena = CHAIN_ARENA;
+  chainFusion = CHAIN_FUSION;
+  chainDag = CHAIN_DAG;
+  chainStream = false;
+  chainLazy = false;
+  streamBudget = STREAM_BUDGET;
+  scratchDir = SCRATCH_DIR;
+  checkpointDir.clear ();
+  memory_set_huge_pages (HUGE_PAGES);
+  affinity_set_mode (PIN_THREADS);
+  mandel_set_isa (MANDEL_ISA_AUTO);
+
+  if (strcmp (problem, MANDEL) == 0) {
+    nr = MANDEL_NR;
+    nc = MANDEL_NC;
+  }
+  else if (strcmp (problem, RANDMAT) == 0) {
+    nr = RANDMAT_NR;
+    nc = RANDMAT_NC;
+  }
+  else if (strcmp (problem, HALF) == 0) {
+    nr = HALF_NR;
+    nc = HALF_NC;
+  }
+  else if (strcmp (problem, INVPERC) == 0) {
+    nr = INVPERC_NR;
+    nc = INVPERC_NC;
+  }
+  else if (strcmp (problem, THRESH) == 0) {
+    nr = THRESH_NR;
+    nc = THRESH_NC;
+  }
+  else if (strcmp (problem, LIFE) == 0) {
+    nr = LIFE_NR;
+    nc = LIFE_NC;
+  }
+  else if (strcmp (problem, WINNOW) == 0) {
+    nr = WINNOW_NR;
+    nc = WINNOW_NC;
+    n = WINNOW_N;
+  }
+  else if (strcmp (problem, NORM) == 0) {
+    n = NORM_N;
+  }
+  else if (strcmp (problem, HULL) == 0) {
+    n = HULL_N;
+  }
+  else if (strcmp (problem, OUTER) == 0) {
+    n = OUTER_N;
+  }
+  else if (strcmp (problem, GAUSS) == 0) {
+    n = GAUSS_N;
+  }
+  else if (strcmp (problem, SOR) == 0) {
+    n = SOR_N;
+  }
+  else if (strcmp (problem, PRODUCT) == 0) {
+    n = PRODUCT_N;
+  }
+  else if (strcmp (problem, VECDIFF) == 0) {
+    n = VECDIFF_N;
+  }
+  else if (strcmp (problem, CHAIN) == 0) {
+    nr = CHAIN_NR;
+    nc = CHAIN_NC;
+    n = CHAIN_N;
+  }
+}
+
+bool Cowichan::setOption(const std::string& name, const std::string& value)
+{
+  // problem parameters
+  if (name == "nr") {
+    nr = parse_count (value, false);
+  }
+  else if (name == "nc") {
+    nc = parse_count (value, false);
+  }
+  else if (name == "n") {
+    n = parse_count (value, false);
+  }
+  else if (name == "size") {
+    nr = nc = n = parse_count (value, false);
+  }
+  else if (name == "seed") {
+    seed = (INT_TYPE)parse_count (value, true);
+  }
+  else if (name == "threads") {
+    threads = parse_count (value, false);
+  }
+  else if (name == "life-iterations") {
+    lifeIterations = parse_count (value, true);
+  }
+  else if (name == "mandel-x0") {
+    mandelX0 = (real)parse_real (value);
+  }
+  else if (name == "mandel-y0") {
+    mandelY0 = (real)parse_real (value);
+  }
+  else if (name == "mandel-dx") {
+    mandelDx = (real)parse_real (value);
+  }
+  else if (name == "mandel-dy") {
+    mandelDy = (real)parse_real (value);
+  }
+  else if (name == "mandel-max-iter") {
+    mandelMaxIter = parse_count (value, false);
+  }
+  else if (name == "mandel-infinity") {
+    mandelInfinity = (real)parse_real (value);
+  }
+  else if (name == "mandel-isa") {
+    if (value == "auto") {
+      mandel_set_isa (MANDEL_ISA_AUTO);
+    }
+    else if (value == "scalar") {
+      mandel_set_isa (MANDEL_ISA_SCALAR);
+    }
+    else if (value == "sse2") {
+      mandel_set_isa (MANDEL_ISA_SSE2);
+    }
+    else if (value == "avx2") {
+      mandel_set_isa (MANDEL_ISA_AVX2);
+    }
+    else if (value == "avx512") {
+      mandel_set_isa (MANDEL_ISA_AVX512);
+    }
+    else {
+      bad_argument ("Unknown instruction set", value.c_str());
+    }
+  }
+  else if (name == "mandel-mode") {
+    if ((value != "points") && (value != "subdivide")) {
+      bad_argument ("Unknown mandel mode", value.c_str());
+    }
+    mandelSubdivide = (value == "subdivide");
+  }
+  else if (name == "mandel-tile") {
+    std::string::size_type split = value.find ('x');
+    if (split == std::string::npos) {
+      bad_argument ("Tile shape is not ROWSxCOLS", value.c_str());
+    }
+    mandelTileRows = parse_count (value.substr (0, split), true);
+    mandelTileCols = parse_count (value.substr (split + 1), true);
+  }
+  else if (name == "mandel-cache") {
+    mandelCacheBytes = (size_t)parse_count (value, true) << 20;
+  }
+  else if (name == "mandel-pan") {
+    std::string::size_type split = value.find ('x');
+    if (split == std::string::npos) {
+      bad_argument ("Pan is not ROWSxCOLS", value.c_str());
+    }
+    mandelPanRows = parse_integer (value.substr (0, split));
+    mandelPanCols = parse_integer (value.substr (split + 1));
+  }
+  else if (name == "thresh-percent") {
+    threshPercent = (real)parse_real (value);
+  }
+  else if (name == "invperc-nfill") {
+    invpercNFill = parse_count (value, true);
+  }
+  else if (name == "invperc-queue") {
+    if ((value != "bucket") && (value != "heap")) {
+      bad_argument ("Unknown invperc queue", value.c_str());
+    }
+    invpercQueue = (value == "heap") ? INVPERC_HEAP : INVPERC_BUCKETS;
+  }
+  else if (name == "sor-omega") {
+    sorOmega = parse_real (value);
+  }
+  else if (name == "sor-tolerance") {
+    sorTolerance = parse_real (value);
+  }
+  else if (name == "sor-max-iters") {
+    sorMaxIters = parse_count (value, false);
+  }
+  else if (name == "chain-source") {
+    if ((value != RANDMAT) && (value != MANDEL)) {
+      bad_argument ("Unknown chain source", value.c_str());
+    }
+    useRandmat = (value == RANDMAT);
+  }
+  else if (name == "chain-mask") {
+    if ((value != THRESH) && (value != INVPERC)) {
+      bad_argument ("Unknown chain mask", value.c_str());
+    }
+    useThresh = (value == THRESH);
+  }
+  else if (name == "chain-memory") {
+    if ((value != "fresh") && (value != "arena") && (value != "stream")
+        && (value != "lazy")) {
+      bad_argument ("Unknown chain memory mode", value.c_str());
+    }
+    chainArena = (value == "arena");
+    chainStream = (value == "stream");
+    chainLazy = (value == "lazy");
+  }
+  else if (name == "stream-budget") {
+    streamBudget = (size_t)parse_count (value, false) << 20;
+  }
+  else if (name == "scratch-dir") {
+    scratchDir = value;
+  }
+  else if (name == "checkpoint") {
+    checkpointDir = value;
+  }
+  else if (name == "chain-fusion") {
+    if ((value != "on") && (value != "off")) {
+      bad_argument ("Unknown chain fusion setting", value.c_str());
+    }
+    chainFusion = (value == "on");
+  }
+  else if (name == "chain-dag") {
+    if ((value != "on") && (value != "off")) {
+      bad_argument ("Unknown chain dag setting", value.c_str());
+    }
+    chainDag = (value == "on");
+  }
+  // memory settings
+  else if (name == "huge-pages") {
+    if (value == "none") {
+      memory_set_huge_pages (HUGE_PAGES_NONE);
+    }
+    else if (value == "thp") {
+      memory_set_huge_pages (HUGE_PAGES_THP);
+    }
+    else if (value == "hugetlb") {
+      memory_set_huge_pages (HUGE_PAGES_HUGETLB);
+    }
+    else {
+      bad_argument ("Unknown huge page mode", value.c_str());
+    }
+  }
+  // thread settings
+  else if (name == "pin") {
+    if (value == "none") {
+      affinity_set_mode (PIN_NONE);
+    }
+    else if (value == "compact") {
+      affinity_set_mode (PIN_COMPACT);
+    }
+    else if (value == "scatter") {
+      affinity_set_mode (PIN_SCATTER);
+    }
+    else {
+      bad_argument ("Unknown pin mode", value.c_str());
+    }
+  }
+  // benchmark settings
+  else if (name == "warmup") {
+    benchmarks->warmups = parse_count (value, true);
+  }
+  else if (name == "repeat") {
+    benchmarks->repeats = parse_count (value, false);
+  }
+  else if (name == "format") {
+    if (value == "text") {
+      benchmarks->format = BENCHMARK_TEXT;
+    }
+    else if (value == "json") {
+      benchmarks->format = BENCHMARK_JSON;
+    }
+    else if (value == "csv") {
+      benchmarks->format = BENCHMARK_CSV;
+    }
+    else {
+      bad_argument ("Unknown format", value.c_str());
+    }
+  }
+  else if (name == "counters") {
+    if ((value != "on") && (value != "off")) {
+      bad_argument ("Unknown counters setting", value.c_str());
+    }
+    benchmarks->counters = (value == "on");
+  }
+  else if (name == "output") {
+    benchmarks->output = value;
+  }
+  else if (name == "sweep-sizes") {
+    sweepSizes = parse_list (value);
+  }
+  else if (name == "sweep-threads") {
+    sweepThreads = parse_list (value);
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+void Cowichan::readConfig(const char* filename,
+    std::vector<std::pair<std::string, std::string> >& settings)
+{
+  std::ifstream in (filename);
+  std::string line;
+
+  if (!in) {
+    bad_argument ("Cannot open config file", filename);
+  }
+
+  while (std::getline (in, line)) {
+    // strip comments
+    line = trim (line.substr (0, line.find ('#')));
+    if (line.empty()) {
+      continue;
+    }
+
+    std::string::size_type equals = line.find ('=');
+    if (equals == std::string::npos) {
+      bad_argument ("Expected name = value in config file", line.c_str());
+    }
+    settings.push_back (std::make_pair (trim (line.substr (0, equals)),
+        trim (line.substr (equals + 1))));
+  }
+}
+
+void Cowichan::usage(const char* program)
+{
+  std::cout << "usage: " << program << " [problem] [--name value]..."
+      << std::endl << std::endl
+      << "problems: " << CHAIN << " (default), " << MANDEL << ", " << RANDMAT
+      << ", " << HALF << ", " << INVPERC << ", " << THRESH << ", " << LIFE
+      << ", " << WINNOW << ", " << NORM << ", " << HULL << ", " << OUTER
+      << ", " << GAUSS << ", " << SOR << ", " << PRODUCT << ", " << VECDIFF
+      << std::endl << std::endl
+      << "parameters (defaults for the chain):" << std::endl
+      << "  --nr, --nc, --n      matrix sizes (" << CHAIN_NR << ", "
+      << CHAIN_NC << ", " << CHAIN_N << ")" << std::endl
+      << "  --size               sets nr, nc and n" << std::endl
+      << "  --seed               random seed (" << RAND_SEED << ")"
+      << std::endl
+      << "  --threads            threads or worker processes ("
+      << NUM_THREADS << ")" << std::endl
+      << "  --life-iterations    (" << LIFE_ITERATIONS << ")" << std::endl
+      << "  --mandel-x0, --mandel-y0, --mandel-dx, --mandel-dy" << std::endl
+      << "                       region (" << MANDEL_X0 << ", " << MANDEL_Y0
+      << ", " << MANDEL_DX << ", " << MANDEL_DY << ")" << std::endl
+      << "  --mandel-max-iter    (" << MANDEL_MAX_ITER << ")" << std::endl
+      << "  --mandel-infinity    (" << MANDEL_INFINITY << ")" << std::endl
+      << "  --mandel-isa ISA     auto (widest supported), scalar, sse2, avx2"
+      << std::endl
+      << "                       or avx512" << std::endl
+      << "  --mandel-mode MODE   points (every point) or subdivide (fill"
+      << std::endl
+      << "                       rectangles with a uniform border) ("
+      << (MANDEL_SUBDIVIDE ? "subdivide" : "points") << ")" << std::endl
+      << "  --mandel-tile RxC    rows x columns per tile where threads take"
+      << std::endl
+      << "                       tiles, 0 for all (" << MANDEL_TILE_ROWS << "x"
+      << MANDEL_TILE_COLS << "; 1x0 is one row)" << std::endl
+      << "  --mandel-cache MB    keep tiles for later calls that overlap ("
+      << (MANDEL_CACHE >> 20) << ")" << std::endl
+      << "  --mandel-pan RxC     move the mandel viewport by R rows and C"
+      << std::endl
+      << "                       columns every run, either may be negative"
+      << std::endl
+      << "                       (0x0)" << std::endl
+      << "  --thresh-percent     (" << THRESH_PERCENT << ")" << std::endl
+      << "  --invperc-nfill      (" << INVPERC_NFILL << ")" << std::endl
+      << "  --invperc-queue Q    bucket (a bucket per value) or heap (4-ary"
+      << std::endl
+      << "                       heap of packed keys) ("
+      << ((INVPERC_QUEUE == INVPERC_HEAP) ? "heap" : "bucket") << ")"
+      << std::endl
+      << "  --sor-omega          (" << SOR_OMEGA << ")" << std::endl
+      << "  --sor-tolerance      (" << SOR_TOLERANCE << ")" << std::endl
+      << "  --sor-max-iters      (" << SOR_MAX_ITERS << ")" << std::endl
+      << "  --chain-source       " << RANDMAT << " or " << MANDEL << std::endl
+      << "  --chain-mask         " << THRESH << " or " << INVPERC << std::endl
+      << "  --chain-memory MODE  fresh (allocate per step), arena (plan"
+      << std::endl
+      << "                       buffer lifetimes, reuse one arena),"
+      << std::endl
+      << "                       stream (steps 1-5 out of core, thresh only)"
+      << std::endl
+      << "                       or lazy (randmat generated on demand, thresh"
+      << std::endl
+      << "                       only)" << std::endl
+      << "  --stream-budget MB   memory for matrix rows when streaming ("
+      << (STREAM_BUDGET >> 20) << ")" << std::endl
+      << "  --scratch-dir DIR    scratch files when streaming (" << SCRATCH_DIR
+      << ")" << std::endl
+      << "  --chain-fusion on|off  fuse the generator with half and keep"
+      << std::endl
+      << "                       masks packed up to winnow (off)" << std::endl
+      << "  --chain-dag on|off   run gauss+product and sor+product"
+      << std::endl
+      << "                       concurrently (off)" << std::endl
+      << "  --checkpoint DIR     write every chain output to DIR as a binary"
+      << std::endl
+      << "                       matrix file (NN-step" MATRIX_FILE_EXTENSION ")"
+      << std::endl
+      << "  --huge-pages MODE    none, thp (default) or hugetlb" << std::endl
+      << "  --pin MODE           thread i on one processor: none (default),"
+      << std::endl
+      << "                       compact (fill cores) or scatter (spread"
+      << std::endl
+      << "                       over packages and cores)" << std::endl
+      << std::endl
+      << "benchmarking:" << std::endl
+      << "  --warmup N           unrecorded runs (" << BENCHMARK_WARMUPS << ")"
+      << std::endl
+      << "  --repeat N           recorded runs (" << BENCHMARK_REPEATS << ")"
+      << std::endl
+      << "  --format FORMAT      text, json or csv" << std::endl
+      << "  --output FILE        write the report to FILE" << std::endl
+      << "  --counters on|off    hardware counters per kernel: IPC, LLC,"
+      << std::endl
+      << "                       branch and dTLB misses, bytes/flop (off)"
+      << std::endl
+      << "  --sweep-sizes LIST   comma-separated sizes for nr, nc and n"
+      << std::endl
+      << "  --sweep-threads LIST comma-separated thread counts" << std::endl
+      << "  --config FILE        read name = value settings from FILE"
+      << std::endl;
+  exit(0);
+}
+
+INT64 Cowichan::startKernel()
+{
+  if (counters != NULL) {
+    counterStarts.push_back (PerfSample());
+    counters->read (counterStarts.back());
+  }
+  return get_ticks ();
+}
+
+void Cowichan::record(const char* name, INT64 start, INT64 end)
+{
+  recordTime (name, start, end);
+
+  if (counters != NULL) {
+    PerfSample now;
+    counters->read (now);
+    index_t rows, cols, size;
+    kernelSizes (name, rows, cols, size);
+    benchmarks->recordCounters (name, rows, cols, size, threads, benchmarkRun,
+        counterStarts.back(), now, kernelFlops (name));
+    counterStarts.pop_back ();
+  }
+}
+
+void Cowichan::recordTime(const char* name, INT64 start, INT64 end)
+{
+  index_t rows, cols, size;
+  kernelSizes (name, rows, cols, size);
+  benchmarks->record (name, rows, cols, size, threads, benchmarkRun, start,
+      end);
+}
+
+void Cowichan::kernelSizes(const char* name, index_t& rows, index_t& cols,
+    index_t& size) const
+{
+  // winnow and the chain go from the rectangular matrix to n points
+  bool both = (strcmp (name, WINNOW) == 0) || (strcmp (name, CHAIN) == 0);
+  bool rect = both || (strcmp (name, MANDEL) == 0)
+      || (strcmp (name, RANDMAT) == 0) || (strcmp (name, HALF) == 0)
+      || (strcmp (name, INVPERC) == 0) || (strcmp (name, THRESH) == 0)
+      || (strcmp (name, LIFE) == 0) || (strcmp (name, RANDMAT_HALF) == 0)
+      || (strcmp (name, MANDEL_HALF) == 0);
+
+  rows = rect ? nr : 0;
+  cols = rect ? nc : 0;
+  size = (both || !rect) ? n : 0;
+}
+
+double Cowichan::kernelFlops(const char* name) const
+{
+  double size = (double)n;
+
+  if (strcmp (name, NORM) == 0) {
+    return 8.0 * size; // bounds, then scale
+  }
+  else if (strcmp (name, OUTER) == 0) {
+    return 3.0 * size * size; // 6 per distance, for half the pairs
+  }
+  else if (strcmp (name, GAUSS) == 0) {
+    return 2.0 / 3.0 * size * size * size;
+  }
+  else if ((strcmp (name, PRODUCT) == 0)
+      || (strcmp (name, CHAIN_PRODUCT_GAUSS) == 0)
+      || (strcmp (name, CHAIN_PRODUCT_SOR) == 0)) {
+    return 2.0 * size * size;
+  }
+  else if (strcmp (name, VECDIFF) == 0) {
+    return 2.0 * size;
+  }
+  return 0.0;
+}
+
+void Cowichan::run (const char* problem)
+{
+  INT64 start, end;
+  index_t runs = benchmarks->runs ();
+
+  // the peak covers the inputs and outputs along with the kernel's own memory
+  memory_reset_peak ();
+
+  if (strcmp (problem, CHAIN) == 0) {
+    if (chainArena) {
+      planChain ();
+    }
+
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      start = startKernel ();
+      chain (useRandmat, useThresh);
       end = get_ticks ();
-      mandel (matrix);
-      timeInfo(&start, &end, MANDEL);
-      print_rect_matrix<INT_TYPE> (matrix);
+      record (CHAIN, start, end);
+    }
+
+    if (chainArena) {
+      freeChain ();
+    }
+  }
+  else if (strcmp (problem, MANDEL) == 0) {
+    // initialize
+    IntMatrix matrix = NULL;
 
-      // clean up
-      delete [] matrix;
+    try {
+      matrix = NEW_MATRIX_RECT(INT_TYPE);
     }
-    else if (strcmp (argv[1], RANDMAT) == 0) {
-      // set up
-      nr = RANDMAT_NR;
-      nc = RANDMAT_NC;
-      seed = RAND_SEED;
+    catch (...) {out_of_memory();}
 
-      // initialize
-      IntMatrix matrix = NULL;
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      // move the viewport by whole steps
+      mandelRow0 = benchmarkRun * mandelPanRows;
+      mandelCol0 = benchmarkRun * mandelPanCols;
 
-      try {
-        matrix = NEW_MATRIX_RECT(INT_TYPE);
-      }
-      catch (...) {out_of_memory();}
+      // execute
+      start = startKernel ();
+      computeMandel (matrix);
+      end = get_ticks ();
+      record (MANDEL, start, end);
+    }
+    mandelRow0 = 0;
+    mandelCol0 = 0;
+    print_rect_matrix<INT_TYPE> (matrix);
+
+    // clean up
+    DELETE_ARRAY(matrix);
+  }
+  else if (strcmp (problem, RANDMAT) == 0) {
+    // initialize
+    IntMatrix matrix = NULL;
+
+    try {
+      matrix = NEW_MATRIX_RECT(INT_TYPE);
+    }
+    catch (...) {out_of_memory();}
 
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
       // execute
-      end = get_ticks ();
+      start = startKernel ();
       randmat (matrix);
-      timeInfo(&start, &end, RANDMAT);
-      print_rect_matrix<INT_TYPE> (matrix);
+      end = get_ticks ();
+      record (RANDMAT, start, end);
+    }
+    print_rect_matrix<INT_TYPE> (matrix);
 
-      // clean up
-      delete [] matrix;
+    // clean up
+    DELETE_ARRAY(matrix);
+  }
+  else if (strcmp (problem, HALF) == 0) {
+    // initialize
+    IntMatrix matrixIn = NULL;
+    IntMatrix matrixOut = NULL;
+
+    try {
+      matrixIn = NEW_MATRIX_RECT(INT_TYPE);
+      matrixOut = NEW_MATRIX_RECT(INT_TYPE);
     }
-    else if (strcmp (argv[1], HALF) == 0) {
-      // set up
-      nr = HALF_NR;
-      nc = HALF_NC;
-      srand(RAND_SEED);
+    catch (...) {out_of_memory();}
 
-      // initialize
-      IntMatrix matrixIn = NULL;
-      IntMatrix matrixOut = NULL;
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomInts (matrixIn, nr, nc, 0);
 
-      try {
-        matrixIn = NEW_MATRIX_RECT(INT_TYPE);
-        matrixOut = NEW_MATRIX_RECT(INT_TYPE);
-      }
-      catch (...) {out_of_memory();}
+      // execute
+      start = startKernel ();
+      half (matrixIn, matrixOut);
+      end = get_ticks ();
+      record (HALF, start, end);
+    }
+    print_rect_matrix<INT_TYPE> (matrixOut);
 
-      index_t r, c;
+    // clean up
+    DELETE_ARRAY(matrixIn);
+    DELETE_ARRAY(matrixOut);
+  }
+  else if (strcmp (problem, INVPERC) == 0) {
+    // initialize
+    IntMatrix matrix = NULL;
+    BoolMatrix mask = NULL;
+
+    try {
+      matrix = NEW_MATRIX_RECT(INT_TYPE);
+      mask = NEW_MATRIX_RECT(bool);
+    }
+    catch (...) {out_of_memory();}
 
-      for (r = 0; r < nr; r++) {
-        for (c = 0; c < nc; c++) {
-          MATRIX_RECT(matrixIn, r, c) = rand () % RAND_M;
-        }
-      }
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomInts (matrix, nr, nc, 0);
+      memset (mask, 0, nr * nc * sizeof(bool));
 
       // execute
+      start = startKernel ();
+      invperc (matrix, mask);
       end = get_ticks ();
-      half (matrixIn, matrixOut);
-      timeInfo(&start, &end, HALF);
-      print_rect_matrix<INT_TYPE> (matrixOut);
-
-      // clean up
-      delete [] matrixIn;
-      delete [] matrixOut;
-    }
-    else if (strcmp (argv[1], INVPERC) == 0) {
-      // set up
-      nr = INVPERC_NR;
-      nc = INVPERC_NC;
-      invpercNFill = INVPERC_NFILL;
-      srand(RAND_SEED);
-
-      // initialize
-      IntMatrix matrix = NULL;
-      BoolMatrix mask = NULL;
-
-      try {
-        matrix = NEW_MATRIX_RECT(INT_TYPE);
-        mask = NEW_MATRIX_RECT(bool);
-      }
-      catch (...) {out_of_memory();}
+      record (INVPERC, start, end);
+    }
+    print_bool_rect_matrix (mask);
 
-      index_t r, c;
+    // clean up
+    DELETE_ARRAY(matrix);
+    DELETE_ARRAY(mask);
+  }
+  else if (strcmp (problem, THRESH) == 0) {
+    // initialize
+    IntMatrix matrix = NULL;
+    BoolMatrix mask = NULL;
+
+    try {
+      matrix = NEW_MATRIX_RECT(INT_TYPE);
+      mask = NEW_MATRIX_RECT(bool);
+    }
+    catch (...) {out_of_memory();}
+
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomInts (matrix, nr, nc, 0);
 
-      for (r = 0; r < nr; r++) {
-        for (c = 0; c < nc; c++) {
-          MATRIX_RECT(matrix, r, c) = rand () % RAND_M;
-          MATRIX_RECT(mask, r, c) = false;
-        }
-      }
-      
       // execute
+      start = startKernel ();
+      thresh (matrix, mask);
       end = get_ticks ();
-      invperc (matrix, mask);
-      timeInfo(&start, &end, INVPERC);
-      print_bool_rect_matrix (mask);
-
-      // clean up
-      delete [] matrix;
-      delete [] mask;
-    }
-    else if (strcmp (argv[1], THRESH) == 0) {
-      // set up
-      nr = THRESH_NR;
-      nc = THRESH_NC;
-      threshPercent = THRESH_PERCENT;
-      srand(RAND_SEED);
-
-      // initialize
-      IntMatrix matrix = NULL;
-      BoolMatrix mask = NULL;
-
-      try {
-        matrix = NEW_MATRIX_RECT(INT_TYPE);
-        mask = NEW_MATRIX_RECT(bool);
-      }
-      catch (...) {out_of_memory();}
+      record (THRESH, start, end);
+    }
+    print_bool_rect_matrix (mask);
+
+    // clean up
+    DELETE_ARRAY(matrix);
+    DELETE_ARRAY(mask);
+  }
+  else if (strcmp (problem, LIFE) == 0) {
+    // initialize
+    BoolMatrix matrixIn = NULL;
+    BoolMatrix matrixOut = NULL;
+
+    try {
+      matrixIn = NEW_MATRIX_RECT(bool);
+      matrixOut = NEW_MATRIX_RECT(bool);
+    }
+    catch (...) {out_of_memory();}
 
-      index_t r, c;
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomBools (matrixIn, nr, nc, 0);
 
-      for (r = 0; r < nr; r++) {
-        for (c = 0; c < nc; c++) {
-          MATRIX_RECT(matrix, r, c) = rand () % RAND_M;
-        }
-      }
-      
       // execute
+      start = startKernel ();
+      life (matrixIn, matrixOut);
       end = get_ticks ();
-      thresh (matrix, mask);
-      timeInfo(&start, &end, THRESH);
-      print_bool_rect_matrix (mask);
-
-      // clean up
-      delete [] matrix;
-      delete [] mask;
-    }
-    else if (strcmp (argv[1], LIFE) == 0) {
-      // set up
-      nr = LIFE_NR;
-      nc = LIFE_NC;
-      lifeIterations = LIFE_ITERATIONS;
-      srand(RAND_SEED);
-
-      // initialize
-      BoolMatrix matrixIn = NULL;
-      BoolMatrix matrixOut = NULL;
-
-      try {
-        matrixIn = NEW_MATRIX_RECT(bool);
-        matrixOut = NEW_MATRIX_RECT(bool);
-      }
-      catch (...) {out_of_memory();}
+      record (LIFE, start, end);
+    }
+    print_bool_rect_matrix (matrixOut);
+
+    // clean up
+    DELETE_ARRAY(matrixIn);
+    DELETE_ARRAY(matrixOut);
+  }
+  else if (strcmp (problem, WINNOW) == 0) {
+    // initialize
+    IntMatrix matrix = NULL;
+    BoolMatrix mask = NULL;
+    PointVector points = NULL;
+
+    try {
+      matrix = NEW_MATRIX_RECT(INT_TYPE);
+      mask = NEW_MATRIX_RECT(bool);
+      points = NEW_VECTOR(Point);
+    }
+    catch (...) {out_of_memory();}
 
-      index_t r, c;
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomInts (matrix, nr, nc, 0);
+      randomBools (mask, nr, nc, 1);
 
-      for (r = 0; r < nr; r++) {
-        for (c = 0; c < nc; c++) {
-          MATRIX_RECT(matrixIn, r, c) = (rand () % 2) == 0;
-        }
-      }
-      
       // execute
+      start = startKernel ();
+      winnow (matrix, mask, points);
       end = get_ticks ();
-      life (matrixIn, matrixOut);
-      timeInfo(&start, &end, LIFE);
-      print_bool_rect_matrix (matrixOut);
-
-      // clean up
-      delete [] matrixIn;
-      delete [] matrixOut;
-    }
-    else if (strcmp (argv[1], WINNOW) == 0) {
-      // set up
-      nr = WINNOW_NR;
-      nc = WINNOW_NC;
-      n = WINNOW_N;
-      srand(RAND_SEED);
-
-      // initialize
-      IntMatrix matrix = NULL;
-      BoolMatrix mask = NULL;
-      PointVector points = NULL;
-
-      try {
-        matrix = NEW_MATRIX_RECT(INT_TYPE);
-        mask = NEW_MATRIX_RECT(bool);
-        points = NEW_VECTOR(Point);
-      }
-      catch (...) {out_of_memory();}
+      record (WINNOW, start, end);
+    }
+    print_vector(points);
 
-      index_t r, c;
+    // clean up
+    DELETE_ARRAY(matrix);
+    DELETE_ARRAY(mask);
+    DELETE_ARRAY(points);
+  }
+  else if (strcmp (problem, NORM) == 0) {
+    // initialize
+    PointVector pointsIn = NULL;
+    PointVector pointsOut = NULL;
+
+    try {
+      pointsIn = NEW_VECTOR(Point);
+      pointsOut = NEW_VECTOR(Point);
+    }
+    catch (...) {out_of_memory();}
+
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomPoints (pointsIn, n, 0);
 
-      for (r = 0; r < nr; r++) {
-        for (c = 0; c < nc; c++) {
-          MATRIX_RECT(matrix, r, c) = rand () % RAND_M;
-          MATRIX_RECT(mask, r, c) = (rand () % 2) == 0;
-        }
-      }
-      
       // execute
+      start = startKernel ();
+      norm (pointsIn, pointsOut);
       end = get_ticks ();
-      winnow (matrix, mask, points);
-      timeInfo(&start, &end, WINNOW);
-      print_vector(points);
-
-      // clean up
-      delete [] matrix;
-      delete [] mask;
-      delete [] points;
-    }
-    else if (strcmp (argv[1], NORM) == 0) {
-      // set up
-      n = NORM_N;
-      srand(RAND_SEED);
-
-      // initialize
-      PointVector pointsIn = NULL;
-      PointVector pointsOut = NULL;
-
-      try {
-        pointsIn = NEW_VECTOR(Point);
-        pointsOut = NEW_VECTOR(Point);
-      }
-      catch (...) {out_of_memory();}
+      record (NORM, start, end);
+    }
+    print_vector(pointsOut);
 
-      index_t r;
+    // clean up
+    DELETE_ARRAY(pointsIn);
+    DELETE_ARRAY(pointsOut);
+  }
+  else if (strcmp (problem, HULL) == 0) {
+    // initialize
+    PointVector pointsIn = NULL;
+    PointVector pointsOut = NULL;
+
+    try {
+      pointsIn = NEW_VECTOR(Point);
+      pointsOut = NEW_VECTOR(Point);
+    }
+    catch (...) {out_of_memory();}
+
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomPoints (pointsIn, n, 0);
 
-      for (r = 0; r < n; r++) {
-        VECTOR(pointsIn, r).x = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-        VECTOR(pointsIn, r).y = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-      }
-      
       // execute
+      start = startKernel ();
+      hull (pointsIn, pointsOut);
       end = get_ticks ();
-      norm (pointsIn, pointsOut);
-      timeInfo(&start, &end, NORM);
-      print_vector(pointsOut);
-
-      // clean up
-      delete [] pointsIn;
-      delete [] pointsOut;
+      record (HULL, start, end);
     }
-    else if (strcmp (argv[1], HULL) == 0) {
-      // set up
-      n = HULL_N;
-      srand(RAND_SEED);
+    print_vector(pointsOut);
 
-      // initialize
-      PointVector pointsIn = NULL;
-      PointVector pointsOut = NULL;
-
-      try {
-        pointsIn = NEW_VECTOR(Point);
-        pointsOut = NEW_VECTOR(Point);
-      }
-      catch (...) {out_of_memory();}
+    // clean up
+    DELETE_ARRAY(pointsIn);
+    DELETE_ARRAY(pointsOut);
+  }
+  else if (strcmp (problem, OUTER) == 0) {
+    // initialize
+    PointVector points = NULL;
+    Matrix matrix = NULL;
+    Vector vector = NULL;
+
+    try {
+      points = NEW_VECTOR(Point);
+      matrix = NEW_MATRIX_SQUARE(real);
+      vector = NEW_VECTOR(real);
+    }
+    catch (...) {out_of_memory();}
 
-      index_t r;
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomPoints (points, n, 0);
 
-      for (r = 0; r < n; r++) {
-        VECTOR(pointsIn, r).x = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-        VECTOR(pointsIn, r).y = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-      }
-      
       // execute
+      start = startKernel ();
+      outer (points, matrix, vector);
       end = get_ticks ();
-      hull (pointsIn, pointsOut);
-      timeInfo(&start, &end, HULL);
-      print_vector(pointsOut);
-
-      // clean up
-      delete [] pointsIn;
-      delete [] pointsOut;
-    }
-    else if (strcmp (argv[1], OUTER) == 0) {
-      // set up
-      n = OUTER_N;
-      srand(RAND_SEED);
-
-      // initialize
-      PointVector points = NULL;
-      Matrix matrix = NULL;
-      Vector vector = NULL;
-
-      try {
-        points = NEW_VECTOR(Point);
-        matrix = NEW_MATRIX_SQUARE(real);
-        vector = NEW_VECTOR(real);
-      }
-      catch (...) {out_of_memory();}
+      record (OUTER, start, end);
+    }
+    print_square_matrix<real> (matrix);
+    print_vector<real> (vector);
 
-      index_t r;
+    // clean up
+    DELETE_ARRAY(points);
+    DELETE_ARRAY(matrix);
+    DELETE_ARRAY(vector);
+  }
+  else if ((strcmp (problem, GAUSS) == 0) || (strcmp (problem, SOR) == 0)) {
+    bool use_gauss = (strcmp (problem, GAUSS) == 0);
+
+    // initialize
+    Matrix matrix = NULL;
+    Vector target = NULL;
+    Vector solution = NULL;
+
+    try {
+      matrix = NEW_MATRIX_SQUARE(real);
+      target = NEW_VECTOR(real);
+      solution = NEW_VECTOR(real);
+    }
+    catch (...) {out_of_memory();}
+
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      // symmetric, diagonally dominant matrix (gauss works in place)
+      randomSymmetric (matrix, 0);
+      randomReals (target, n, 1, 1);
 
-      for (r = 0; r < n; r++) {
-        VECTOR(points, r).x = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-        VECTOR(points, r).y = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-      }
-      
-      // execute
-      end = get_ticks ();
-      outer (points, matrix, vector);
-      timeInfo(&start, &end, OUTER);
-      print_square_matrix<real> (matrix);
-      print_vector<real> (vector);
-
-      // clean up
-      delete [] points;
-      delete [] matrix;
-      delete [] vector;
-    }
-    else if (strcmp (argv[1], GAUSS) == 0) {
-      // set up
-      n = GAUSS_N;
-      srand(RAND_SEED);
-
-      // initialize
-      Matrix matrix = NULL;
-      Vector target = NULL;
-      Vector solution = NULL;
-
-      try {
-        matrix = NEW_MATRIX_SQUARE(real);
-        target = NEW_VECTOR(real);
-        solution = NEW_VECTOR(real);
-      }
-      catch (...) {out_of_memory();}
-
-      index_t r, c;
-      real value, maxValue = -1;
-
-      // create symmetric, diagonally dominant matrix
-      for (r = 0; r < n; r++) {
-        for (c = 0; c < r; c++) {
-          value = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-          MATRIX_SQUARE(matrix, r, c) = MATRIX_SQUARE(matrix, c, r) = value;
-          if (std::abs(value) > maxValue) {
-            maxValue = std::abs(value);
-          }
-        }
-        target[r] = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-      }
-      maxValue *= n;
-      for (r = 0; r < n; r++) {
-        DIAG(matrix, r) = maxValue;
-      }
-      
       // execute
-      end = get_ticks ();
-      gauss (matrix, target, solution);
-      timeInfo(&start, &end, GAUSS);
-      print_vector<real> (solution);
-
-      // clean up
-      delete [] matrix;
-      delete [] target;
-      delete [] solution;
-    }
-    else if (strcmp (argv[1], SOR) == 0) {
-      // set up
-      n = SOR_N;
-      srand(RAND_SEED);
-
-      // initialize
-      Matrix matrix = NULL;
-      Vector target = NULL;
-      Vector solution = NULL;
-
-      try {
-        matrix = NEW_MATRIX_SQUARE(real);
-        target = NEW_VECTOR(real);
-        solution = NEW_VECTOR(real);
-      }
-      catch (...) {out_of_memory();}
-
-      index_t r, c;
-      real value, maxValue = -1;
-
-      // create symmetric, diagonally dominant matrix
-      for (r = 0; r < n; r++) {
-        for (c = 0; c < r; c++) {
-          value = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-          MATRIX_SQUARE(matrix, r, c) = MATRIX_SQUARE(matrix, c, r) = value;
-          if (std::abs(value) > maxValue) {
-            maxValue = std::abs(value);
-          }
-        }
-        target[r] = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
+      start = startKernel ();
+      if (use_gauss) {
+        gauss (matrix, target, solution);
       }
-      maxValue *= n;
-      for (r = 0; r < n; r++) {
-        DIAG(matrix, r) = maxValue;
+      else {
+        sor (matrix, target, solution);
       }
-      
-      // execute
       end = get_ticks ();
-      sor (matrix, target, solution);
-      timeInfo(&start, &end, SOR);
-      print_vector<real> (solution);
-
-      // clean up
-      delete [] matrix;
-      delete [] target;
-      delete [] solution;
-    }
-    else if (strcmp (argv[1], PRODUCT) == 0) {
-      // set up
-      n = PRODUCT_N;
-      srand(RAND_SEED);
-
-      // initialize
-      Matrix matrix = NULL;
-      Vector candidate = NULL;
-      Vector solution = NULL;
-
-      try {
-        matrix = NEW_MATRIX_SQUARE(real);
-        candidate = NEW_VECTOR(real);
-        solution = NEW_VECTOR(real);
-      }
-      catch (...) {out_of_memory();}
+      record (problem, start, end);
+    }
+    print_vector<real> (solution);
+
+    // clean up
+    DELETE_ARRAY(matrix);
+    DELETE_ARRAY(target);
+    DELETE_ARRAY(solution);
+  }
+  else if (strcmp (problem, PRODUCT) == 0) {
+    // initialize
+    Matrix matrix = NULL;
+    Vector candidate = NULL;
+    Vector solution = NULL;
+
+    try {
+      matrix = NEW_MATRIX_SQUARE(real);
+      candidate = NEW_VECTOR(real);
+      solution = NEW_VECTOR(real);
+    }
+    catch (...) {out_of_memory();}
+
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomReals (matrix, n, n, 0);
+      randomReals (candidate, n, 1, 1);
 
-      index_t r, c;
-      for (r = 0; r < n; r++) {
-        for (c = 0; c < r; c++) {
-          MATRIX_SQUARE(matrix, r, c) = uniform ((real)RAND_MEAN,
-              (real)RAND_RANGE);
-        }
-        candidate[r] = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-      }
-      
       // execute
-      end = get_ticks ();
+      start = startKernel ();
       product (matrix, candidate, solution);
-      timeInfo(&start, &end, PRODUCT);
-      print_vector<real> (solution);
-
-      // clean up
-      delete [] matrix;
-      delete [] candidate;
-      delete [] solution;
-    }
-    else if (strcmp (argv[1], VECDIFF) == 0) {
-      // set up
-      n = VECDIFF_N;
-      srand(RAND_SEED);
-
-      // initialize
-      Vector actual = NULL;
-      Vector computed = NULL;
-
-      try {
-        actual = NEW_VECTOR(real);
-        computed = NEW_VECTOR(real);
-      }
-      catch (...) {out_of_memory();}
+      end = get_ticks ();
+      record (PRODUCT, start, end);
+    }
+    print_vector<real> (solution);
+
+    // clean up
+    DELETE_ARRAY(matrix);
+    DELETE_ARRAY(candidate);
+    DELETE_ARRAY(solution);
+  }
+  else if (strcmp (problem, VECDIFF) == 0) {
+    // initialize
+    Vector actual = NULL;
+    Vector computed = NULL;
+
+    try {
+      actual = NEW_VECTOR(real);
+      computed = NEW_VECTOR(real);
+    }
+    catch (...) {out_of_memory();}
+
+    real maxDiff = 0;
+
+    for (benchmarkRun = 0; benchmarkRun < runs; benchmarkRun++) {
+      randomReals (actual, n, 1, 0);
+      randomReals (computed, n, 1, 1);
 
-      index_t r;
-      for (r = 0; r < n; r++) {
-        actual[r] = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-        computed[r] = uniform ((real)RAND_MEAN, (real)RAND_RANGE);
-      }
-      
       // execute
+      start = startKernel ();
+      maxDiff = vecdiff (actual, computed);
       end = get_ticks ();
+      record (VECDIFF, start, end);
+    }
 #ifdef OUTPUT_DATA
-      real maxDiff = vecdiff (actual, computed);
+    std::cout << maxDiff;
 #else
-      vecdiff (actual, computed);
-#endif
-      timeInfo(&start, &end, VECDIFF);
-#ifdef OUTPUT_DATA
-      std::cout << maxDiff;
+    (void)maxDiff;
 #endif
 
-      // clean up
-      delete [] actual;
-      delete [] computed;
-    }
+    // clean up
+    DELETE_ARRAY(actual);
+    DELETE_ARRAY(computed);
+  }
+  else {
+    bad_argument ("Unknown problem", problem);
   }
+
+  index_t rows, cols, size;
+  kernelSizes (problem, rows, cols, size);
+  benchmarks->recordPeak (problem, rows, cols, size, threads, memory_peak ());
 }
 
-void Cowichan::chain(bool use_randmat, bool use_thresh)
+void Cowichan::chainPoints(bool use_randmat, bool use_thresh,
+    PointVector points)
 {
   INT64 start, end;
 
   // STEP 1: mandel or randmat
 
-  // set up
-  nr = CHAIN_NR;
-  nc = CHAIN_NC;
-
   // initialize
   IntMatrix matrix1 = NULL;
 
   try {
-    matrix1 = NEW_MATRIX_RECT(INT_TYPE);
+    matrix1 = chainNew<INT_TYPE>(CHAIN_MATRIX1, nr, nc);
   }
   catch (...) {out_of_memory();}
 
   if (use_randmat) {
-    // set up
-    seed = RAND_SEED;
-
     // execute
-    end = get_ticks ();
+    start = startKernel ();
     randmat (matrix1);
-    timeInfo(&start, &end, RANDMAT);
+    end = get_ticks ();
+    record (RANDMAT, start, end);
     print_rect_matrix<INT_TYPE> (matrix1);
+    checkpoint (RANDMAT, matrix1, nr, nc);
   }
   else {
-    // set up
-    mandelX0 = MANDEL_X0;
-    mandelY0 = MANDEL_Y0;
-    mandelDx = MANDEL_DX;
-    mandelDy = MANDEL_DY;
-
     // execute
+    start = startKernel ();
+    computeMandel (matrix1);
     end = get_ticks ();
-    mandel (matrix1);
-    timeInfo(&start, &end, MANDEL);
+    record (MANDEL, start, end);
     print_rect_matrix<INT_TYPE> (matrix1);
+    checkpoint (MANDEL, matrix1, nr, nc);
   }
 
   // STEP 2: half
@@ -685,18 +1412,20 @@ void Cowichan::chain(bool use_randmat, bool use_thresh)
   IntMatrix matrix2 = NULL;
 
   try {
-    matrix2 = NEW_MATRIX_RECT(INT_TYPE);
+    matrix2 = chainNew<INT_TYPE>(CHAIN_MATRIX2, nr, nc);
   }
   catch (...) {out_of_memory();}
 
   // execute
-  end = get_ticks ();
+  start = startKernel ();
   half (matrix1, matrix2);
-  timeInfo(&start, &end, HALF);
+  end = get_ticks ();
+  record (HALF, start, end);
   print_rect_matrix<INT_TYPE> (matrix2);
+  checkpoint (HALF, matrix2, nr, nc);
 
   // clean up
-  delete [] matrix1;
+  chainDelete(matrix1);
 
   // STEP 3: invperc or thresh
 
@@ -704,19 +1433,18 @@ void Cowichan::chain(bool use_randmat, bool use_thresh)
   BoolMatrix mask1 = NULL;
 
   try {
-    mask1 = NEW_MATRIX_RECT(bool);
+    mask1 = chainNew<bool>(CHAIN_MASK1, nr, nc);
   }
   catch (...) {out_of_memory();}
 
   if (use_thresh) {
-    // set up
-    threshPercent = THRESH_PERCENT;
-    
     // execute
-    end = get_ticks ();
+    start = startKernel ();
     thresh (matrix2, mask1);
-    timeInfo(&start, &end, THRESH);
+    end = get_ticks ();
+    record (THRESH, start, end);
     print_bool_rect_matrix (mask1);
+    checkpoint (THRESH, mask1, nr, nc);
   }
   else {
     // fill mask with false.
@@ -727,59 +1455,182 @@ void Cowichan::chain(bool use_randmat, bool use_thresh)
       }
     }
 
-    invpercNFill = INVPERC_NFILL;
-
     // execute
-    end = get_ticks ();
+    start = startKernel ();
     invperc (matrix2, mask1);
-    timeInfo(&start, &end, INVPERC);
+    end = get_ticks ();
+    record (INVPERC, start, end);
     print_bool_rect_matrix (mask1);
+    checkpoint (INVPERC, mask1, nr, nc);
   }
 
   // STEP 4: life
 
-  // set up
-  lifeIterations = LIFE_ITERATIONS;
-
   // initialize
   BoolMatrix mask2 = NULL;
 
   try {
-    mask2 = NEW_MATRIX_RECT(bool);
+    mask2 = chainNew<bool>(CHAIN_MASK2, nr, nc);
   }
   catch (...) {out_of_memory();}
 
   // execute
-  end = get_ticks ();
+  start = startKernel ();
   life (mask1, mask2);
-  timeInfo(&start, &end, LIFE);
+  end = get_ticks ();
+  record (LIFE, start, end);
   print_bool_rect_matrix (mask2);
+  checkpoint (LIFE, mask2, nr, nc);
 
   // clean up
-  delete [] mask1;
+  chainDelete(mask1);
 
   // STEP 5: winnow
 
-  // set up
-  n = CHAIN_N;
+  // execute
+  start = startKernel ();
+  winnow (matrix2, mask2, points);
+  end = get_ticks ();
+  record (WINNOW, start, end);
+  print_vector(points);
+  checkpoint (WINNOW, points, n, 1);
+
+  // clean up
+  chainDelete(matrix2);
+  chainDelete(mask2);
+}
+
+void Cowichan::chainPointsFused(bool use_randmat, bool use_thresh,
+    PointVector points)
+{
+  INT64 start, end;
+
+  // STEPS 1 and 2: mandel or randmat, then half
 
   // initialize
-  PointVector vector1 = NULL;
+  IntMatrix matrix2 = NULL;
+
+  try {
+    matrix2 = chainNew<INT_TYPE>(CHAIN_MATRIX2, nr, nc);
+  }
+  catch (...) {out_of_memory();}
+
+  if (use_randmat) {
+    // execute
+    start = startKernel ();
+    randmatHalf (matrix2);
+    end = get_ticks ();
+    record (RANDMAT_HALF, start, end);
+  }
+  else {
+    // execute
+    start = startKernel ();
+    mandelHalf (matrix2);
+    end = get_ticks ();
+    record (MANDEL_HALF, start, end);
+  }
+  print_rect_matrix<INT_TYPE> (matrix2);
+  checkpoint (use_randmat ? RANDMAT_HALF : MANDEL_HALF, matrix2, nr, nc);
+
+  // STEP 3: invperc or thresh
+
+  // initialize
+  BitMatrix* mask = NULL;
 
   try {
-    vector1 = NEW_VECTOR(Point);
+    mask = new BitMatrix(nr, nc);
   }
   catch (...) {out_of_memory();}
 
+  if (use_thresh) {
+    // execute
+    start = startKernel ();
+    threshBits (matrix2, *mask);
+    end = get_ticks ();
+    record (THRESH, start, end);
+  }
+  else {
+    // invperc grows its mask cell by cell; pack the result
+    BoolMatrix mask1 = NULL;
+
+    try {
+      mask1 = chainNew<bool>(CHAIN_MASK1, nr, nc);
+    }
+    catch (...) {out_of_memory();}
+
+    // fill mask with false.
+    index_t r, c;
+    for (r = 0; r < nr; r++) {
+      for (c = 0; c < nc; c++) {
+        MATRIX_RECT(mask1, r, c) = false;
+      }
+    }
+
+    // execute
+    start = startKernel ();
+    invperc (matrix2, mask1);
+    end = get_ticks ();
+    record (INVPERC, start, end);
+
+    mask->pack (mask1);
+    chainDelete(mask1);
+  }
+  print_bool_rect_matrix (*mask);
+  checkpoint (use_thresh ? THRESH : INVPERC, *mask);
+
+  // STEP 4: life
+
   // execute
+  start = startKernel ();
+  lifeBits (*mask);
   end = get_ticks ();
-  winnow (matrix2, mask2, vector1);
-  timeInfo(&start, &end, WINNOW);
-  print_vector(vector1);
+  record (LIFE, start, end);
+  print_bool_rect_matrix (*mask);
+  checkpoint (LIFE, *mask);
+
+  // STEP 5: winnow
+
+  // execute
+  start = startKernel ();
+  winnowBits (matrix2, *mask, points);
+  end = get_ticks ();
+  record (WINNOW, start, end);
+  print_vector(points);
+  checkpoint (WINNOW, points, n, 1);
 
   // clean up
-  delete [] matrix2;
-  delete [] mask2;
+  chainDelete(matrix2);
+  delete mask;
+}
+
+void Cowichan::chain(bool use_randmat, bool use_thresh)
+{
+  INT64 start, end;
+
+  // STEPS 1 to 5: mandel or randmat, half, invperc or thresh, life, winnow
+
+  checkpointCount = 0;
+
+  // initialize
+  PointVector vector1 = NULL;
+
+  try {
+    vector1 = chainNew<Point>(CHAIN_VECTOR1, n, 1);
+  }
+  catch (...) {out_of_memory();}
+
+  if (chainStream) {
+    chainPointsStream (use_randmat, use_thresh, vector1);
+  }
+  else if (chainLazy) {
+    chainPointsLazy (use_randmat, use_thresh, vector1);
+  }
+  else if (chainFusion) {
+    chainPointsFused (use_randmat, use_thresh, vector1);
+  }
+  else {
+    chainPoints (use_randmat, use_thresh, vector1);
+  }
 
   // STEP 6: norm
 
@@ -787,26 +1638,30 @@ void Cowichan::chain(bool use_randmat, bool use_thresh)
   PointVector vector2 = NULL;
 
   try {
-    vector2 = NEW_VECTOR(Point);
+    vector2 = chainNew<Point>(CHAIN_VECTOR2, n, 1);
   }
   catch (...) {out_of_memory();}
 
   // execute
-  end = get_ticks ();
+  start = startKernel ();
   norm (vector1, vector2);
-  timeInfo(&start, &end, NORM);
+  end = get_ticks ();
+  record (NORM, start, end);
   print_vector(vector2);
+  checkpoint (NORM, vector2, n, 1);
 
   // STEP 7: hull
 
   // execute
-  end = get_ticks ();
+  start = startKernel ();
   hull (vector2, vector1);
-  timeInfo(&start, &end, HULL);
+  end = get_ticks ();
+  record (HULL, start, end);
   print_vector(vector1);
+  checkpoint (HULL, vector1, n, 1);
 
   // clean up
-  delete [] vector2;
+  chainDelete(vector2);
 
   // STEP 8: outer
 
@@ -815,36 +1670,57 @@ void Cowichan::chain(bool use_randmat, bool use_thresh)
   Vector vector3 = NULL;
 
   try {
-    matrix3 = NEW_MATRIX_SQUARE(real);
-    vector3 = NEW_VECTOR(real);
+    matrix3 = chainNew<real>(CHAIN_MATRIX3, n, n);
+    vector3 = chainNew<real>(CHAIN_VECTOR3, n, 1);
   }
   catch (...) {out_of_memory();}
 
   // execute
-  end = get_ticks ();
+  start = startKernel ();
   outer (vector1, matrix3, vector3);
-  timeInfo(&start, &end, OUTER);
+  end = get_ticks ();
+  record (OUTER, start, end);
   print_square_matrix<real> (matrix3);
   print_vector<real> (vector3);
+  checkpoint (OUTER, matrix3, n, n);
+  checkpoint (OUTER, vector3, n, 1);
 
   // clean up
-  delete [] vector1;
+  chainDelete(vector1);
+
+  if (chainDag) {
+    chainSolveConcurrent (matrix3, vector3);
+    return;
+  }
 
   // STEP 9: gauss
 
-  // initialize
+  // initialize: gauss eliminates in place, so it gets its own copies and
+  // sor solves the same system as in chainSolveConcurrent
+  Matrix matrix4 = NULL;
   Vector vector4 = NULL;
+  Vector vector6 = NULL;
 
   try {
-    vector4 = NEW_VECTOR(real);
+    matrix4 = chainNew<real>(CHAIN_MATRIX4, n, n);
+    vector4 = chainNew<real>(CHAIN_VECTOR4, n, 1);
+    vector6 = chainNew<real>(CHAIN_VECTOR6, n, 1);
   }
   catch (...) {out_of_memory();}
 
+  memcpy (matrix4, matrix3, (size_t)n * n * sizeof(real));
+  memcpy (vector6, vector3, n * sizeof(real));
+
   // execute
+  start = startKernel ();
+  gauss (matrix4, vector6, vector4);
   end = get_ticks ();
-  gauss (matrix3, vector3, vector4);
-  timeInfo(&start, &end, GAUSS);
+  record (GAUSS, start, end);
   print_vector<real> (vector4);
+  checkpoint (GAUSS, vector4, n, 1);
+
+  // clean up
+  chainDelete(matrix4);
 
   // STEP 10: sor
 
@@ -852,52 +1728,143 @@ void Cowichan::chain(bool use_randmat, bool use_thresh)
   Vector vector5 = NULL;
 
   try {
-    vector5 = NEW_VECTOR(real);
+    vector5 = chainNew<real>(CHAIN_VECTOR5, n, 1);
   }
   catch (...) {out_of_memory();}
 
   // execute
-  end = get_ticks ();
+  start = startKernel ();
   sor (matrix3, vector3, vector5);
-  timeInfo(&start, &end, SOR);
+  end = get_ticks ();
+  record (SOR, start, end);
   print_vector<real> (vector5);
+  checkpoint (SOR, vector5, n, 1);
 
   // STEP 11: product (for gauss)
 
   // execute
+  start = startKernel ();
+  product (matrix3, vector4, vector6);
   end = get_ticks ();
-  product (matrix3, vector4, vector3);
-  timeInfo(&start, &end, PRODUCT);
-  print_vector<real> (vector3);
+  record (CHAIN_PRODUCT_GAUSS, start, end);
+  print_vector<real> (vector6);
+  checkpoint (CHAIN_PRODUCT_GAUSS, vector6, n, 1);
+
+  // clean up
+  chainDelete(vector4);
 
   // STEP 12: product (for sor)
 
   // execute
+  start = startKernel ();
+  product (matrix3, vector5, vector3);
   end = get_ticks ();
-  product (matrix3, vector5, vector4);
-  timeInfo(&start, &end, PRODUCT);
-  print_vector<real> (vector4);
+  record (CHAIN_PRODUCT_SOR, start, end);
+  print_vector<real> (vector3);
+  checkpoint (CHAIN_PRODUCT_SOR, vector3, n, 1);
 
   // clean up
-  delete [] matrix3;
-  delete [] vector5;
+  chainDelete(matrix3);
+  chainDelete(vector5);
 
   // STEP 13: vecdiff
 
   // execute
+  start = startKernel ();
+  real maxDiff = vecdiff (vector6, vector3);
   end = get_ticks ();
-#ifdef OUTPUT_DATA
-  real maxDiff = vecdiff (vector3, vector4);
-#else
-  vecdiff (vector3, vector4);
-#endif
-  timeInfo(&start, &end, VECDIFF);
+  record (VECDIFF, start, end);
 #ifdef OUTPUT_DATA
   std::cout << maxDiff;
 #endif
+  checkpoint (VECDIFF, &maxDiff, 1, 1);
 
   // clean up
-  delete [] vector3;
-  delete [] vector4;
+  chainDelete(vector3);
+  chainDelete(vector6);
+}
+
+
+void Cowichan::planChain()
+{
+  try {
+    chainPlan = new MemoryPlan();
+  }
+  catch (...) {out_of_memory();}
+
+  size_t rect = (size_t)nr * nc;
+  size_t square = (size_t)n * n;
+
+  // sizes and live steps of the buffers, as used by chain, in ChainBuffer
+  // order; the fused chain has no matrix1 or mask2, and mask1 only for
+  // invperc
+  size_t unfused = chainFusion ? 0 : 1;
+  size_t unpacked = (chainFusion && useThresh) ? 0 : 1;
+  chainPlan->add (unfused * rect * sizeof(INT_TYPE), 1, 2);  // matrix1
+  chainPlan->add (rect * sizeof(INT_TYPE), 2, 5);            // matrix2
+  chainPlan->add (unpacked * rect * sizeof(bool), 3, 4);     // mask1
+  chainPlan->add (unfused * rect * sizeof(bool), 4, 5);      // mask2
+  chainPlan->add (n * sizeof(Point), 5, 8);        // vector1
+  chainPlan->add (n * sizeof(Point), 6, 7);        // vector2
+  chainPlan->add (square * sizeof(real), 8, 12);   // matrix3
+  chainPlan->add (n * sizeof(real), 8, 13);        // vector3
+  // steps 9 to 12 all overlap when the branches run concurrently; gauss
+  // works on the copies matrix4 and vector6 either way
+  chainPlan->add (n * sizeof(real), 9, chainDag ? 12 : 11);  // vector4
+  chainPlan->add (n * sizeof(real), chainDag ? 9 : 10, 12);  // vector5
+  chainPlan->add (square * sizeof(real), 9, chainDag ? 12 : 9);  // matrix4
+  chainPlan->add (n * sizeof(real), 9, 13);                  // vector6
+  chainPlan->plan ();
+
+  // spread the arena over nr rows so that firstTouch places it like the
+  // rectangular matrices that take up most of it
+  size_t rowBytes = (chainPlan->size () + nr - 1) / nr;
+  rowBytes = (rowBytes + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+
+  try {
+    chainMemory = (char*) memory_alloc (nr * rowBytes);
+  }
+  catch (...) {out_of_memory();}
+
+  firstTouch (chainMemory, nr, rowBytes);
+  memory_prefault (chainMemory, nr * rowBytes);
 }
 
+void Cowichan::freeChain()
+{
+  memory_free (chainMemory);
+  chainMemory = NULL;
+  delete chainPlan;
+  chainPlan = NULL;
+}
+
+MatrixFileWriter* Cowichan::openCheckpoint(const char* step,
+    MatrixFileType type, size_t elementSize, index_t rows, index_t cols)
+{
+  if (checkpointDir.empty ()) {
+    return NULL;
+  }
+
+  std::ostringstream path;
+  path << checkpointDir << "/" << std::setw (2) << std::setfill ('0')
+      << ++checkpointCount << "-" << step << MATRIX_FILE_EXTENSION;
+
+  MatrixFileWriter* writer = NULL;
+  try {
+    writer = new MatrixFileWriter(path.str ().c_str (), type, elementSize,
+        rows, cols);
+  }
+  catch (...) {out_of_memory();}
+
+  return writer;
+}
+
+void Cowichan::checkpoint(const char* step, const BitMatrix& mask)
+{
+  MatrixFileWriter* writer = openCheckpoint(step, MATRIX_FILE_BOOL,
+      sizeof(bool), mask.rows (), mask.cols ());
+  if (writer != NULL) {
+    writer->writeBits (mask.row (0), mask.rows ());
+    delete writer;
+  }
+}
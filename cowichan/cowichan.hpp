@@ -11,9 +11,9 @@
  *
  * Currently, there are 14 Cowichan problems. They are described below.
  * Cowichan class. Problems can be run separately by
- * passing the problem name as an argument on the command line. The inputs to
- * the problems are defined in cowichan_defaults.hpp. There is currently no way
- * to override the inputs without recompiling.
+ * passing the problem name as an argument on the command line. The default
+ * inputs to the problems are defined in cowichan_defaults.hpp; they can be
+ * overridden at run time (see \ref config_sec).
  *
  * \subsection mandel_sec 1. Mandelbrot Set Generation
  * This module generates the Mandelbrot Set for a specified region of the
@@ -131,6 +131,39 @@
  * case the vectors are actual and computed values of some calculation the
  * result represents the magnitude of the error.
  * \see Cowichan::vecdiff
+ *
+ * \section benchmark_sec Benchmarking
+ * Kernels are timed with a monotonic clock (see get_ticks). Each kernel (or
+ * the whole chain) is run <tt>--warmup W</tt> times without recording, then
+ * <tt>--repeat R</tt> times with recording; inputs are re-initialized before
+ * every run and only the kernel itself is timed. The report gives min, median,
+ * 95th percentile and standard deviation per kernel as text, or as
+ * <tt>--format json</tt> / <tt>--format csv</tt>, printed on std::cout or
+ * written to <tt>--output FILE</tt>. For example:
+ * <pre>cowichan_serial mandel --warmup 1 --repeat 10 --format csv --output mandel.csv</pre>
+ * \see BenchmarkSuite
+ *
+ * \section config_sec Configuration
+ * Every problem parameter can be set on the command line as
+ * <tt>--name value</tt>, or in a file given with <tt>--config FILE</tt> that
+ * holds one <tt>name = value</tt> pair per line (<tt>#</tt> starts a comment).
+ * Settings are applied in order on top of the problem defaults, so later
+ * settings win. <tt>--help</tt> lists the names and their defaults.
+ *
+ * A sweep runs one problem over a grid of sizes and thread counts in one
+ * process: <tt>--sweep-sizes 256,512,1024</tt> sets nr, nc and n to each size
+ * in turn and <tt>--sweep-threads 1,2,4</tt> does the same for the number of
+ * threads. Every grid point gets its own warmup and repeat runs and its own
+ * line in the report. For example:
+ * <pre>cowichan_openmp life --sweep-sizes 512,1024,2048,4096 --sweep-threads 1,2,4 --format csv</pre>
+ *
+ * Whenever a report holds a kernel both at 1 thread and at p threads, the
+ * p-thread line also gives the speedup S = T1 / Tp of the median times, the
+ * parallel efficiency S / p and the Karp-Flatt serial fraction
+ * (1/S - 1/p) / (1 - 1/p). <tt>--pin compact</tt> or <tt>--pin scatter</tt>
+ * pins thread i to one processor (see PinMode). <tt>test/scaling.sh</tt>
+ * runs every kernel and the chain at 1..P threads for several
+ * implementations and merges the reports into one comparison table.
  */
 
 /**
@@ -142,6 +175,7 @@
 #define __cowichan_hpp__
 
 #include "cowichan_defaults.hpp"
+#include "memory.hpp"
 
 // BASIC HEADERS ============================================================//
 #include <iostream>
@@ -154,6 +188,7 @@
 #include <limits>
 #include <string>
 #include <cstring>
+#include <vector>
 using std::numeric_limits;
 
 // TIMING ===================================================================//
@@ -177,7 +212,8 @@ using std::numeric_limits;
 
 #else                // Linux
 
-#include <sys/times.h>
+#include <time.h>
+#include <unistd.h>
 #include <stdint.h>
 #include <string.h>
 /**
@@ -203,14 +239,15 @@ typedef int32_t INT32;
 #endif
 
 /**
- * Get tick count.
+ * Get tick count from a monotonic clock (CLOCK_MONOTONIC on Linux,
+ * QueryPerformanceCounter on Windows).
  * \return Tick count.
  */
 INT64 get_ticks ();
 
 /**
  * Get tick frequency.
- * \return Tick frequency.
+ * \return Tick frequency (1e9 on Linux, where ticks are nanoseconds).
  */
 INT64 get_freq ();
 
@@ -221,14 +258,6 @@ INT64 get_freq ();
  */
 void print_elapsed_time (INT64 start, INT64 end);
 
-/**
- * Does a sort of swap-out, printing progress.
- * \param start pointer to initial tick count.
- * \param end pointeger to final tick count.
- * \param message message to print before the elapsed time.
- */
-void timeInfo(INT64 *start, INT64 *end, std::string message);
-
 // DEBUGGING FUNCTIONS ======================================================//
 
 /**
@@ -258,6 +287,13 @@ void not_enough_points();
  */
 void no_cells_alive();
 
+/**
+ * Prints bad command line argument message and exits.
+ * \param message what is wrong with the argument.
+ * \param arg the argument.
+ */
+void bad_argument(const char* message, const char* arg);
+
 // BASIC TYPES ==============================================================//
 #ifndef REAL_TYPE
 /**
@@ -455,21 +491,28 @@ public:
   WeightedPoint(real x, real y, INT_TYPE weight): point(x, y), weight(weight) { }  
 
   /**
-   * Less than comparison by weight.
+   * Less than comparison by weight, then by row (y) and column (x), so that
+   * every sort puts equal weights in row-major order.
    * \param rhs right hand side weighted point.
    * \return Whether lhs < rhs.
    */
   inline bool operator<(const WeightedPoint& rhs) const {
-    return (weight < rhs.weight);
+    if (weight != rhs.weight) {
+      return (weight < rhs.weight);
+    }
+    if (point.y != rhs.point.y) {
+      return (point.y < rhs.point.y);
+    }
+    return (point.x < rhs.point.x);
   }
 
   /**
-   * Less than or equal comparison by weight.
+   * Less than or equal comparison, in the order of operator<.
    * \param rhs right hand side weighted point.
    * \return Whether lhs <= rhs.
    */
   inline bool operator<=(const WeightedPoint& rhs) const {
-    return (weight <= rhs.weight);
+    return !(rhs < *this);
   }
 
 };
@@ -481,6 +524,22 @@ typedef WeightedPoint* WeightedPointVector;
 
 // UTILITY FUNCTIONS ========================================================//
 
+#include "matrix_view.hpp"
+#include "bit_matrix.hpp"
+#include "memory_plan.hpp"
+#include "scratch.hpp"
+#include "matrix_file.hpp"
+#include "perf_counters.hpp"
+#include "affinity.hpp"
+#include "counter_rng.hpp"
+#include "randmat_lcg.hpp"
+#include "half_kernel.hpp"
+#include "invperc_queue.hpp"
+#include "invperc_batch.hpp"
+#include "mandel_kernel.hpp"
+#include "thresh_kernel.hpp"
+#include "mandel_cache.hpp"
+
 /**
  * Access a rectangular matrix at row/col from a class using member variable nc
  * as the number of columns.
@@ -527,35 +586,91 @@ typedef WeightedPoint* WeightedPointVector;
 /**
  * Allocate a new rectangular matrix from a class using member variable nr as
  * the number of rows and member variable nc as the number of columns.
+ * Rows are first touched by the threads that will process them.
  */
-#define NEW_MATRIX_RECT(__type) (new __type[this->nr * this->nc])
+#define NEW_MATRIX_RECT(__type) (this->newArray<__type>(this->nr, this->nc))
 
 /**
  * Allocate a new square matrix from a class using member variable n as the
- * matrix size.
+ * matrix size. Rows are first touched by the threads that will process them.
  */
-#define NEW_MATRIX_SQUARE(__type) (new __type[this->n * this->n])
+#define NEW_MATRIX_SQUARE(__type) (this->newArray<__type>(this->n, this->n))
 
 /**
- * Allocate a new vector of size __num.
+ * Allocate a new cache-line aligned vector of size __num.
  */
-#define NEW_VECTOR_SZ(__type,__num) (new __type[__num])
+#define NEW_VECTOR_SZ(__type,__num) (memory_new<__type>(__num))
 
 /**
  * Allocate a new vector from a class using member variable n as the size of
  * the vector.
  */
-#define NEW_VECTOR(__type) NEW_VECTOR_SZ(__type, this->n)
+#define NEW_VECTOR(__type) (this->newArray<__type>(this->n, 1))
+
+/**
+ * Free a matrix or vector allocated with one of the NEW_ macros.
+ */
+#define DELETE_ARRAY(__array) (memory_delete(__array))
 
 /**
- * Returns a pseudorandom number ~ U[mean - range, mean + range].
- * \param mean mean.
- * \param range range.
- * \return The pseudorandom number.
+ * Position that row (or column) i of a matrix is moved to by half.
+ * \param i row (or column) before half.
+ * \param middle (rows + 1) / 2 (or (columns + 1) / 2).
+ * \return Row (or column) after half.
  */
-real uniform(real mean, real range);
+inline index_t half_position(index_t i, index_t middle)
+{
+  return (i % 2 == 0) ? i / 2 : middle + i / 2;
+}
+
+/**
+ * Row (or column) that half moves to position i (inverse of half_position).
+ * \param i row (or column) after half.
+ * \param middle (rows + 1) / 2 (or (columns + 1) / 2).
+ * \return Row (or column) before half.
+ */
+inline index_t half_source(index_t i, index_t middle)
+{
+  return (i < middle) ? i * 2 : (i - middle) * 2 + 1;
+}
 
 // COWICHAN DEFINITIONS =====================================================//
+class BenchmarkSuite;
+
+/**
+ * \brief Work on independent rows, run by Cowichan::parallelRows.
+ */
+class RowTask {
+public:
+
+  virtual ~RowTask() { }
+
+  /**
+   * Process rows [first, last).
+   * \param first first row.
+   * \param last one past the last row.
+   * \return A count to be summed over all rows (0 if not needed).
+   */
+  virtual index_t run(index_t first, index_t last) = 0;
+
+};
+
+/**
+ * \brief A sequence of chain steps that does not depend on another, run by
+ * Cowichan::runBranches.
+ */
+class ChainBranch {
+public:
+
+  virtual ~ChainBranch() { }
+
+  /**
+   * Run the steps.
+   */
+  virtual void run() = 0;
+
+};
+
 /**
  * \brief Base class for all C++ implementations.
  *
@@ -642,6 +757,28 @@ protected:
    */
   static const char* VECDIFF;
 
+  /**
+   * Name for fused randmat and half.
+   */
+  static const char* RANDMAT_HALF;
+
+  /**
+   * Name for fused mandel and half.
+   */
+  static const char* MANDEL_HALF;
+
+  /**
+   * Name for the gauss and sor branches of the chain run concurrently.
+   */
+  static const char* CHAIN_BRANCHES;
+
+  /**
+   * Names for the products of the chain, after gauss and after sor (one
+   * record per step, not two runs of product).
+   */
+  static const char* CHAIN_PRODUCT_GAUSS;
+  static const char* CHAIN_PRODUCT_SOR;
+
 protected:
 
   /**
@@ -694,11 +831,199 @@ protected:
    */
   index_t invpercNFill;
 
+  /**
+   * Priority queue of invperc_fill.
+   */
+  InvpercQueue invpercQueue;
+
   /**
    * Seed value for simple random number generator.
    */
   INT_TYPE seed;
 
+  /**
+   * Maximum number of iterations per mandelbrot point.
+   */
+  index_t mandelMaxIter;
+
+  /**
+   * Squared magnitude at which a mandelbrot point is considered divergent.
+   */
+  real mandelInfinity;
+
+  /**
+   * Compute mandel by rectangle subdivision (if true) or point by point (if
+   * false), see mandelRectangles.
+   */
+  bool mandelSubdivide;
+
+  /**
+   * Rows and columns per tile, in implementations that hand out mandel in
+   * tiles (0 for the whole extent: 1 and 0 give one row at a time).
+   */
+  index_t mandelTileRows, mandelTileCols;
+
+  /**
+   * Bytes of mandel tiles kept between calls (0 for none), see mandelCached.
+   */
+  size_t mandelCacheBytes;
+
+  /**
+   * Rows and columns by which the mandel problem moves its viewport every
+   * run, to time the cache on a pan.
+   */
+  index_t mandelPanRows, mandelPanCols;
+
+  /**
+   * Position of the mandel viewport, in steps from (mandelX0, mandelY0):
+   * matrix cell (r, c) is lattice point (mandelRow0 + r, mandelCol0 + c),
+   * see mandel_coordinate. The pan moves these rather than the corner.
+   */
+  index_t mandelRow0, mandelCol0;
+
+  /**
+   * Relaxation factor for sor (double, as sor does its update in double).
+   */
+  double sorOmega;
+
+  /**
+   * Largest change in the solution at which sor stops.
+   */
+  double sorTolerance;
+
+  /**
+   * Maximum number of sor iterations.
+   */
+  index_t sorMaxIters;
+
+  /**
+   * Number of threads (or worker processes) to use.
+   */
+  index_t threads;
+
+private:
+
+  /**
+   * Timing results.
+   */
+  BenchmarkSuite* benchmarks;
+
+  /**
+   * Hardware counters, or NULL when not counting.
+   */
+  PerfCounters* counters;
+
+  /**
+   * Counter values at the start of the kernels being timed, innermost last
+   * (the chain times its steps inside its own run).
+   */
+  std::vector<PerfSample> counterStarts;
+
+  /**
+   * Current run number (warmup runs first).
+   */
+  index_t benchmarkRun;
+
+  /**
+   * In chain step 1 use: randmat (if true) or mandel (if false).
+   */
+  bool useRandmat;
+
+  /**
+   * In chain step 3 use: thresh (if true) or invperc (if false).
+   */
+  bool useThresh;
+
+  /**
+   * Run the chain from a planned arena (if true) or allocate every buffer when
+   * it is first needed (if false).
+   */
+  bool chainArena;
+
+  /**
+   * Run the fused chain (if true), see chainPointsFused.
+   */
+  bool chainFusion;
+
+  /**
+   * Run the gauss and sor branches of the chain concurrently (if true), see
+   * chainSolveConcurrent.
+   */
+  bool chainDag;
+
+  /**
+   * Run chain steps 1 to 5 out of core (if true), see chainPointsStream.
+   */
+  bool chainStream;
+
+  /**
+   * Run chain steps 1 to 5 without storing the randmat matrix (if true), see
+   * chainPointsLazy.
+   */
+  bool chainLazy;
+
+  /**
+   * Bytes of matrix rows the streaming chain may map at once.
+   */
+  size_t streamBudget;
+
+  /**
+   * Directory for the scratch files of the streaming chain.
+   */
+  std::string scratchDir;
+
+  /**
+   * Directory the chain writes its outputs to as matrix files, or empty for
+   * no checkpoints.
+   */
+  std::string checkpointDir;
+
+  /**
+   * Number of checkpoints written by the current chain run.
+   */
+  index_t checkpointCount;
+
+  /**
+   * Placement of the chain buffers in chainMemory.
+   */
+  MemoryPlan* chainPlan;
+
+  /**
+   * Arena holding all chain buffers, or NULL when not running from an arena.
+   */
+  char* chainMemory;
+
+  /**
+   * Tiles of earlier mandel calls, or NULL before the first cached call.
+   */
+  MandelCache* mandelCache;
+
+  /**
+   * \brief Buffers used by the chain, in the order they are added to
+   * chainPlan.
+   */
+  enum ChainBuffer {
+    CHAIN_MATRIX1, CHAIN_MATRIX2, CHAIN_MASK1, CHAIN_MASK2, CHAIN_VECTOR1,
+    CHAIN_VECTOR2, CHAIN_MATRIX3, CHAIN_VECTOR3, CHAIN_VECTOR4, CHAIN_VECTOR5,
+    CHAIN_MATRIX4, CHAIN_VECTOR6
+  };
+
+  /**
+   * Branches of chainSolveConcurrent (see chain_dag.cpp).
+   */
+  class GaussBranch;
+  class SorBranch;
+
+  /**
+   * Sizes to sweep over (empty for no sweep).
+   */
+  std::vector<index_t> sweepSizes;
+
+  /**
+   * Thread counts to sweep over (empty for no sweep).
+   */
+  std::vector<index_t> sweepThreads;
+
 protected: // individual problems
 
   /**
@@ -802,8 +1127,290 @@ protected: // individual problems
    */
   virtual real vecdiff(Vector actual, Vector computed) = 0;
 
+protected: // fused problems for the chain
+
+  /**
+   * Cowichan::randmat followed by Cowichan::half, without the intermediate
+   * matrix. The default implementation runs both through a temporary.
+   * \param matrix shuffled random matrix.
+   */
+  virtual void randmatHalf(IntMatrix matrix);
+
+  /**
+   * Cowichan::mandel followed by Cowichan::half, without the intermediate
+   * matrix. The default implementation runs both through a temporary.
+   * \param matrix shuffled mandelbrot matrix.
+   */
+  virtual void mandelHalf(IntMatrix matrix);
+
+  /**
+   * Cowichan::thresh writing a packed mask. The default implementation
+   * packs the result of thresh.
+   * \param matrix image.
+   * \param mask image after thresholding.
+   */
+  virtual void threshBits(IntMatrix matrix, BitMatrix& mask);
+
+  /**
+   * Cowichan::life on a packed world. The default implementation unpacks
+   * the world and runs life.
+   * \param world initial world, replaced by the final world.
+   */
+  virtual void lifeBits(BitMatrix& world);
+
+  /**
+   * Cowichan::winnow with a packed mask. The default implementation unpacks
+   * the mask and runs winnow.
+   * \param matrix integer matrix.
+   * \param mask packed boolean matrix.
+   * \param points evenly selected points.
+   */
+  virtual void winnowBits(IntMatrix matrix, const BitMatrix& mask,
+      PointVector points);
+
+protected:
+
+  /**
+   * Sets the number of threads (or worker processes) used by the following
+   * problems. The default implementation is for serial implementations.
+   * \param threads requested number of threads.
+   * \return Number of threads that will actually be used.
+   */
+  virtual index_t setNumThreads(index_t threads);
+
+  /**
+   * Pins the threads (or worker processes) set up by setNumThreads to
+   * processors in the current pin mode (see affinity_pin), or unpins them
+   * with PIN_NONE. The default implementation pins the calling thread to
+   * slot 0.
+   */
+  virtual void pinThreads();
+
+  /**
+   * Touches freshly allocated memory so that each row is placed in the memory
+   * of the thread that will process it. The default implementation leaves the
+   * memory untouched (serial implementations place it on first write).
+   * \param array memory for rows * rowBytes bytes.
+   * \param rows number of rows.
+   * \param rowBytes size of a row in bytes.
+   */
+  virtual void firstTouch(void* array, index_t rows, size_t rowBytes);
+
+  /**
+   * Runs a task over rows [0, rows), possibly in parallel. Rows may be handed
+   * to task.run in any order and grouping. The default implementation runs
+   * all rows at once.
+   * \param rows number of rows.
+   * \param task the task.
+   * \return Sum of the results of task.run.
+   */
+  virtual index_t parallelRows(index_t rows, RowTask& task);
+
+  /**
+   * Runs two independent branches, possibly at the same time on disjoint
+   * sets of threads. The default implementation runs first, then second.
+   * \param first the first branch.
+   * \param second the second branch.
+   * \param firstThreads threads for the first branch; the second gets the
+   * rest.
+   */
+  virtual void runBranches(ChainBranch& first, ChainBranch& second,
+      index_t firstThreads);
+
+  /**
+   * Fill an integer matrix or vector with numbers in [0, RAND_M), element i
+   * (row-major) being element i of the counter_rng sequence of the seed and
+   * stream. Runs through parallelRows, so the contents do not depend on the
+   * implementation or the number of threads.
+   * \param array the matrix or vector.
+   * \param rows number of rows.
+   * \param cols number of columns (1 for a vector).
+   * \param stream input of the problem, to make different inputs independent.
+   */
+  void randomInts(INT_TYPE* array, index_t rows, index_t cols, UINT64 stream);
+
+  /**
+   * Fill a boolean matrix or vector with random values, like randomInts.
+   * \param array the matrix or vector.
+   * \param rows number of rows.
+   * \param cols number of columns (1 for a vector).
+   * \param stream input of the problem.
+   */
+  void randomBools(bool* array, index_t rows, index_t cols, UINT64 stream);
+
+  /**
+   * Fill a real matrix or vector with numbers ~ U[RAND_MEAN - RAND_RANGE,
+   * RAND_MEAN + RAND_RANGE), like randomInts.
+   * \param array the matrix or vector.
+   * \param rows number of rows.
+   * \param cols number of columns (1 for a vector).
+   * \param stream input of the problem.
+   */
+  void randomReals(real* array, index_t rows, index_t cols, UINT64 stream);
+
+  /**
+   * Fill a point vector with random coordinates, like randomReals; point i
+   * takes elements 2i and 2i + 1.
+   * \param points the points.
+   * \param count number of points.
+   * \param stream input of the problem.
+   */
+  void randomPoints(PointVector points, index_t count, UINT64 stream);
+
+  /**
+   * Fill a square matrix (size n) with random symmetric values, like
+   * randomReals, and a diagonal of n * (|RAND_MEAN| + RAND_RANGE), which makes
+   * it diagonally dominant.
+   * \param matrix the matrix.
+   * \param stream input of the problem.
+   */
+  void randomSymmetric(Matrix matrix, UINT64 stream);
+
+  /**
+   * Computes mandel by subdividing tiles of the matrix into rectangles and
+   * filling those whose border has a single value (see mandel_subdivide.cpp).
+   * Tiles run through parallelRows. Points in the main cardioid and the
+   * period-2 bulb are not iterated.
+   * \param matrix the mandelbrot matrix.
+   */
+  void mandelRectangles(IntMatrix matrix);
+
+  /**
+   * Computes mandel from tiles of earlier calls where the viewports overlap,
+   * and only the missing tiles (see mandel_cache.cpp). Tiles hold lattice
+   * points computed with mandel_coordinate from the same origin as every
+   * other mandel, so the matrix is bit-identical to that of Cowichan::mandel.
+   * \param matrix the mandelbrot matrix.
+   */
+  void mandelCached(IntMatrix matrix);
+
+  /**
+   * Cowichan::mandel, Cowichan::mandelCached or Cowichan::mandelRectangles,
+   * as chosen by mandelCacheBytes and mandelSubdivide (the cache first).
+   * \param matrix the mandelbrot matrix.
+   */
+  void computeMandel(IntMatrix matrix);
+
+  /**
+   * View a rectangular matrix using member variables nr and nc.
+   * \param matrix the matrix.
+   * \return The view.
+   */
+  template <typename T>
+  MatrixView<T> rectView(T* matrix) const
+  {
+    return MatrixView<T>(matrix, nr, nc);
+  }
+
+  /**
+   * View a square matrix using member variable n.
+   * \param matrix the matrix.
+   * \return The view.
+   */
+  template <typename T>
+  MatrixView<T> squareView(T* matrix) const
+  {
+    return MatrixView<T>(matrix, n, n);
+  }
+
+  /**
+   * Allocate an aligned rows * cols array, first touch it with firstTouch and
+   * default-construct its elements. Free it with DELETE_ARRAY.
+   * \param rows number of rows.
+   * \param cols number of columns.
+   * \return The array.
+   */
+  template <typename T>
+  T* newArray(index_t rows, index_t cols)
+  {
+    T* array = (T*) memory_alloc((size_t) rows * cols * sizeof(T));
+    firstTouch(array, rows, (size_t) cols * sizeof(T));
+    return memory_construct(array, (size_t) rows * cols);
+  }
+
 private:
 
+  /**
+   * Resets all parameters to their defaults from cowichan_defaults.hpp, using
+   * the problem-specific sizes.
+   * \param problem problem name (or CHAIN).
+   */
+  void setDefaults(const char* problem);
+
+  /**
+   * Sets a parameter.
+   * \param name parameter name, as on the command line without the dashes.
+   * \param value parameter value.
+   * \return Whether name is a known parameter.
+   */
+  bool setOption(const std::string& name, const std::string& value);
+
+  /**
+   * Reads name = value pairs from a configuration file.
+   * \param filename file to read.
+   * \param settings list to append the pairs to.
+   */
+  void readConfig(const char* filename,
+      std::vector<std::pair<std::string, std::string> >& settings);
+
+  /**
+   * Prints the command line options and exits.
+   * \param program program name.
+   */
+  void usage(const char* program);
+
+  /**
+   * Runs a single problem, or the chain, warmup + repeat times.
+   * \param problem problem name (or CHAIN).
+   */
+  void run(const char* problem);
+
+  /**
+   * Starts timing a kernel run, reading the hardware counters if counting.
+   * Every call is matched by a call to record.
+   * \return Tick count before the kernel.
+   */
+  INT64 startKernel();
+
+  /**
+   * Records the time taken by one kernel run in benchmarks, along with the
+   * hardware counters since the matching startKernel.
+   * \param name kernel name.
+   * \param start tick count before the kernel.
+   * \param end tick count after the kernel.
+   */
+  void record(const char* name, INT64 start, INT64 end);
+
+  /**
+   * Records the time taken by one kernel run in benchmarks, without hardware
+   * counters (for kernels that overlap, whose counters cannot be split).
+   * \param name kernel name.
+   * \param start tick count before the kernel.
+   * \param end tick count after the kernel.
+   */
+  void recordTime(const char* name, INT64 start, INT64 end);
+
+  /**
+   * Sizes a kernel works on at the current problem size, as its benchmark
+   * reports them.
+   * \param name kernel name.
+   * \param rows rows of its rectangular matrix, or 0 if it has none.
+   * \param cols columns of its rectangular matrix, or 0 if it has none.
+   * \param size size of its points, vectors or square matrix, or 0 if it
+   * has none.
+   */
+  void kernelSizes(const char* name, index_t& rows, index_t& cols,
+      index_t& size) const;
+
+  /**
+   * Nominal number of floating point operations of one kernel run at the
+   * current problem size, for the bytes per flop ratio.
+   * \param name kernel name.
+   * \return Operations, or 0 if the kernel works on integers or its count
+   * depends on the data (sor, hull).
+   */
+  double kernelFlops(const char* name) const;
+
   /**
    * Runs the cowichan problem set, chained together.
    * The order in the chain is:
@@ -827,6 +1434,158 @@ private:
    */
   void chain(bool use_randmat, bool use_thresh);
 
+  /**
+   * Runs chain steps 1 to 5, from randmat or mandel to winnow.
+   * \param use_randmat in step 1 use: randmat (if true) or mandel (if false).
+   * \param use_thresh in step 3 use: thresh (if true) or invperc (if false).
+   * \param points points selected by winnow.
+   */
+  void chainPoints(bool use_randmat, bool use_thresh, PointVector points);
+
+  /**
+   * Runs chain steps 1 to 5 with fused problems: randmatHalf or mandelHalf
+   * write the shuffled matrix directly, and the masks stay packed from
+   * threshBits (or invperc) through lifeBits to winnowBits. The results are
+   * the same as those of chainPoints, but the matrix before half is never
+   * stored, so it is not printed.
+   * \param use_randmat in step 1 use: randmat (if true) or mandel (if false).
+   * \param use_thresh in step 3 use: thresh (if true) or invperc (if false).
+   * \param points points selected by winnow.
+   */
+  void chainPointsFused(bool use_randmat, bool use_thresh, PointVector points);
+
+  /**
+   * Runs chain steps 1 to 5 out of core, in bands of rows sized to fit in
+   * streamBudget. The matrix and the packed masks live in ScratchFile
+   * objects in scratchDir:
+   * <OL>
+   * <LI>randmat or mandel, written in half order, while the histogram for
+   * thresh is gathered.</LI>
+   * <LI>thresh, into a packed mask.</LI>
+   * <LI>life, one pass per generation, with one row of overlap.</LI>
+   * <LI>winnow, in two passes: the first counts the candidates of each
+   * weight, the second picks the selected ones, so the candidates are never
+   * stored or sorted.</LI>
+   * </OL>
+   * The results equal those of chainPointsFused on the serial
+   * implementation, except that winnow breaks ties between equal weights in
+   * row-major order. invperc grows its mask anywhere in the matrix and
+   * cannot be streamed.
+   * \param use_randmat in step 1 use: randmat (if true) or mandel (if false).
+   * \param use_thresh must be true.
+   * \param points points selected by winnow.
+   */
+  void chainPointsStream(bool use_randmat, bool use_thresh,
+      PointVector points);
+
+  /**
+   * Runs chain steps 1 to 5 without the randmat matrix: a RandmatHalfView
+   * generates its rows (or single elements) whenever a step reads them.
+   * <OL>
+   * <LI>randmatHalf only sets up the view.</LI>
+   * <LI>thresh generates every row twice, once for the histogram and once
+   * for the packed mask.</LI>
+   * <LI>life runs on the packed mask (lifeBits).</LI>
+   * <LI>winnow looks up the value of each set cell, in two passes as in
+   * chainPointsStream.</LI>
+   * </OL>
+   * The results equal those of chainPointsStream.
+   * \param use_randmat must be true.
+   * \param use_thresh must be true.
+   * \param points points selected by winnow.
+   */
+  void chainPointsLazy(bool use_randmat, bool use_thresh, PointVector points);
+
+  /**
+   * Runs chain steps 9 to 13 as a dependency graph: gauss and its product
+   * form one branch, sor and its product the other, and runBranches runs the
+   * two concurrently before vecdiff joins them. gauss eliminates in place,
+   * so it works on copies of matrix3 and vector3 (matrix4 and vector6); sor
+   * and both products use the original system, as in the sequential chain,
+   * so the results are the same.
+   * \param matrix3 matrix from outer (freed here).
+   * \param vector3 vector from outer (freed here).
+   */
+  void chainSolveConcurrent(Matrix matrix3, Vector vector3);
+
+  /**
+   * Plans the lifetimes of the chain buffers and allocates chainMemory, first
+   * touched with firstTouch and pre-faulted.
+   */
+  void planChain();
+
+  /**
+   * Frees chainMemory and chainPlan.
+   */
+  void freeChain();
+
+  /**
+   * Get a chain buffer: its place in chainMemory when running from the
+   * arena, otherwise a new array. Free it with chainDelete.
+   * \param buffer which buffer.
+   * \param rows number of rows.
+   * \param cols number of columns.
+   * \return The buffer.
+   */
+  template <typename T>
+  T* chainNew(ChainBuffer buffer, index_t rows, index_t cols)
+  {
+    if (chainMemory != NULL) {
+      return (T*)(chainMemory + chainPlan->offset(buffer));
+    }
+    return newArray<T>(rows, cols);
+  }
+
+  /**
+   * Release a buffer returned by chainNew.
+   * \param array the buffer.
+   */
+  template <typename T>
+  void chainDelete(T* array)
+  {
+    if (chainMemory == NULL) {
+      DELETE_ARRAY(array);
+    }
+  }
+
+  /**
+   * Create the matrix file for the next chain output, named after its
+   * position in the chain and its step, in checkpointDir.
+   * \param step step that produced the output.
+   * \param type element type.
+   * \param elementSize size of an element in bytes.
+   * \param rows number of rows.
+   * \param cols number of columns.
+   * \return The writer (to be deleted), or NULL when not checkpointing.
+   */
+  MatrixFileWriter* openCheckpoint(const char* step, MatrixFileType type,
+      size_t elementSize, index_t rows, index_t cols);
+
+  /**
+   * Write a chain output to its matrix file, if checkpointing.
+   * \param step step that produced the output.
+   * \param data the output.
+   * \param rows number of rows.
+   * \param cols number of columns.
+   */
+  template <typename T>
+  void checkpoint(const char* step, const T* data, index_t rows, index_t cols)
+  {
+    MatrixFileWriter* writer = openCheckpoint(step, matrix_file_type(data),
+        sizeof(T), rows, cols);
+    if (writer != NULL) {
+      writer->write(data, rows);
+      delete writer;
+    }
+  }
+
+  /**
+   * Write a packed mask to its matrix file (as bool), if checkpointing.
+   * \param step step that produced the mask.
+   * \param mask the mask.
+   */
+  void checkpoint(const char* step, const BitMatrix& mask);
+
 public:
 
   /**
@@ -858,6 +1617,13 @@ public:
    */
   void print_bool_rect_matrix(BoolMatrix matrix);
 
+  /**
+   * DEBUGGING FUNCTION: Print a packed rectangular boolean matrix on
+   * std::cout.
+   * \param matrix matrix to print.
+   */
+  void print_bool_rect_matrix(const BitMatrix& matrix);
+
   /**
    * DEBUGGING FUNCTION: Print a square matrix on std::cout.
    * \param matrix matrix to print.
@@ -909,14 +1675,22 @@ public:
 
 public:
 
+  Cowichan();
+
+  virtual ~Cowichan();
+
   /**
    * Runs cowichan problems based on command line input. Problem name can be
    * specified on the command line. Otherwise, the chained version is run.
+   * Benchmark options (see \ref benchmark_sec) and parameters (see
+   * \ref config_sec) may follow.
    * \see Cowichan::chain
    * \param argc number of command line arguments.
    * \param argv command line arguments.
-   * \param use_randmat passed to chain if chained version is used.
-   * \param use_thresh passed to chain if chained version is used.
+   * \param use_randmat passed to chain if chained version is used (default
+   * for the chain-source parameter).
+   * \param use_thresh passed to chain if chained version is used (default
+   * for the chain-mask parameter).
    */
   void main(int argc, char* argv[], bool use_randmat, bool use_thresh);
 
@@ -41,6 +41,22 @@
  */
 #define RAND_M 56197
 
+/**
+ * Default number of threads (or worker processes) for parallel
+ * implementations.
+ */
+#define NUM_THREADS 2
+
+/**
+ * Default huge page mode for large matrices (see HugePageMode).
+ */
+#define HUGE_PAGES HUGE_PAGES_THP
+
+/**
+ * Default placement of threads on processors (see PinMode).
+ */
+#define PIN_THREADS PIN_NONE
+
 // mandel
 /**
  * Default number of rows for mandel.
@@ -82,6 +98,43 @@
  */
 #define MANDEL_MAX_ITER 150
 
+/**
+ * Default mandel mode: rectangle subdivision (true) or every point (false).
+ */
+#define MANDEL_SUBDIVIDE false
+
+/**
+ * Side of the square tiles that mandel subdivision hands out as tasks.
+ */
+#define MANDEL_SUBDIVIDE_TILE 64
+
+/**
+ * Default rows per mandel tile, where tiles are handed out to threads
+ * (0 for all rows).
+ */
+#define MANDEL_TILE_ROWS 16
+
+/**
+ * Default columns per mandel tile (0 for all columns).
+ */
+#define MANDEL_TILE_COLS 128
+
+/**
+ * Default bytes of mandel tiles kept between calls (0 for no cache).
+ */
+#define MANDEL_CACHE 0
+
+/**
+ * Side of the square tiles of the mandel cache.
+ */
+#define MANDEL_CACHE_TILE 64
+
+/**
+ * Interior points below which mandel subdivision stops splitting a
+ * rectangle and computes every point.
+ */
+#define MANDEL_MIN_RECTANGLE 64
+
 // randmat
 /**
  * Default number of rows for randmat.
@@ -114,6 +167,13 @@
  */
 #define HALF_NC ALL_NC
 
+/**
+ * Matrix bytes from which half writes its output with streaming stores,
+ * which bypass the cache (an output that fits stays cached for the next
+ * problem).
+ */
+#define HALF_STREAM_BYTES (32 << 20)
+
 // invperc
 /**
  * Default number of rows for invperc.
@@ -130,6 +190,40 @@
  */
 #define INVPERC_NFILL 1000000
 
+/**
+ * Default invperc queue: INVPERC_BUCKETS or INVPERC_HEAP.
+ */
+#define INVPERC_QUEUE INVPERC_BUCKETS
+
+/**
+ * Values from this one on have no bucket in InvpercBuckets: invperc fills
+ * the rest of the cells with InvpercHeap when it meets one.
+ */
+#define INVPERC_BUCKETS_MAX (1 << 20)
+
+/**
+ * Parts per thread of a parallel invperc flood (see InvpercBatch).
+ */
+#define INVPERC_PARTS 4
+
+/**
+ * Most cells of a parallel invperc flood at the lowest frontier value (see
+ * InvpercBatch).
+ */
+#define INVPERC_FLOOD 65536
+
+/**
+ * Most cells of a parallel invperc flood above the lowest frontier value,
+ * which is more likely not to fit.
+ */
+#define INVPERC_GUESS 1024
+
+/**
+ * Cells a part of a parallel invperc flood claims between checks that the
+ * flood still fits.
+ */
+#define INVPERC_CLAIMS 64
+
 // thresh
 /**
  * Default number of rows for thresh.
@@ -146,6 +240,17 @@
  */
 #define THRESH_PERCENT 0.5
 
+/**
+ * Bins a thresh histogram starts with (a power of two); they double past the
+ * largest value.
+ */
+#define THRESH_BINS 256
+
+/**
+ * Bins each thread merges at a time, from the histograms of all threads.
+ */
+#define THRESH_MERGE_BINS 1024
+
 // life
 /**
  * Default number of rows for life.
@@ -251,5 +356,55 @@
  */
 #define CHAIN_N ALL_N
 
-#endif
+/**
+ * Default chain memory mode: run from one planned arena (true) or allocate
+ * every buffer when it is first needed (false).
+ */
+#define CHAIN_ARENA false
+
+/**
+ * Default chain fusion: run fused problems (true) or one problem per step
+ * (false).
+ */
+#define CHAIN_FUSION false
+
+/**
+ * Default chain scheduling: run the gauss and sor branches concurrently
+ * (true) or one step after another (false).
+ */
+#define CHAIN_DAG false
+
+/**
+ * Percentage of the threads given to the sor branch when the chain runs its
+ * branches concurrently (at least one thread).
+ */
+#define CHAIN_DAG_SOR_SHARE 25
+
+/**
+ * Default bytes of matrix rows the streaming chain may map at once.
+ */
+#define STREAM_BUDGET (256 << 20)
+
+/**
+ * Default directory for the scratch files of the streaming chain.
+ */
+#define SCRATCH_DIR "/tmp"
 
+// benchmark
+/**
+ * Default number of unrecorded warmup runs per kernel.
+ */
+#define BENCHMARK_WARMUPS 0
+
+/**
+ * Default number of recorded runs per kernel.
+ */
+#define BENCHMARK_REPEATS 1
+
+/**
+ * Default hardware counters: read them around every kernel (true) or not
+ * (false).
+ */
+#define PERF_COUNTERS false
+
+#endif
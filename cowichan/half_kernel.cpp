@@ -0,0 +1,212 @@
+/**
+ * \file half_kernel.cpp
+ * \brief Implementation of the vectorized half shuffle.
+ *
+ * Every path loads the row unaligned and stores aligned, after storing the
+ * first elements one at a time, so that streaming stores can be used.
+ */
+
+#include "cowichan.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define HALF_SSE2
+#define HALF_AVX
+#include <immintrin.h>
+#define HALF_TARGET(__isa) __attribute__((target(__isa)))
+#elif defined(_M_X64)
+#define HALF_SSE2
+#include <emmintrin.h>
+#define HALF_TARGET(__isa)
+#endif
+
+/**
+ * \brief A vector path of half_split.
+ * \return Number of elements done, from out on.
+ */
+typedef index_t (*HalfVectors)(INT_TYPE* out, const INT_TYPE* in,
+    index_t count, index_t parity, bool stream);
+
+#ifdef HALF_AVX
+
+/**
+ * 16 elements per vector, picked from two with vpermt2d.
+ */
+HALF_TARGET("avx512f")
+static index_t half_vectors_avx512(INT_TYPE* out, const INT_TYPE* in,
+    index_t count, index_t parity, bool stream)
+{
+  const __m512i pick = _mm512_add_epi32(_mm512_setr_epi32(0, 2, 4, 6, 8, 10,
+      12, 14, 16, 18, 20, 22, 24, 26, 28, 30), _mm512_set1_epi32((int)parity));
+  index_t k;
+
+  for (k = 0; k + 16 <= count; k += 16) {
+    __m512i low = _mm512_loadu_si512((const void*)(in + 2 * k));
+    __m512i high = _mm512_loadu_si512((const void*)(in + 2 * k + 16));
+    __m512i v = _mm512_permutex2var_epi32(low, pick, high);
+    if (stream) {
+      _mm512_stream_si512((__m512i*)(out + k), v);
+    }
+    else {
+      _mm512_store_si512((void*)(out + k), v);
+    }
+  }
+  return k;
+}
+
+/**
+ * 8 elements per vector: each half of the pair is sorted into even and
+ * odd elements, then the halves wanted are joined.
+ */
+HALF_TARGET("avx2")
+static index_t half_vectors_avx2(INT_TYPE* out, const INT_TYPE* in,
+    index_t count, index_t parity, bool stream)
+{
+  const __m256i pick = (parity == 0)
+      ? _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7)
+      : _mm256_setr_epi32(1, 3, 5, 7, 0, 2, 4, 6);
+  index_t k;
+
+  for (k = 0; k + 8 <= count; k += 8) {
+    __m256i low = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256((const __m256i*)(in + 2 * k)), pick);
+    __m256i high = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256((const __m256i*)(in + 2 * k + 8)), pick);
+    __m256i v = _mm256_permute2x128_si256(low, high, 0x20);
+    if (stream) {
+      _mm256_stream_si256((__m256i*)(out + k), v);
+    }
+    else {
+      _mm256_store_si256((__m256i*)(out + k), v);
+    }
+  }
+  return k;
+}
+
+#endif
+
+#ifdef HALF_SSE2
+
+/**
+ * 4 elements per vector, picked from two with shufps.
+ */
+HALF_TARGET("sse2")
+static index_t half_vectors_sse2(INT_TYPE* out, const INT_TYPE* in,
+    index_t count, index_t parity, bool stream)
+{
+  index_t k;
+
+  for (k = 0; k + 4 <= count; k += 4) {
+    __m128 low = _mm_castsi128_ps(
+        _mm_loadu_si128((const __m128i*)(in + 2 * k)));
+    __m128 high = _mm_castsi128_ps(
+        _mm_loadu_si128((const __m128i*)(in + 2 * k + 4)));
+    __m128i v = _mm_castps_si128((parity == 0)
+        ? _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0))
+        : _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+    if (stream) {
+      _mm_stream_si128((__m128i*)(out + k), v);
+    }
+    else {
+      _mm_store_si128((__m128i*)(out + k), v);
+    }
+  }
+  return k;
+}
+
+#endif
+
+/**
+ * Choose the widest vector path the processor supports.
+ * \param width where to store its vector width, in elements.
+ * \return The path, or NULL for none.
+ */
+static HalfVectors half_choose(index_t& width)
+{
+#ifdef HALF_AVX
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    width = 16;
+    return half_vectors_avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    width = 8;
+    return half_vectors_avx2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    width = 4;
+    return half_vectors_sse2;
+  }
+#elif defined(HALF_SSE2)
+  width = 4;
+  return half_vectors_sse2;
+#endif
+  width = 1;
+  return NULL;
+}
+
+/**
+ * Vector width of halfVectors, in elements.
+ */
+static index_t halfWidth = 1;
+
+/**
+ * The vector path of half_split.
+ */
+static HalfVectors halfVectors = half_choose(halfWidth);
+
+void half_split(INT_TYPE* out, const INT_TYPE* in, index_t count,
+    index_t parity, bool stream)
+{
+  index_t k = 0;
+
+  if (halfVectors != NULL) {
+    // one at a time up to an aligned vector of out
+    size_t bytes = halfWidth * sizeof(INT_TYPE);
+    index_t head = (index_t)((bytes - ((size_t)out % bytes)) % bytes
+        / sizeof(INT_TYPE));
+    for (; (k < head) && (k < count); k++) {
+      out[k] = in[2 * k + parity];
+    }
+
+    // vectors load pairs of elements: the even elements of a row of odd
+    // length end with one that has no pair
+    index_t pairs = count - 1 + parity;
+    if (k < pairs) {
+      k += halfVectors(out + k, in + 2 * k, pairs - k, parity, stream);
+    }
+  }
+
+  for (; k < count; k++) {
+    out[k] = in[2 * k + parity];
+  }
+}
+
+void half_fence()
+{
+#ifdef HALF_SSE2
+  _mm_sfence();
+#endif
+}
+
+void half_pairs(const MatrixView<INT_TYPE>& in,
+    const MatrixView<INT_TYPE>& out, index_t first, index_t last)
+{
+  index_t nr = in.rows(), nc = in.cols();
+  index_t middle_r = (nr + 1) / 2;
+  index_t middle_c = (nc + 1) / 2;
+  bool stream = ((size_t)nr * nc * sizeof(INT_TYPE) >= HALF_STREAM_BYTES);
+
+  for (index_t i = first; i < last; i++) {
+    // even row i goes to the top half, odd row to the bottom half
+    for (index_t r = 2 * i; r < std::min(2 * i + 2, nr); r++) {
+      INT_TYPE* target = out.row(half_position(r, middle_r));
+      half_split(target, in.row(r), middle_c, 0, stream);
+      half_split(target + middle_c, in.row(r), nc / 2, 1, stream);
+    }
+  }
+
+  if (stream) {
+    half_fence();
+  }
+}
@@ -0,0 +1,39 @@
+/**
+ * \file half_kernel.hpp
+ * \brief The half shuffle shared by the serial, OpenMP and TBB
+ * implementations, vectorized over the columns of a row.
+ */
+
+#ifndef __half_kernel_hpp__
+#define __half_kernel_hpp__
+
+/**
+ * Store every other element of a row: out[k] = in[2 k + parity]. Vectors
+ * of loaded elements are split into even and odd ones with a permutation.
+ * \param out where to store count elements.
+ * \param in the row, of at least 2 count - 1 + parity elements.
+ * \param count number of elements to store.
+ * \param parity 0 for the even elements, 1 for the odd ones.
+ * \param stream write out with streaming stores (call half_fence after).
+ */
+void half_split(INT_TYPE* out, const INT_TYPE* in, index_t count,
+    index_t parity, bool stream);
+
+/**
+ * Make the streaming stores of half_split visible to other threads.
+ */
+void half_fence();
+
+/**
+ * Shuffle pairs of rows [first, last): rows 2 i and 2 i + 1 of in, next to
+ * each other, become rows i and (rows + 1) / 2 + i of out, each split into
+ * its even and odd columns. Uses streaming stores from HALF_STREAM_BYTES.
+ * \param in matrix before half.
+ * \param out matrix after half.
+ * \param first first pair.
+ * \param last one past the last pair (at most (rows + 1) / 2).
+ */
+void half_pairs(const MatrixView<INT_TYPE>& in,
+    const MatrixView<INT_TYPE>& out, index_t first, index_t last);
+
+#endif
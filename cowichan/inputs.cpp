@@ -0,0 +1,181 @@
+/**
+ * \file inputs.cpp
+ * \brief Parallel generation of random problem inputs.
+ */
+
+#include "cowichan.hpp"
+
+namespace
+{
+
+/**
+ * Elements per task when filling flat arrays (vectors have a single row).
+ */
+const index_t INPUT_BLOCK = 4096;
+
+/**
+ * \param count number of elements.
+ * \return Number of blocks of INPUT_BLOCK elements.
+ */
+index_t input_blocks(index_t count)
+{
+  return (count + INPUT_BLOCK - 1) / INPUT_BLOCK;
+}
+
+/**
+ * \brief Maps random bits to integers in [0, RAND_M).
+ */
+struct IntGenerator {
+  INT_TYPE operator()(UINT64 bits) const {
+    return counter_rng_int(bits, RAND_M);
+  }
+};
+
+/**
+ * \brief Maps random bits to booleans.
+ */
+struct BoolGenerator {
+  bool operator()(UINT64 bits) const {
+    return counter_rng_bool(bits);
+  }
+};
+
+/**
+ * \brief Maps random bits to reals ~ U[RAND_MEAN - RAND_RANGE,
+ * RAND_MEAN + RAND_RANGE).
+ */
+struct RealGenerator {
+  real operator()(UINT64 bits) const {
+    return counter_rng_uniform(bits, (real)RAND_MEAN, (real)RAND_RANGE);
+  }
+};
+
+/**
+ * \brief Fills blocks of a flat array, element i from counter_rng(key, i).
+ */
+template <typename T, typename Generator>
+class FillTask: public RowTask {
+public:
+
+  FillTask(T* array, index_t count, UINT64 key): array(array), count(count),
+      key(key) { }
+
+  index_t run(index_t first, index_t last) {
+    index_t end = std::min(last * INPUT_BLOCK, count);
+    Generator generate;
+
+    for (index_t i = first * INPUT_BLOCK; i < end; i++) {
+      array[i] = generate(counter_rng(key, (UINT64)i));
+    }
+    return 0;
+  }
+
+private:
+
+  T* RESTRICT array;
+  index_t count;
+  UINT64 key;
+
+};
+
+/**
+ * \brief Fills blocks of a point vector.
+ */
+class PointTask: public RowTask {
+public:
+
+  PointTask(PointVector points, index_t count, UINT64 key): points(points),
+      count(count), key(key) { }
+
+  index_t run(index_t first, index_t last) {
+    index_t end = std::min(last * INPUT_BLOCK, count);
+    RealGenerator generate;
+
+    for (index_t i = first * INPUT_BLOCK; i < end; i++) {
+      points[i].x = generate(counter_rng(key, 2 * (UINT64)i));
+      points[i].y = generate(counter_rng(key, 2 * (UINT64)i + 1));
+    }
+    return 0;
+  }
+
+private:
+
+  PointVector RESTRICT points;
+  index_t count;
+  UINT64 key;
+
+};
+
+/**
+ * \brief Fills rows of a symmetric, diagonally dominant matrix.
+ */
+class SymmetricTask: public RowTask {
+public:
+
+  SymmetricTask(Matrix matrix, index_t n, UINT64 key): matrix(matrix), n(n),
+      key(key) { }
+
+  index_t run(index_t first, index_t last) {
+    real diagonal = (real)n * (real)(std::abs((real)RAND_MEAN) + RAND_RANGE);
+    RealGenerator generate;
+
+    for (index_t r = first; r < last; r++) {
+      real* RESTRICT row = matrix + r * n;
+      // (r, c) and (c, r) share the element of the lower triangle
+      for (index_t c = 0; c < r; c++) {
+        row[c] = generate(counter_rng(key, (UINT64)r * n + c));
+      }
+      row[r] = diagonal;
+      for (index_t c = r + 1; c < n; c++) {
+        row[c] = generate(counter_rng(key, (UINT64)c * n + r));
+      }
+    }
+    return 0;
+  }
+
+private:
+
+  Matrix matrix;
+  index_t n;
+  UINT64 key;
+
+};
+
+}
+
+void Cowichan::randomInts(INT_TYPE* array, index_t rows, index_t cols,
+    UINT64 stream)
+{
+  FillTask<INT_TYPE, IntGenerator> task(array, rows * cols,
+      counter_rng_key(seed, stream));
+  parallelRows(input_blocks(rows * cols), task);
+}
+
+void Cowichan::randomBools(bool* array, index_t rows, index_t cols,
+    UINT64 stream)
+{
+  FillTask<bool, BoolGenerator> task(array, rows * cols,
+      counter_rng_key(seed, stream));
+  parallelRows(input_blocks(rows * cols), task);
+}
+
+void Cowichan::randomReals(real* array, index_t rows, index_t cols,
+    UINT64 stream)
+{
+  FillTask<real, RealGenerator> task(array, rows * cols,
+      counter_rng_key(seed, stream));
+  parallelRows(input_blocks(rows * cols), task);
+}
+
+void Cowichan::randomPoints(PointVector points, index_t count, UINT64 stream)
+{
+  PointTask task(points, count, counter_rng_key(seed, stream));
+  parallelRows(input_blocks(count), task);
+}
+
+void Cowichan::randomSymmetric(Matrix matrix, UINT64 stream)
+{
+  SymmetricTask task(matrix, n, counter_rng_key(seed, stream));
+  parallelRows(n, task);
+}
+
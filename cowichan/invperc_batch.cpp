@@ -0,0 +1,259 @@
+/**
+ * \file invperc_batch.cpp
+ * \brief Implementation of invasion percolation in batches of cells.
+ * \see InvpercBatch
+ */
+
+#include "cowichan.hpp"
+
+/**
+ * Set a bit of a word other threads set bits of.
+ * \param word the word.
+ * \param bit the bit.
+ * \return Whether the bit was clear before.
+ */
+static inline bool invperc_claim(UINT64* word, UINT64 bit)
+{
+#if defined(WIN64) || defined(WIN32)
+  return (InterlockedOr64((volatile LONG64*)word, (LONG64)bit) & bit) == 0;
+#else
+  return (__sync_fetch_and_or(word, bit) & bit) == 0;
+#endif
+}
+
+/**
+ * Clear a bit of a word other threads clear bits of.
+ * \param word the word.
+ * \param bit the bit.
+ */
+static inline void invperc_release(UINT64* word, UINT64 bit)
+{
+#if defined(WIN64) || defined(WIN32)
+  InterlockedAnd64((volatile LONG64*)word, (LONG64)~bit);
+#else
+  __sync_fetch_and_and(word, ~bit);
+#endif
+}
+
+/**
+ * Add to a count other threads add to.
+ * \param count the count.
+ * \param more the number to add.
+ * \return The new count.
+ */
+static inline INT64 invperc_add(INT64* count, INT64 more)
+{
+#if defined(WIN64) || defined(WIN32)
+  return InterlockedExchangeAdd64((volatile LONG64*)count, more) + more;
+#else
+  return __sync_add_and_fetch(count, more);
+#endif
+}
+
+InvpercBatch::InvpercBatch(const MatrixView<INT_TYPE>& values,
+    const MatrixView<bool>& filled, index_t nfill, index_t parts):
+    values(values), filled(filled), nfill(nfill), left(nfill), parts(parts),
+    held(true), limit(0),
+    span(0), ceiling(0), steps(0), backoff(1), budget(0), claimed(0)
+{
+  invperc_check(values);
+
+  index_t nr = values.rows(), nc = values.cols();
+  try {
+    seen.resize((size_t)(nr * nc / BITS_PER_WORD + 1), 0);
+    grown.resize(parts);
+    edge.resize(parts);
+  }
+  catch (...) {out_of_memory();}
+
+  // "seed" with the middle value
+  UINT32 cell = (UINT32)(nr / 2 * nc + nc / 2);
+  seen[cell / BITS_PER_WORD] |= (UINT64)1 << (cell % BITS_PER_WORD);
+  queue(cell);
+}
+
+void InvpercBatch::queue(UINT32 cell)
+{
+  index_t nc = values.cols();
+  INT_TYPE value = values(cell / nc, cell % nc);
+  if (InvpercBuckets::holds(value)) {
+    frontier.push(value, cell);
+  }
+  else {
+    held = false;
+  }
+}
+
+bool InvpercBatch::start()
+{
+  for (; steps > 0 && left > 0 && held && !frontier.empty(); steps--) {
+    step();
+  }
+
+  // the cells filled so far come first with a heap too
+  if (!held) {
+    invperc_fill(values, filled, nfill, INVPERC_HEAP);
+    left = 0;
+  }
+  if (left == 0 || frontier.empty()) {
+    return false;
+  }
+
+  // the lowest value after a flood that did not fit, then halfway to its
+  // limit, or twice as far above the lowest value as last time
+  UINT64 lowest = frontier.first();
+  UINT64 top = (span == 0) ? lowest : (ceiling > lowest) ?
+      lowest + (ceiling - lowest) / 2 : lowest + span;
+  limit = (INT_TYPE)std::min(top, (UINT64)0xFFFFFFFFull);
+
+  seeds.clear();
+  frontier.peek(limit, seeds);
+  budget = std::min(left,
+      (index_t)((limit == lowest) ? INVPERC_FLOOD : INVPERC_GUESS));
+  claimed = (INT64)seeds.size();
+  return true;
+}
+
+index_t InvpercBatch::visit(index_t part, UINT32 cell)
+{
+  index_t nr = values.rows(), nc = values.cols();
+  index_t r = cell / nc;
+  index_t c = cell % nc;
+  index_t rr[4] = {r - 1, r + 1, r, r}, cc[4] = {c, c, c - 1, c + 1};
+  index_t count = 0;
+
+  // add all of its neighbours to the party...
+  for (int k = 0; k < 4; k++) {
+    if (rr[k] < 0 || rr[k] >= nr || cc[k] < 0 || cc[k] >= nc) {
+      continue;
+    }
+    UINT32 next = (UINT32)(rr[k] * nc + cc[k]);
+    UINT64* word = &seen[next / BITS_PER_WORD];
+    UINT64 bit = (UINT64)1 << (next % BITS_PER_WORD);
+    if ((*word & bit) != 0 || !invperc_claim(word, bit)) {
+      continue;
+    }
+
+    try {
+      if (values(rr[k], cc[k]) <= limit) {
+        grown[part].push_back(next);
+        count++;
+      }
+      else {
+        edge[part].push_back(next);
+      }
+    }
+    catch (...) {out_of_memory();}
+  }
+
+  return count;
+}
+
+void InvpercBatch::grow(index_t part)
+{
+  std::vector<UINT32>& cells = grown[part];
+  index_t count = (index_t)seeds.size();
+  index_t pending = 0;
+
+  for (index_t i = count * part / parts; i < count * (part + 1) / parts; i++) {
+    pending += visit(part, seeds[i]);
+  }
+
+  // the cells claimed are also the ones to visit
+  for (size_t i = 0; i < cells.size(); i++) {
+    pending += visit(part, cells[i]);
+    if (pending >= INVPERC_CLAIMS) {
+      if (invperc_add(&claimed, pending) > budget) {
+        return;
+      }
+      pending = 0;
+    }
+  }
+  invperc_add(&claimed, pending);
+}
+
+bool InvpercBatch::fits() const
+{
+  index_t count = (index_t)seeds.size();
+  for (index_t p = 0; p < parts; p++) {
+    count += (index_t)grown[p].size();
+  }
+  return count <= budget;
+}
+
+void InvpercBatch::settle(index_t part)
+{
+  index_t nc = values.cols();
+
+  if (fits()) {
+    index_t count = (index_t)seeds.size();
+    for (index_t i = count * part / parts; i < count * (part + 1) / parts;
+        i++) {
+      filled(seeds[i] / nc, seeds[i] % nc) = true;
+    }
+    for (size_t i = 0; i < grown[part].size(); i++) {
+      filled(grown[part][i] / nc, grown[part][i] % nc) = true;
+    }
+    return;
+  }
+
+  // the seeds stay in the frontier; the other cells were not claimed before
+  for (size_t i = 0; i < grown[part].size(); i++) {
+    invperc_release(&seen[grown[part][i] / BITS_PER_WORD],
+        (UINT64)1 << (grown[part][i] % BITS_PER_WORD));
+  }
+  for (size_t i = 0; i < edge[part].size(); i++) {
+    invperc_release(&seen[edge[part][i] / BITS_PER_WORD],
+        (UINT64)1 << (edge[part][i] % BITS_PER_WORD));
+  }
+}
+
+void InvpercBatch::end()
+{
+  if (fits()) {
+    left -= (index_t)claimed;
+
+    // the seeds left the frontier, the cells above the limit joined
+    frontier.drop(limit);
+    for (index_t p = 0; p < parts; p++) {
+      for (size_t i = 0; i < edge[p].size(); i++) {
+        queue(edge[p][i]);
+      }
+    }
+    span = std::min(2 * span + 1, (UINT64)0xFFFFFFFFull);
+    backoff = 1;
+  }
+  else {
+    ceiling = limit;
+    span = 0;
+
+    // no flood fits: fill cells one at a time for a while, longer each time
+    if (limit == frontier.first()) {
+      steps = backoff;
+      backoff *= 2;
+    }
+  }
+
+  for (index_t p = 0; p < parts; p++) {
+    grown[p].clear();
+    edge[p].clear();
+  }
+}
+
+void InvpercBatch::step()
+{
+  index_t nc = values.cols();
+  UINT32 cell = frontier.pop();
+  filled(cell / nc, cell % nc) = true;
+  left--;
+
+  // its neighbours join the frontier, whatever their value
+  limit = 0;
+  visit(0, cell);
+  grown[0].insert(grown[0].end(), edge[0].begin(), edge[0].end());
+  for (size_t i = 0; i < grown[0].size(); i++) {
+    queue(grown[0][i]);
+  }
+  grown[0].clear();
+  edge[0].clear();
+}
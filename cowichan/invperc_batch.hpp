@@ -0,0 +1,185 @@
+/**
+ * \file invperc_batch.hpp
+ * \brief Invasion percolation in batches of cells, for the parallel
+ * implementations.
+ */
+
+#ifndef __invperc_batch_hpp__
+#define __invperc_batch_hpp__
+
+/**
+ * \brief Invasion percolation that fills many cells at a time, and fills the
+ * same cells as invperc_fill.
+ *
+ * Each round picks a limit at or above the lowest frontier value, and floods
+ * from the frontier through the cells up to the limit. invperc_fill fills
+ * every cell of that flood before any cell above the limit: one of them is
+ * always next to the filled cells, and a lower cell next to the filled ones
+ * is part of the flood. So when the flood fits in the cells left to fill
+ * (and in INVPERC_FLOOD cells, or INVPERC_GUESS above the lowest value), all
+ * of it is filled at once; when it does not, it is undone and the limit
+ * lowered.
+ *
+ * When even a flood at the lowest value does not fit, cells are filled one
+ * at a time, in the order of invperc_fill, for twice as long each time in a
+ * row: near the percolation threshold the floods grow past any size.
+ *
+ * The frontier is an InvpercBuckets: once a cell it does not hold joins the
+ * frontier, the last round hands over to invperc_fill with an InvpercHeap.
+ *
+ * The frontier cells of a flood are split into parts, and every part grows
+ * from its cells at the same time as the others, claiming cells in a shared
+ * bitmap. A flood stops as soon as the parts have claimed more cells than
+ * fit, and it is then undone:
+ * \code
+ * InvpercBatch batch(values, filled, nfill, parts);
+ * while (batch.start()) {
+ *   // for every part p, in parallel
+ *   batch.grow(p);
+ *   // for every part p, in parallel
+ *   batch.settle(p);
+ *   batch.end();
+ * }
+ * \endcode
+ */
+class InvpercBatch {
+public:
+
+  /**
+   * Seed invasion percolation with the middle cell.
+   * \param values the matrix.
+   * \param filled the mask, with every filled cell set (others are left as
+   * they are).
+   * \param nfill number of cells to fill (at most rows * cols).
+   * \param parts number of parts of each flood.
+   */
+  InvpercBatch(const MatrixView<INT_TYPE>& values,
+      const MatrixView<bool>& filled, index_t nfill, index_t parts);
+
+  /**
+   * Start a round: fill the cells due one at a time, then pick the limit and
+   * the frontier cells up to it.
+   * \return Whether there are cells left to fill.
+   */
+  bool start();
+
+  /**
+   * Flood from part of the frontier cells up to the limit: claim the cells
+   * up to the limit next to the flood, and the cells above it next to the
+   * flood for the frontier. Parts can run in parallel.
+   * \param part the part, from 0 to parts - 1.
+   */
+  void grow(index_t part);
+
+  /**
+   * Fill part of the flood, or undo it when it did not fit. Parts can run
+   * in parallel.
+   * \param part the part, from 0 to parts - 1.
+   */
+  void settle(index_t part);
+
+  /**
+   * End a round: update the frontier and the next limit.
+   */
+  void end();
+
+private:
+
+  /**
+   * Claim the cells next to a cell of the flood, unless they were claimed
+   * (filled, in the frontier or in the flood) before.
+   * \param part the part of the flood.
+   * \param cell row-major index of the cell.
+   * \return Number of cells claimed up to the limit.
+   */
+  index_t visit(index_t part, UINT32 cell);
+
+  /**
+   * Fill the first frontier cell, as invperc_fill would next.
+   */
+  void step();
+
+  /**
+   * \return Whether the whole flood fits (once every part grew).
+   */
+  bool fits() const;
+
+  /**
+   * Add a cell to the frontier, if it holds its value.
+   * \param cell row-major index of the cell.
+   */
+  void queue(UINT32 cell);
+
+  /**
+   * The matrix.
+   */
+  MatrixView<INT_TYPE> values;
+
+  /**
+   * The mask.
+   */
+  MatrixView<bool> filled;
+
+  /**
+   * Number of cells to fill, left to fill, and of parts.
+   */
+  index_t nfill, left, parts;
+
+  /**
+   * Whether the frontier held every cell that joined it.
+   */
+  bool held;
+
+  /**
+   * Bit c % 64 of word c / 64 is set when cell c is filled, in the
+   * frontier or in the flood.
+   */
+  std::vector<UINT64> seen;
+
+  /**
+   * The frontier.
+   */
+  InvpercBuckets frontier;
+
+  /**
+   * Limit of the round, and how far the next one goes above the lowest
+   * value (0 after a flood that did not fit).
+   */
+  INT_TYPE limit;
+  UINT64 span;
+
+  /**
+   * Lowest limit known not to fit.
+   */
+  UINT64 ceiling;
+
+  /**
+   * Cells to fill one at a time before the next flood, and after the next
+   * flood at the lowest value that does not fit.
+   */
+  index_t steps, backoff;
+
+  /**
+   * Most cells the flood may have, and cells the parts claimed so far
+   * (updated every INVPERC_CLAIMS cells).
+   */
+  index_t budget;
+  INT64 claimed;
+
+  /**
+   * Frontier cells up to the limit.
+   */
+  std::vector<UINT32> seeds;
+
+  /**
+   * Cells each part claimed up to the limit, and above it.
+   */
+  std::vector<std::vector<UINT32> > grown, edge;
+
+  // not copyable
+  InvpercBatch(const InvpercBatch&);
+  InvpercBatch& operator=(const InvpercBatch&);
+
+};
+
+#endif
@@ -0,0 +1,294 @@
+/**
+ * \file invperc_queue.cpp
+ * \brief Implementation of invasion percolation with a bucket queue or a
+ * heap.
+ * \see invperc_fill
+ */
+
+#include "cowichan.hpp"
+#include <functional>
+
+void InvpercBuckets::push(INT_TYPE value, UINT32 cell)
+{
+  if (value >= buckets.size()) {
+    buckets.resize((size_t)value + 1);
+    used.resize((size_t)value / BITS_PER_WORD + 1, 0);
+    usedWords.resize(used.size() / BITS_PER_WORD + 1, 0);
+  }
+
+  std::vector<UINT32>& bucket = buckets[value];
+  bucket.push_back(cell);
+  std::push_heap(bucket.begin(), bucket.end(), std::greater<UINT32>());
+
+  index_t w = value / BITS_PER_WORD;
+  used[w] |= (UINT64)1 << (value % BITS_PER_WORD);
+  usedWords[w / BITS_PER_WORD] |= (UINT64)1 << (w % BITS_PER_WORD);
+  count++;
+}
+
+UINT32 InvpercBuckets::pop()
+{
+  // lowest bucket in use
+  index_t s = 0;
+  while (usedWords[s] == 0) {
+    s++;
+  }
+  index_t w = s * BITS_PER_WORD + lowest_bit64(usedWords[s]);
+  index_t value = w * BITS_PER_WORD + lowest_bit64(used[w]);
+
+  std::vector<UINT32>& bucket = buckets[value];
+  std::pop_heap(bucket.begin(), bucket.end(), std::greater<UINT32>());
+  UINT32 cell = bucket.back();
+  bucket.pop_back();
+
+  if (bucket.empty()) {
+    used[w] &= ~((UINT64)1 << (value % BITS_PER_WORD));
+    if (used[w] == 0) {
+      usedWords[s] &= ~((UINT64)1 << (w % BITS_PER_WORD));
+    }
+  }
+  count--;
+  return cell;
+}
+
+INT_TYPE InvpercBuckets::first() const
+{
+  index_t s = 0;
+  while (usedWords[s] == 0) {
+    s++;
+  }
+  index_t w = s * BITS_PER_WORD + lowest_bit64(usedWords[s]);
+  return (INT_TYPE)(w * BITS_PER_WORD + lowest_bit64(used[w]));
+}
+
+UINT32 InvpercBuckets::firstCell() const
+{
+  // the top of each bucket's heap is its lowest index
+  return buckets[first()].front();
+}
+
+void InvpercBuckets::peek(INT_TYPE limit, std::vector<UINT32>& cells) const
+{
+  index_t last = std::min((index_t)limit, (index_t)buckets.size() - 1);
+  try {
+    for (index_t w = 0; w * BITS_PER_WORD <= last; w++) {
+      for (UINT64 word = used[w]; word != 0; word &= word - 1) {
+        index_t value = w * BITS_PER_WORD + lowest_bit64(word);
+        if (value > last) {
+          break;
+        }
+        cells.insert(cells.end(), buckets[value].begin(),
+            buckets[value].end());
+      }
+    }
+  }
+  catch (...) {out_of_memory();}
+}
+
+void InvpercBuckets::drop(INT_TYPE limit)
+{
+  index_t last = std::min((index_t)limit, (index_t)buckets.size() - 1);
+  for (index_t w = 0; w * BITS_PER_WORD <= last; w++) {
+    for (UINT64 word = used[w]; word != 0; word &= word - 1) {
+      index_t value = w * BITS_PER_WORD + lowest_bit64(word);
+      if (value > last) {
+        break;
+      }
+      count -= (index_t)buckets[value].size();
+      buckets[value].clear();
+      used[w] &= ~((UINT64)1 << (value % BITS_PER_WORD));
+    }
+    if (used[w] == 0) {
+      usedWords[w / BITS_PER_WORD] &= ~((UINT64)1 << (w % BITS_PER_WORD));
+    }
+  }
+}
+
+/**
+ * Node of InvpercHeap stored at keys[0]: the children of node k then start
+ * at keys[4 (k + 1)], a multiple of 4 keys (32 bytes).
+ */
+#define INVPERC_HEAP_ROOT 3
+
+InvpercHeap::InvpercHeap(): keys(NULL), count(0), capacity(0)
+{
+  grow();
+}
+
+InvpercHeap::~InvpercHeap()
+{
+  DELETE_ARRAY(keys);
+}
+
+void InvpercHeap::grow()
+{
+  index_t room = std::max(capacity * 2, (index_t)1024);
+  UINT64* more = NULL;
+  try {
+    more = NEW_VECTOR_SZ(UINT64, INVPERC_HEAP_ROOT + room);
+  }
+  catch (...) {out_of_memory();}
+
+  if (keys != NULL) {
+    memcpy(more, keys, (INVPERC_HEAP_ROOT + count) * sizeof(UINT64));
+    DELETE_ARRAY(keys);
+  }
+  keys = more;
+  capacity = room;
+}
+
+void InvpercHeap::push(INT_TYPE value, UINT32 cell)
+{
+  if (count == capacity) {
+    grow();
+  }
+
+  UINT64* RESTRICT node = keys + INVPERC_HEAP_ROOT;
+  UINT64 key = ((UINT64)value << 32) | cell;
+
+  // move parents down until the key fits
+  index_t k = count++;
+  while (k > 0) {
+    index_t parent = (k - 1) / 4;
+    if (node[parent] <= key) {
+      break;
+    }
+    node[k] = node[parent];
+    k = parent;
+  }
+  node[k] = key;
+}
+
+UINT32 InvpercHeap::pop()
+{
+  UINT64* RESTRICT node = keys + INVPERC_HEAP_ROOT;
+  UINT32 cell = (UINT32)node[0];
+  UINT64 key = node[--count];
+
+  // move the smallest children up until the last key fits
+  index_t k = 0;
+  for (;;) {
+    index_t first = 4 * k + 1;
+    if (first >= count) {
+      break;
+    }
+    index_t last = std::min(first + 4, count);
+    index_t least = first;
+    for (index_t child = first + 1; child < last; child++) {
+      if (node[child] < node[least]) {
+        least = child;
+      }
+    }
+    if (key <= node[least]) {
+      break;
+    }
+    node[k] = node[least];
+    k = least;
+  }
+  node[k] = key;
+  return cell;
+}
+
+/**
+ * Queue a cell, unless it was filled or queued before.
+ * \param frontier the queue (InvpercBuckets or InvpercHeap).
+ * \param seen bitmap of the cells filled or queued.
+ * \param values the matrix.
+ * \param r row of the cell.
+ * \param c column of the cell.
+ * \return Whether the queue holds the value of the cell.
+ */
+template <class Queue>
+static inline bool invperc_visit(Queue& frontier,
+    std::vector<UINT64>& seen, const MatrixView<INT_TYPE>& values, index_t r,
+    index_t c)
+{
+  UINT32 cell = (UINT32)(r * values.cols() + c);
+  UINT64& word = seen[cell / BITS_PER_WORD];
+  UINT64 bit = (UINT64)1 << (cell % BITS_PER_WORD);
+  if ((word & bit) == 0) {
+    if (!Queue::holds(values(r, c))) {
+      return false;
+    }
+    word |= bit;
+    frontier.push(values(r, c), cell);
+  }
+  return true;
+}
+
+/**
+ * Run invasion percolation (see invperc_fill) with a queue.
+ * \param frontier the queue, empty.
+ * \param values the matrix.
+ * \param filled the mask.
+ * \param nfill number of cells to fill.
+ * \return Whether the queue held every value it met (the filled cells are
+ * the first ones either way).
+ */
+template <class Queue>
+static bool invperc_run(Queue& frontier, const MatrixView<INT_TYPE>& values,
+    const MatrixView<bool>& filled, index_t nfill)
+{
+  index_t nr = values.rows(), nc = values.cols();
+
+  // cells filled or in the queue
+  std::vector<UINT64> seen;
+  try {
+    seen.resize((size_t)(nr * nc / BITS_PER_WORD + 1), 0);
+  }
+  catch (...) {out_of_memory();}
+
+  // "seed" with the middle value
+  if (!invperc_visit(frontier, seen, values, nr / 2, nc / 2)) {
+    return false;
+  }
+
+  for (index_t it = 0; (it < nfill) && !frontier.empty(); it++) {
+    UINT32 cell = frontier.pop();
+    index_t r = cell / nc;
+    index_t c = cell % nc;
+    filled(r, c) = true;
+
+    // add all of its neighbours to the party...
+    bool held = true;
+    if (r > 0) {
+      held = invperc_visit(frontier, seen, values, r - 1, c) && held;
+    }
+    if (r < nr - 1) {
+      held = invperc_visit(frontier, seen, values, r + 1, c) && held;
+    }
+    if (c > 0) {
+      held = invperc_visit(frontier, seen, values, r, c - 1) && held;
+    }
+    if (c < nc - 1) {
+      held = invperc_visit(frontier, seen, values, r, c + 1) && held;
+    }
+    if (!held) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void invperc_check(const MatrixView<INT_TYPE>& values)
+{
+  if ((UINT64)values.rows() * values.cols() > 0xFFFFFFFFull) {
+    bad_argument("Too many cells (2^32 at most) for", "invperc");
+  }
+}
+
+void invperc_fill(const MatrixView<INT_TYPE>& values,
+    const MatrixView<bool>& filled, index_t nfill, InvpercQueue queue)
+{
+  invperc_check(values);
+
+  if (queue == INVPERC_BUCKETS) {
+    InvpercBuckets frontier;
+    if (invperc_run(frontier, values, filled, nfill)) {
+      return;
+    }
+  }
+
+  InvpercHeap frontier;
+  invperc_run(frontier, values, filled, nfill);
+}
@@ -0,0 +1,199 @@
+/**
+ * \file invperc_queue.hpp
+ * \brief Invasion percolation shared by the implementations, with a bucket
+ * queue or a heap of cells.
+ */
+
+#ifndef __invperc_queue_hpp__
+#define __invperc_queue_hpp__
+
+/**
+ * \brief Queues invperc_fill can use. Both fill the same cells.
+ */
+enum InvpercQueue {
+  INVPERC_BUCKETS,   ///< InvpercBuckets.
+  INVPERC_HEAP       ///< InvpercHeap.
+};
+
+/**
+ * \brief Priority queue of matrix cells, lowest value first and, among equal
+ * values, lowest row-major index first.
+ *
+ * Every value has a bucket: a small heap of cell indices. A bit per bucket
+ * marks the ones in use, and a bit per word of those marks the words in use,
+ * so the lowest bucket is found in a few word scans. Values are small (below
+ * RAND_M for randmat, at most the iteration limit for mandel), and the
+ * buckets grow to the largest value pushed; values read from a file can be
+ * far larger, and only values below INVPERC_BUCKETS_MAX are held.
+ */
+class InvpercBuckets {
+public:
+
+  InvpercBuckets(): count(0) { }
+
+  /**
+   * \param value a value.
+   * \return Whether cells of that value can be pushed.
+   */
+  static bool holds(INT_TYPE value) {
+    return value < INVPERC_BUCKETS_MAX;
+  }
+
+  /**
+   * \return Whether there are no cells.
+   */
+  bool empty() const {
+    return count == 0;
+  }
+
+  /**
+   * Add a cell.
+   * \param value its value.
+   * \param cell its row-major index.
+   */
+  void push(INT_TYPE value, UINT32 cell);
+
+  /**
+   * Remove the first cell.
+   * \return Its row-major index.
+   */
+  UINT32 pop();
+
+  /**
+   * \return Value of the first cell (there must be one).
+   */
+  INT_TYPE first() const;
+
+  /**
+   * \return Row-major index of the first cell (there must be one).
+   */
+  UINT32 firstCell() const;
+
+  /**
+   * List the cells up to a value, in no particular order.
+   * \param limit the value.
+   * \param cells the list to add them to.
+   */
+  void peek(INT_TYPE limit, std::vector<UINT32>& cells) const;
+
+  /**
+   * Remove the cells up to a value.
+   * \param limit the value.
+   */
+  void drop(INT_TYPE limit);
+
+private:
+
+  /**
+   * Cells of each value, each a heap with the lowest index on top.
+   */
+  std::vector<std::vector<UINT32> > buckets;
+
+  /**
+   * Bit v % 64 of word v / 64 is set when bucket v is not empty.
+   */
+  std::vector<UINT64> used;
+
+  /**
+   * Bit w % 64 of word w / 64 is set when word w of used is not zero.
+   */
+  std::vector<UINT64> usedWords;
+
+  /**
+   * Number of cells.
+   */
+  index_t count;
+
+};
+
+/**
+ * \brief Priority queue of matrix cells in the order of InvpercBuckets,
+ * as a 4-ary heap of packed keys.
+ *
+ * A key is value << 32 | cell, so plain integer comparisons give the
+ * order. The four children of a node share half a cache line: the array is
+ * cache-line aligned and the root is stored at INVPERC_HEAP_ROOT.
+ */
+class InvpercHeap {
+public:
+
+  InvpercHeap();
+
+  ~InvpercHeap();
+
+  /**
+   * \return Whether cells of a value can be pushed (always).
+   */
+  static bool holds(INT_TYPE) {
+    return true;
+  }
+
+  /**
+   * \return Whether there are no cells.
+   */
+  bool empty() const {
+    return count == 0;
+  }
+
+  /**
+   * Add a cell.
+   * \param value its value.
+   * \param cell its row-major index.
+   */
+  void push(INT_TYPE value, UINT32 cell);
+
+  /**
+   * Remove the first cell.
+   * \return Its row-major index.
+   */
+  UINT32 pop();
+
+private:
+
+  /**
+   * Double the capacity.
+   */
+  void grow();
+
+  /**
+   * Keys; node k is at keys[INVPERC_HEAP_ROOT + k], its children at nodes
+   * 4 k + 1 to 4 k + 4.
+   */
+  UINT64* keys;
+
+  /**
+   * Number of cells, and room for nodes.
+   */
+  index_t count, capacity;
+
+  // not copyable
+  InvpercHeap(const InvpercHeap&);
+  InvpercHeap& operator=(const InvpercHeap&);
+
+};
+
+/**
+ * Run invasion percolation from the middle cell: fill the lowest cell next
+ * to the filled ones, nfill times. Ties go to the lowest row-major index, so
+ * the filled cells do not depend on the implementation. A bitmap of the
+ * cells filled or queued keeps every cell out of the queue after its first
+ * push. The bucket queue hands over to the heap when it meets a value it does
+ * not hold: the cells filled up to then come first with the heap too.
+ * \param values the matrix.
+ * \param filled the mask, with every filled cell set (others are left as
+ * they are).
+ * \param nfill number of cells to fill (at most rows * cols).
+ * \param queue the queue to use.
+ */
+void invperc_fill(const MatrixView<INT_TYPE>& values,
+    const MatrixView<bool>& filled, index_t nfill,
+    InvpercQueue queue = INVPERC_BUCKETS);
+
+/**
+ * Make sure every cell of the matrix has a 32-bit index, as invperc_fill
+ * and InvpercBatch need (calls bad_argument otherwise).
+ * \param values the matrix.
+ */
+void invperc_check(const MatrixView<INT_TYPE>& values);
+
+#endif
@@ -0,0 +1,224 @@
+/**
+ * \file mandel_cache.cpp
+ * \brief Mandel through a cache of tiles.
+ * \see Cowichan::mandelCached
+ */
+
+#include "cowichan.hpp"
+
+bool MandelTileKey::operator<(const MandelTileKey& other) const
+{
+  if (row != other.row) {
+    return row < other.row;
+  }
+  if (col != other.col) {
+    return col < other.col;
+  }
+  if (x0 != other.x0) {
+    return x0 < other.x0;
+  }
+  if (y0 != other.y0) {
+    return y0 < other.y0;
+  }
+  if (dx != other.dx) {
+    return dx < other.dx;
+  }
+  if (dy != other.dy) {
+    return dy < other.dy;
+  }
+  if (maxIter != other.maxIter) {
+    return maxIter < other.maxIter;
+  }
+  return infinity < other.infinity;
+}
+
+MandelCache::MandelCache(size_t limit): limit(limit), used(0) { }
+
+MandelCache::~MandelCache()
+{
+  evict(0);
+}
+
+void MandelCache::setLimit(size_t bytes)
+{
+  limit = bytes;
+  evict(limit);
+}
+
+const INT_TYPE* MandelCache::find(const MandelTileKey& key)
+{
+  Tiles::iterator it = tiles.find(key);
+  if (it == tiles.end()) {
+    return NULL;
+  }
+  order.splice(order.begin(), order, it->second.position);
+  return it->second.values;
+}
+
+void MandelCache::insert(const MandelTileKey& key, INT_TYPE* values)
+{
+  if (tileBytes() > limit) {
+    DELETE_ARRAY(values);
+    return;
+  }
+  evict(limit - tileBytes());
+
+  Entry entry;
+  entry.values = values;
+  order.push_front(key);
+  entry.position = order.begin();
+  tiles[key] = entry;
+  used += tileBytes();
+}
+
+size_t MandelCache::tileBytes()
+{
+  return (size_t)MANDEL_CACHE_TILE * MANDEL_CACHE_TILE * sizeof(INT_TYPE);
+}
+
+void MandelCache::evict(size_t bytes)
+{
+  while ((used > bytes) && !order.empty()) {
+    Tiles::iterator it = tiles.find(order.back());
+    DELETE_ARRAY(it->second.values);
+    tiles.erase(it);
+    order.pop_back();
+    used -= tileBytes();
+  }
+}
+
+namespace
+{
+
+/**
+ * \param a dividend.
+ * \param b divisor (positive).
+ * \return a / b rounded down.
+ */
+INT64 floor_div(INT64 a, INT64 b)
+{
+  return (a >= 0) ? (a / b) : -((b - 1 - a) / b);
+}
+
+/**
+ * \brief A tile that overlaps the matrix.
+ */
+struct MandelTile {
+  MandelTileKey key;
+  const INT_TYPE* cached;  ///< values from the cache, or NULL.
+  INT_TYPE* fresh;         ///< values computed now, or NULL.
+};
+
+/**
+ * \brief Computes the missing tiles and copies every tile's part of the
+ * matrix into place.
+ */
+class MandelCacheTask: public RowTask {
+public:
+
+  /**
+   * Construct the task.
+   * \param view the mandel matrix.
+   * \param tiles tiles that overlap the matrix.
+   * \param row0 lattice row of matrix row 0.
+   * \param col0 lattice column of matrix column 0.
+   */
+  MandelCacheTask(const MatrixView<INT_TYPE>& view,
+      std::vector<MandelTile>& tiles, INT64 row0, INT64 col0): view(view),
+      tiles(tiles), row0(row0), col0(col0) { }
+
+  index_t run(index_t first, index_t last) {
+    const index_t T = MANDEL_CACHE_TILE;
+    real x[MANDEL_CACHE_TILE];
+
+    for (index_t t = first; t < last; t++) {
+      const MandelTileKey& key = tiles[t].key;
+      const INT_TYPE* values = tiles[t].cached;
+
+      if (values == NULL) {
+        INT_TYPE* fresh = tiles[t].fresh;
+        mandel_columns(x, T, key.x0, key.dx, (index_t)(key.col * T), false);
+        for (index_t r = 0; r < T; r++) {
+          mandel_row(fresh + r * T, x, T,
+              mandel_coordinate(key.y0, (index_t)(key.row * T + r), key.dy),
+              key.maxIter, key.infinity);
+        }
+        values = fresh;
+      }
+
+      // the part of the tile inside the matrix
+      INT64 top = key.row * T - row0;
+      INT64 left = key.col * T - col0;
+      index_t r0 = (index_t)std::max(top, (INT64)0);
+      index_t r1 = (index_t)std::min(top + T, (INT64)view.rows());
+      index_t c0 = (index_t)std::max(left, (INT64)0);
+      index_t c1 = (index_t)std::min(left + T, (INT64)view.cols());
+      for (index_t r = r0; r < r1; r++) {
+        memcpy(view.row(r) + c0, values + (r - top) * T + (c0 - left),
+            (c1 - c0) * sizeof(INT_TYPE));
+      }
+    }
+    return 0;
+  }
+
+private:
+
+  MatrixView<INT_TYPE> view;
+  std::vector<MandelTile>& tiles;
+  INT64 row0, col0;
+
+};
+
+}
+
+void Cowichan::mandelCached(IntMatrix matrix)
+{
+  const INT64 T = MANDEL_CACHE_TILE;
+  real dx = mandelDx / (nc - 1);
+  real dy = mandelDy / (nr - 1);
+  INT64 row0 = mandelRow0;
+  INT64 col0 = mandelCol0;
+
+  if (mandelCache == NULL) {
+    try {
+      mandelCache = new MandelCache (mandelCacheBytes);
+    }
+    catch (...) {out_of_memory();}
+  }
+  mandelCache->setLimit (mandelCacheBytes);
+
+  // look up every tile that overlaps the matrix
+  std::vector<MandelTile> tiles;
+  MandelTile tile;
+  tile.key.x0 = mandelX0;
+  tile.key.y0 = mandelY0;
+  tile.key.dx = dx;
+  tile.key.dy = dy;
+  tile.key.maxIter = mandelMaxIter;
+  tile.key.infinity = mandelInfinity;
+  for (tile.key.row = floor_div (row0, T);
+      tile.key.row * T < row0 + nr; tile.key.row++) {
+    for (tile.key.col = floor_div (col0, T);
+        tile.key.col * T < col0 + nc; tile.key.col++) {
+      tile.cached = mandelCache->find (tile.key);
+      tile.fresh = NULL;
+      if (tile.cached == NULL) {
+        try {
+          tile.fresh = NEW_VECTOR_SZ(INT_TYPE, T * T);
+        }
+        catch (...) {out_of_memory();}
+      }
+      tiles.push_back (tile);
+    }
+  }
+
+  MandelCacheTask task (rectView (matrix), tiles, row0, col0);
+  parallelRows ((index_t)tiles.size (), task);
+
+  // the new tiles become the most recently used
+  for (size_t t = 0; t < tiles.size (); t++) {
+    if (tiles[t].fresh != NULL) {
+      mandelCache->insert (tiles[t].key, tiles[t].fresh);
+    }
+  }
+}
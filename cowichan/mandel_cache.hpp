@@ -0,0 +1,129 @@
+/**
+ * \file mandel_cache.hpp
+ * \brief Cache of mandelbrot tiles for viewports that overlap earlier ones.
+ */
+
+#ifndef __mandel_cache_hpp__
+#define __mandel_cache_hpp__
+
+#include <list>
+#include <map>
+
+/**
+ * \brief Identifies a tile of mandelbrot values.
+ *
+ * Points lie on a lattice: point (i, j) is at (x0 + j * dx, y0 + i * dy),
+ * computed with mandel_coordinate, and tile (row, col) holds the
+ * MANDEL_CACHE_TILE x MANDEL_CACHE_TILE points from
+ * (row * MANDEL_CACHE_TILE, col * MANDEL_CACHE_TILE).
+ */
+struct MandelTileKey {
+
+  /**
+   * Lattice origin.
+   */
+  real x0, y0;
+
+  /**
+   * Lattice steps.
+   */
+  real dx, dy;
+
+  /**
+   * Maximum number of iterations.
+   */
+  index_t maxIter;
+
+  /**
+   * Squared magnitude considered divergent.
+   */
+  real infinity;
+
+  /**
+   * Position of the tile, in tiles.
+   */
+  INT64 row, col;
+
+  bool operator<(const MandelTileKey& other) const;
+
+};
+
+/**
+ * \brief Tiles of mandelbrot values up to a memory limit, evicting the least
+ * recently used.
+ */
+class MandelCache {
+public:
+
+  /**
+   * Create an empty cache.
+   * \param limit most bytes of values to keep.
+   */
+  MandelCache(size_t limit);
+
+  ~MandelCache();
+
+  /**
+   * Change the memory limit, evicting tiles down to it.
+   * \param bytes most bytes of values to keep.
+   */
+  void setLimit(size_t bytes);
+
+  /**
+   * Look up a tile, making it the most recently used.
+   * \param key the tile.
+   * \return Its values (row-major), or NULL if not cached. Valid until the
+   * next insert or setLimit.
+   */
+  const INT_TYPE* find(const MandelTileKey& key);
+
+  /**
+   * Add a tile as the most recently used, evicting others to make room.
+   * \param key the tile (not cached).
+   * \param values its values, allocated with NEW_VECTOR_SZ; the cache owns
+   * them from now on.
+   */
+  void insert(const MandelTileKey& key, INT_TYPE* values);
+
+  /**
+   * \return Bytes of values of one tile.
+   */
+  static size_t tileBytes();
+
+private:
+
+  /**
+   * Keys, most recently used first.
+   */
+  typedef std::list<MandelTileKey> Order;
+
+  /**
+   * \brief A cached tile.
+   */
+  struct Entry {
+    INT_TYPE* values;
+    Order::iterator position;
+  };
+
+  typedef std::map<MandelTileKey, Entry> Tiles;
+
+  /**
+   * Evicts least recently used tiles until at most bytes are used.
+   */
+  void evict(size_t bytes);
+
+  Tiles tiles;
+  Order order;
+
+  /**
+   * Memory limit and bytes in use.
+   */
+  size_t limit, used;
+
+  // not copyable
+  MandelCache(const MandelCache&);
+  MandelCache& operator=(const MandelCache&);
+
+};
+
+#endif
@@ -0,0 +1,343 @@
+/**
+ * \file mandel_kernel.cpp
+ * \brief Implementation of the vectorized mandelbrot iteration.
+ *
+ * Each vector path repeats the operations of mandel_calc in the same order
+ * and precision. Contraction into fused multiply-adds is turned off, since it
+ * would round differently and change the counts near the boundary of the
+ * set. The vector paths assume that real is float; otherwise only the scalar
+ * path is used.
+ */
+
+#include "cowichan.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define MANDEL_SSE2
+#define MANDEL_AVX
+#include <immintrin.h>
+#define MANDEL_TARGET(__isa) \
+    __attribute__((target(__isa), optimize("fp-contract=off")))
+#elif defined(_M_X64)
+#define MANDEL_SSE2
+#include <emmintrin.h>
+#define MANDEL_TARGET(__isa)
+#endif
+
+/**
+ * Instruction set used by mandel_row (MANDEL_ISA_AUTO until first chosen).
+ */
+static MandelIsa mandelIsa = MANDEL_ISA_AUTO;
+
+/**
+ * \param isa an instruction set.
+ * \return Whether this build and the processor support it.
+ */
+static bool mandel_supports(MandelIsa isa)
+{
+  if (isa == MANDEL_ISA_SCALAR) {
+    return true;
+  }
+  if (sizeof(real) != sizeof(float)) {
+    return false;
+  }
+  switch (isa) {
+#ifdef MANDEL_SSE2
+  case MANDEL_ISA_SSE2:
+#ifdef MANDEL_AVX
+    return __builtin_cpu_supports("sse2");
+#else
+    return true;
+#endif
+#endif
+#ifdef MANDEL_AVX
+  case MANDEL_ISA_AVX2:
+    return __builtin_cpu_supports("avx2");
+  case MANDEL_ISA_AVX512:
+    return __builtin_cpu_supports("avx512f");
+#endif
+  default:
+    return false;
+  }
+}
+
+void mandel_set_isa(MandelIsa isa)
+{
+  if (isa != MANDEL_ISA_AUTO) {
+    if (!mandel_supports(isa)) {
+      bad_argument("Instruction set not supported for mandel",
+          (isa == MANDEL_ISA_AVX512) ? "avx512"
+          : (isa == MANDEL_ISA_AVX2) ? "avx2" : "sse2");
+    }
+    mandelIsa = isa;
+    return;
+  }
+
+  // widest first
+  static const MandelIsa order[] = {MANDEL_ISA_AVX512, MANDEL_ISA_AVX2,
+      MANDEL_ISA_SSE2, MANDEL_ISA_SCALAR};
+  for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+    if (mandel_supports(order[i])) {
+      mandelIsa = order[i];
+      return;
+    }
+  }
+}
+
+MandelIsa mandel_isa()
+{
+  if (mandelIsa == MANDEL_ISA_AUTO) {
+    mandel_set_isa(MANDEL_ISA_AUTO);
+  }
+  return mandelIsa;
+}
+
+/**
+ * \param maxIter maximum number of iterations.
+ * \return maxIter as a 32-bit lane limit: counts start at 1, so a limit of
+ * at most 0 stops every lane after the first iteration, like mandel_calc.
+ */
+static int lane_limit(index_t maxIter)
+{
+  if (maxIter < 0) {
+    return 0;
+  }
+  return (int)std::min(maxIter, (index_t)0x7fffffff);
+}
+
+#ifdef MANDEL_AVX
+
+/**
+ * 16 points per vector, with a mask register of active lanes.
+ * \return Number of points done (a multiple of 16).
+ */
+MANDEL_TARGET("avx512f")
+static index_t mandel_points_avx512(INT_TYPE* values, const float* x,
+    const float* y, bool column, index_t count, int maxIter, float infinity)
+{
+  const __m512 two = _mm512_set1_ps(2.0f);
+  const __m512 vinfinity = _mm512_set1_ps(infinity);
+  const __m512i one = _mm512_set1_epi32(1);
+  const __m512i limit = _mm512_set1_epi32(maxIter);
+  index_t c;
+
+  for (c = 0; c + 16 <= count; c += 16) {
+    __m512 vx = column ? _mm512_set1_ps(*x) : _mm512_loadu_ps(x + c);
+    __m512 vy = column ? _mm512_loadu_ps(y + c) : _mm512_set1_ps(*y);
+    __m512 r = _mm512_setzero_ps(), i = _mm512_setzero_ps();
+    __m512 rs = _mm512_setzero_ps(), is = _mm512_setzero_ps();
+    __m512i iter = _mm512_setzero_si512();
+    __mmask16 active = 0xffff;
+
+    do {
+      i = _mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(two, r), i), vx);
+      r = _mm512_add_ps(_mm512_sub_ps(rs, is), vy);
+      iter = _mm512_mask_add_epi32(iter, active, iter, one);
+      rs = _mm512_mul_ps(r, r);
+      is = _mm512_mul_ps(i, i);
+      active = _mm512_mask_cmplt_epi32_mask(active, iter, limit)
+          & _mm512_mask_cmp_ps_mask(active, _mm512_add_ps(rs, is),
+              vinfinity, _CMP_LT_OQ);
+    } while (active != 0);
+
+    _mm512_storeu_si512((void*)(values + c), iter);
+  }
+  return c;
+}
+
+/**
+ * 8 points per vector; active lanes are all ones, so subtracting the mask
+ * counts them.
+ * \return Number of points done (a multiple of 8).
+ */
+MANDEL_TARGET("avx2")
+static index_t mandel_points_avx2(INT_TYPE* values, const float* x,
+    const float* y, bool column, index_t count, int maxIter, float infinity)
+{
+  const __m256 two = _mm256_set1_ps(2.0f);
+  const __m256 vinfinity = _mm256_set1_ps(infinity);
+  const __m256i limit = _mm256_set1_epi32(maxIter);
+  index_t c;
+
+  for (c = 0; c + 8 <= count; c += 8) {
+    __m256 vx = column ? _mm256_set1_ps(*x) : _mm256_loadu_ps(x + c);
+    __m256 vy = column ? _mm256_loadu_ps(y + c) : _mm256_set1_ps(*y);
+    __m256 r = _mm256_setzero_ps(), i = _mm256_setzero_ps();
+    __m256 rs = _mm256_setzero_ps(), is = _mm256_setzero_ps();
+    __m256i iter = _mm256_setzero_si256();
+    __m256i active = _mm256_set1_epi32(-1);
+
+    do {
+      i = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(two, r), i), vx);
+      r = _mm256_add_ps(_mm256_sub_ps(rs, is), vy);
+      iter = _mm256_sub_epi32(iter, active);
+      rs = _mm256_mul_ps(r, r);
+      is = _mm256_mul_ps(i, i);
+      __m256 bounded = _mm256_cmp_ps(_mm256_add_ps(rs, is), vinfinity,
+          _CMP_LT_OQ);
+      active = _mm256_and_si256(active,
+          _mm256_and_si256(_mm256_cmpgt_epi32(limit, iter),
+              _mm256_castps_si256(bounded)));
+    } while (!_mm256_testz_si256(active, active));
+
+    _mm256_storeu_si256((__m256i*)(values + c), iter);
+  }
+  return c;
+}
+
+#endif
+
+#ifdef MANDEL_SSE2
+
+/**
+ * 4 points per vector, like mandel_points_avx2.
+ * \return Number of points done (a multiple of 4).
+ */
+MANDEL_TARGET("sse2")
+static index_t mandel_points_sse2(INT_TYPE* values, const float* x,
+    const float* y, bool column, index_t count, int maxIter, float infinity)
+{
+  const __m128 two = _mm_set1_ps(2.0f);
+  const __m128 vinfinity = _mm_set1_ps(infinity);
+  const __m128i limit = _mm_set1_epi32(maxIter);
+  index_t c;
+
+  for (c = 0; c + 4 <= count; c += 4) {
+    __m128 vx = column ? _mm_set1_ps(*x) : _mm_loadu_ps(x + c);
+    __m128 vy = column ? _mm_loadu_ps(y + c) : _mm_set1_ps(*y);
+    __m128 r = _mm_setzero_ps(), i = _mm_setzero_ps();
+    __m128 rs = _mm_setzero_ps(), is = _mm_setzero_ps();
+    __m128i iter = _mm_setzero_si128();
+    __m128i active = _mm_set1_epi32(-1);
+
+    do {
+      i = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(two, r), i), vx);
+      r = _mm_add_ps(_mm_sub_ps(rs, is), vy);
+      iter = _mm_sub_epi32(iter, active);
+      rs = _mm_mul_ps(r, r);
+      is = _mm_mul_ps(i, i);
+      __m128 bounded = _mm_cmplt_ps(_mm_add_ps(rs, is), vinfinity);
+      active = _mm_and_si128(active,
+          _mm_and_si128(_mm_cmpgt_epi32(limit, iter),
+              _mm_castps_si128(bounded)));
+    } while (_mm_movemask_epi8(active) != 0);
+
+    _mm_storeu_si128((__m128i*)(values + c), iter);
+  }
+  return c;
+}
+
+#endif
+
+/**
+ * Widest vector of any path, in points.
+ */
+#define MANDEL_MAX_WIDTH 16
+
+/**
+ * \return Points per vector of the chosen instruction set (1 if scalar).
+ */
+static index_t mandel_width()
+{
+  switch (mandel_isa()) {
+  case MANDEL_ISA_AVX512:
+    return 16;
+  case MANDEL_ISA_AVX2:
+    return 8;
+  case MANDEL_ISA_SSE2:
+    return 4;
+  default:
+    return 1;
+  }
+}
+
+/**
+ * Runs the full vectors of points through the chosen instruction set.
+ * \param column whether the points share x[0] and take y from y[c] (if
+ * true), or share y[0] and take x from x[c] (if false).
+ * \return Number of points done (a multiple of the vector width).
+ */
+static index_t mandel_vectors(INT_TYPE* values, const real* x, const real* y,
+    bool column, index_t count, index_t maxIter, real infinity)
+{
+  switch (mandel_isa()) {
+#ifdef MANDEL_AVX
+  case MANDEL_ISA_AVX512:
+    return mandel_points_avx512(values, (const float*)x, (const float*)y,
+        column, count, lane_limit(maxIter), (float)infinity);
+  case MANDEL_ISA_AVX2:
+    return mandel_points_avx2(values, (const float*)x, (const float*)y,
+        column, count, lane_limit(maxIter), (float)infinity);
+#endif
+#ifdef MANDEL_SSE2
+  case MANDEL_ISA_SSE2:
+    return mandel_points_sse2(values, (const float*)x, (const float*)y,
+        column, count, lane_limit(maxIter), (float)infinity);
+#endif
+  default:
+    return 0;
+  }
+}
+
+/**
+ * Calculate the mandelbrot values of a row or a column of points (see
+ * mandel_vectors for column).
+ */
+static void mandel_points(INT_TYPE* values, const real* x, const real* y,
+    bool column, index_t count, index_t maxIter, real infinity)
+{
+  index_t done = mandel_vectors(values, x, y, column, count, maxIter,
+      infinity);
+  index_t left = count - done;
+  index_t width = mandel_width();
+
+  // two or more points left over: one more vector, padded with copies of
+  // the last point so that the extra lanes take no longer
+  if ((left > 1) && (width > 1)) {
+    real padded[MANDEL_MAX_WIDTH];
+    INT_TYPE paddedValues[MANDEL_MAX_WIDTH];
+    const real* varying = column ? y : x;
+
+    for (index_t i = 0; i < width; i++) {
+      padded[i] = varying[done + std::min(i, left - 1)];
+    }
+    mandel_vectors(paddedValues, column ? x : padded, column ? padded : y,
+        column, width, maxIter, infinity);
+    std::copy(paddedValues, paddedValues + left, values + done);
+    return;
+  }
+
+  for (index_t c = done; c < count; c++) {
+    values[c] = mandel_calc(column ? x[0] : x[c], column ? y[c] : y[0],
+        maxIter, infinity);
+  }
+}
+
+void mandel_row(INT_TYPE* values, const real* x, index_t count, real y,
+    index_t maxIter, real infinity)
+{
+  mandel_points(values, x, &y, false, count, maxIter, infinity);
+}
+
+void mandel_column(INT_TYPE* values, real x, const real* y, index_t count,
+    index_t maxIter, real infinity)
+{
+  mandel_points(values, &x, y, true, count, maxIter, infinity);
+}
+
+real mandel_coordinate(real origin, index_t index, real step)
+{
+  return origin + (index * step);
+}
+
+void mandel_columns(real* x, index_t nc, real x0, real dx, index_t first,
+    bool halved)
+{
+  index_t middle = (nc + 1) / 2;
+
+  for (index_t c = 0; c < nc; c++) {
+    x[c] = mandel_coordinate(x0,
+        first + (halved ? half_source(c, middle) : c), dx);
+  }
+}
+
@@ -0,0 +1,113 @@
+/**
+ * \file mandel_kernel.hpp
+ * \brief Mandelbrot iteration shared by all implementations, vectorized over
+ * the columns of a row.
+ */
+
+#ifndef __mandel_kernel_hpp__
+#define __mandel_kernel_hpp__
+
+/**
+ * \brief Instruction sets mandel_row can use.
+ */
+enum MandelIsa {
+  MANDEL_ISA_AUTO,     ///< the widest one the processor supports.
+  MANDEL_ISA_SCALAR,   ///< one point at a time.
+  MANDEL_ISA_SSE2,     ///< 4 points per vector.
+  MANDEL_ISA_AVX2,     ///< 8 points per vector.
+  MANDEL_ISA_AVX512    ///< 16 points per vector.
+};
+
+/**
+ * Choose the instruction set for later calls to mandel_row. Exits through
+ * bad_argument if the processor (or the build) does not support it.
+ * \param isa instruction set, or MANDEL_ISA_AUTO.
+ */
+void mandel_set_isa(MandelIsa isa);
+
+/**
+ * \return The instruction set mandel_row uses (never MANDEL_ISA_AUTO).
+ */
+MandelIsa mandel_isa();
+
+/**
+ * Calculate mandelbrot value.
+ * \param x x-coordinate.
+ * \param y y-coordinate.
+ * \param maxIter maximum number of iterations.
+ * \param infinity squared magnitude considered divergent.
+ * \return Mandelbrot value.
+ */
+inline INT_TYPE mandel_calc(real x, real y, index_t maxIter, real infinity)
+{
+  real r = 0.0, i = 0.0; // real and imaginary parts
+  real rs = 0.0, is = 0.0; // " ", squared
+  INT_TYPE iter = 0; // number of iterations
+
+  do {
+    i = (((real)2.0) * r * i) + x;
+    r = (rs - is) + y;
+    iter++;
+    rs = r * r;
+    is = i * i;
+  } while ((iter < maxIter) && ((rs + is) < infinity));
+
+  return iter;
+}
+
+/**
+ * Calculate the mandelbrot values of points that share y. Vectors of
+ * consecutive points iterate together; a lane that escapes (or reaches
+ * maxIter) stops counting, and the vector stops when all lanes have. The
+ * points after the last full vector go through one more, padded with copies
+ * of the last point. Every value equals that of mandel_calc.
+ * \param values where to store the values.
+ * \param x x-coordinate of each point.
+ * \param count number of points.
+ * \param y y-coordinate of all points.
+ * \param maxIter maximum number of iterations.
+ * \param infinity squared magnitude considered divergent.
+ */
+void mandel_row(INT_TYPE* values, const real* x, index_t count, real y,
+    index_t maxIter, real infinity);
+
+/**
+ * Calculate the mandelbrot values of points that share x, like mandel_row.
+ * \param values where to store the values.
+ * \param x x-coordinate of all points.
+ * \param y y-coordinate of each point.
+ * \param count number of points.
+ * \param maxIter maximum number of iterations.
+ * \param infinity squared magnitude considered divergent.
+ */
+void mandel_column(INT_TYPE* values, real x, const real* y, index_t count,
+    index_t maxIter, real infinity);
+
+/**
+ * The coordinate of a point of the mandel lattice, origin + index * step.
+ * Every mandel computes its points through this, so that points with the
+ * same index are bit-identical whichever viewport or cached tile they are
+ * computed for.
+ * \param origin coordinate of index 0.
+ * \param index the point, in steps from the origin.
+ * \param step step between points.
+ * \return The coordinate.
+ */
+real mandel_coordinate(real origin, index_t index, real step);
+
+/**
+ * Compute the x-coordinates of the columns of a mandel matrix,
+ * x0 + (first + c) * dx, or those of the columns that half would move to
+ * each place. The same gives the y-coordinates of the rows.
+ * \param x where to store nc coordinates.
+ * \param nc number of columns.
+ * \param x0 x-coordinate of the lattice origin.
+ * \param dx step between columns.
+ * \param first lattice column of the first column.
+ * \param halved whether column c takes the coordinate of half_source(c).
+ */
+void mandel_columns(real* x, index_t nc, real x0, real dx, index_t first,
+    bool halved);
+
+#endif
+
@@ -0,0 +1,257 @@
+/**
+ * \file mandel_subdivide.cpp
+ * \brief Mandel by rectangle subdivision (Mariani-Silver).
+ * \see Cowichan::mandelRectangles
+ */
+
+#include "cowichan.hpp"
+
+namespace
+{
+
+/**
+ * Smallest squared magnitude at which the cardioid and bulb test is exact:
+ * the orbits of their points stay below 1.62.
+ */
+const real MANDEL_BOUNDED_INFINITY = 2.0;
+
+/**
+ * Relative slack of the cardioid and bulb test, which keeps it away from
+ * their boundaries, where rounding could let an orbit escape.
+ */
+const double MANDEL_INSIDE_SLACK = 1e-3;
+
+/**
+ * Whether a point lies in the main cardioid or the period-2 bulb, where
+ * mandel_calc runs to maxIter. Rows are the real axis of the iteration.
+ * \param x x-coordinate (imaginary part).
+ * \param y y-coordinate (real part).
+ */
+inline bool mandel_inside(real x, real y)
+{
+  double im2 = (double)x * x;
+  double re = (double)y + 1.0;
+
+  // bulb: |c + 1| < 1/4
+  if (re * re + im2 < 0.0625 * (1.0 - MANDEL_INSIDE_SLACK)) {
+    return true;
+  }
+
+  // cardioid: q (q + re - 1/4) < im^2 / 4, with q = |c - 1/4|^2
+  re = (double)y - 0.25;
+  double q = re * re + im2;
+  return q * (q + re) < 0.25 * im2 * (1.0 - MANDEL_INSIDE_SLACK);
+}
+
+/**
+ * \brief Fills tiles of the mandel matrix, each by recursive subdivision.
+ *
+ * The border of a rectangle is computed first. If it has a single value
+ * below maxIter the interior is filled with it; otherwise the rectangle is
+ * split in two along its longer side, the dividing line is computed, and
+ * both halves are handled the same way. Small rectangles are computed point
+ * by point.
+ *
+ * Borders at maxIter are not trusted: their points lie close to the set,
+ * where channels of slowly escaping points narrower than a pixel pass
+ * between two of them (near the point where a bulb touches the cardioid,
+ * for instance). The interior of the cardioid and the bulb is found by
+ * mandel_inside instead.
+ */
+class MandelTileTask: public RowTask {
+public:
+
+  /**
+   * Construct the task.
+   * \param view the mandel matrix.
+   * \param x x-coordinate of each column.
+   * \param y y-coordinate of each row.
+   * \param maxIter maximum number of iterations.
+   * \param infinity squared magnitude considered divergent.
+   */
+  MandelTileTask(const MatrixView<INT_TYPE>& view, const real* x,
+      const real* y, index_t maxIter, real infinity): view(view), x(x), y(y),
+      maxIter(maxIter), infinity(infinity),
+      tilesAcross((view.cols() + TILE - 1) / TILE)
+  {
+    analytic = (maxIter >= 1) && (infinity >= MANDEL_BOUNDED_INFINITY);
+  }
+
+  /**
+   * \return Number of tiles, the rows of this task.
+   */
+  index_t tiles() const {
+    return tilesAcross * ((view.rows() + TILE - 1) / TILE);
+  }
+
+  index_t run(index_t first, index_t last) {
+    for (index_t t = first; t < last; t++) {
+      index_t r0 = (t / tilesAcross) * TILE;
+      index_t c0 = (t % tilesAcross) * TILE;
+      index_t r1 = std::min(r0 + TILE, view.rows()) - 1;
+      index_t c1 = std::min(c0 + TILE, view.cols()) - 1;
+
+      // border, then the interior
+      rowSegment(r0, c0, c1 + 1);
+      if (r1 > r0) {
+        rowSegment(r1, c0, c1 + 1);
+      }
+      columnSegment(c0, r0 + 1, r1);
+      if (c1 > c0) {
+        columnSegment(c1, r0 + 1, r1);
+      }
+      rectangle(r0, c0, r1, c1);
+    }
+    return 0;
+  }
+
+private:
+
+  /**
+   * Side of the tiles.
+   */
+  static const index_t TILE = MANDEL_SUBDIVIDE_TILE;
+
+  /**
+   * Computes points [first, last) of row r.
+   */
+  void rowSegment(index_t r, index_t first, index_t last) {
+    INT_TYPE* RESTRICT row = view.row(r);
+    real yr = y[r];
+
+    if (!analytic) {
+      mandel_row(row + first, x + first, last - first, yr, maxIter,
+          infinity);
+      return;
+    }
+
+    // runs of points outside the cardioid and bulb go to the kernel
+    index_t run = first;
+    for (index_t c = first; c < last; c++) {
+      if (mandel_inside(x[c], yr)) {
+        mandel_row(row + run, x + run, c - run, yr, maxIter, infinity);
+        row[c] = (INT_TYPE)maxIter;
+        run = c + 1;
+      }
+    }
+    mandel_row(row + run, x + run, last - run, yr, maxIter, infinity);
+  }
+
+  /**
+   * Computes rows [first, last) of column c.
+   */
+  void columnSegment(index_t c, index_t first, index_t last) {
+    INT_TYPE values[TILE];
+    index_t run = first;
+
+    // as in rowSegment, into values
+    if (analytic) {
+      for (index_t r = first; r < last; r++) {
+        if (mandel_inside(x[c], y[r])) {
+          mandel_column(values + (run - first), x[c], y + run, r - run,
+              maxIter, infinity);
+          values[r - first] = (INT_TYPE)maxIter;
+          run = r + 1;
+        }
+      }
+    }
+    mandel_column(values + (run - first), x[c], y + run, last - run,
+        maxIter, infinity);
+
+    for (index_t r = first; r < last; r++) {
+      view(r, c) = values[r - first];
+    }
+  }
+
+  /**
+   * Fills the interior of the rectangle from (r0, c0) to (r1, c1)
+   * inclusive, whose border has been computed.
+   */
+  void rectangle(index_t r0, index_t c0, index_t r1, index_t c1) {
+    if ((r1 - r0 < 2) || (c1 - c0 < 2)) {
+      return;  // no interior
+    }
+
+    // is the border uniform?
+    INT_TYPE value = view(r0, c0);
+    bool uniform = true;
+    for (index_t c = c0; uniform && (c <= c1); c++) {
+      uniform = (view(r0, c) == value) && (view(r1, c) == value);
+    }
+    for (index_t r = r0 + 1; uniform && (r < r1); r++) {
+      uniform = (view(r, c0) == value) && (view(r, c1) == value);
+    }
+
+    if (uniform && (value != (INT_TYPE)maxIter)) {
+      for (index_t r = r0 + 1; r < r1; r++) {
+        std::fill(view.row(r) + c0 + 1, view.row(r) + c1, value);
+      }
+    }
+    else if ((r1 - r0 - 1) * (c1 - c0 - 1) <= MANDEL_MIN_RECTANGLE) {
+      for (index_t r = r0 + 1; r < r1; r++) {
+        rowSegment(r, c0 + 1, c1);
+      }
+    }
+    else if (r1 - r0 >= c1 - c0) {
+      index_t middle = (r0 + r1) / 2;
+      rowSegment(middle, c0 + 1, c1);
+      rectangle(r0, c0, middle, c1);
+      rectangle(middle, c0, r1, c1);
+    }
+    else {
+      index_t middle = (c0 + c1) / 2;
+      columnSegment(middle, r0 + 1, r1);
+      rectangle(r0, c0, r1, middle);
+      rectangle(r0, middle, r1, c1);
+    }
+  }
+
+  MatrixView<INT_TYPE> view;
+  const real* x;
+  const real* y;
+  index_t maxIter;
+  real infinity;
+  bool analytic;
+  index_t tilesAcross;
+
+};
+
+}
+
+void Cowichan::mandelRectangles(IntMatrix matrix)
+{
+  real* x = NULL;
+  real* y = NULL;
+
+  try {
+    x = NEW_VECTOR_SZ(real, nc);
+    y = NEW_VECTOR_SZ(real, nr);
+  }
+  catch (...) {out_of_memory();}
+
+  // the coordinates of the brute force
+  mandel_columns (x, nc, mandelX0, mandelDx / (nc - 1), mandelCol0,
+      false);
+  mandel_columns (y, nr, mandelY0, mandelDy / (nr - 1), mandelRow0,
+      false);
+
+  MandelTileTask task (rectView (matrix), x, y, mandelMaxIter,
+      mandelInfinity);
+  parallelRows (task.tiles (), task);
+
+  DELETE_ARRAY(x);
+  DELETE_ARRAY(y);
+}
+
+void Cowichan::computeMandel(IntMatrix matrix)
+{
+  if (mandelCacheBytes > 0) {
+    mandelCached (matrix);
+  }
+  else if (mandelSubdivide) {
+    mandelRectangles (matrix);
+  }
+  else {
+    mandel (matrix);
+  }
+}
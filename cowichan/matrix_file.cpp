@@ -0,0 +1,186 @@
+/**
+ * \file matrix_file.cpp
+ * \brief Implementation of binary matrix files.
+ */
+
+#include "cowichan.hpp"
+
+#if !defined(WIN64) && !defined(WIN32)   // Linux
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
+/**
+ * First bytes of every matrix file.
+ */
+static const char MAGIC[8] = {'C', 'O', 'W', 'I', 'C', 'H', 'A', 'N'};
+
+bool is_matrix_file(const char* path)
+{
+  char magic[sizeof(MAGIC)];
+  FILE* file = fopen (path, "rb");
+
+  if (file == NULL) {
+    return false;
+  }
+  bool found = (fread (magic, 1, sizeof(MAGIC), file) == sizeof(MAGIC))
+      && (memcmp (magic, MAGIC, sizeof(MAGIC)) == 0);
+  fclose (file);
+  return found;
+}
+
+#if defined(WIN64) || defined(WIN32)   // Windows
+
+MatrixFile::MatrixFile(const char* path): path(path), base(NULL), length(0),
+    header(NULL)
+{
+  // no mapping: read the whole file into an aligned block
+  FILE* file = fopen (path, "rb");
+  if (file == NULL) {
+    bad_argument ("Cannot open matrix file", path);
+  }
+  fseek (file, 0, SEEK_END);
+  length = (size_t) ftell (file);
+  fseek (file, 0, SEEK_SET);
+
+  try {
+    base = memory_alloc (length);
+  }
+  catch (...) {out_of_memory();}
+
+  if (fread (base, 1, length, file) != length) {
+    bad_argument ("Cannot read matrix file", path);
+  }
+  fclose (file);
+
+  header = (const MatrixFileHeader*) base;
+  checkHeader ();
+}
+
+MatrixFile::~MatrixFile()
+{
+  memory_free (base);
+}
+
+#else                // Linux
+
+MatrixFile::MatrixFile(const char* path): path(path), base(NULL), length(0),
+    header(NULL)
+{
+  int fd = open (path, O_RDONLY);
+  struct stat info;
+
+  if ((fd < 0) || (fstat (fd, &info) != 0)) {
+    bad_argument ("Cannot open matrix file", path);
+  }
+  length = (size_t) info.st_size;
+  if (length < sizeof(MatrixFileHeader)) {
+    bad_argument ("Not a matrix file", path);
+  }
+
+  // private: kernels may write to their inputs without touching the file
+  base = mmap (NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (base == MAP_FAILED) {
+    bad_argument ("Cannot map matrix file", path);
+  }
+
+  header = (const MatrixFileHeader*) base;
+  checkHeader ();
+}
+
+MatrixFile::~MatrixFile()
+{
+  munmap (base, length);
+}
+
+#endif
+
+void MatrixFile::checkHeader() const
+{
+  const char* name = path.c_str();
+
+  if ((length < sizeof(MatrixFileHeader))
+      || (memcmp (header->magic, MAGIC, sizeof(MAGIC)) != 0)
+      || (header->elementSize == 0)) {
+    bad_argument ("Not a matrix file", name);
+  }
+  if (header->byteOrder != MATRIX_FILE_BYTE_ORDER) {
+    bad_argument ("Matrix file has the other byte order", name);
+  }
+  if ((length - sizeof(MatrixFileHeader)) / header->elementSize
+      < header->rows * header->cols) {
+    bad_argument ("Matrix file is truncated", name);
+  }
+}
+
+void MatrixFile::check(MatrixFileType expected, size_t size) const
+{
+  if ((header->type != (UINT32) expected) || (header->elementSize != size)) {
+    bad_argument ("Matrix file has the wrong element type", path.c_str());
+  }
+}
+
+/*****************************************************************************/
+
+MatrixFileWriter::MatrixFileWriter(const char* path, MatrixFileType type,
+    size_t elementSize, index_t rows, index_t cols): path(path), file(NULL),
+    cols(cols), rowBytes(elementSize * cols)
+{
+  MatrixFileHeader header;
+
+  memset (&header, 0, sizeof(header));
+  memcpy (header.magic, MAGIC, sizeof(MAGIC));
+  header.byteOrder = MATRIX_FILE_BYTE_ORDER;
+  header.type = (UINT32) type;
+  header.elementSize = (UINT32) elementSize;
+  header.rows = (UINT64) rows;
+  header.cols = (UINT64) cols;
+
+  file = fopen (path, "wb");
+  if (file == NULL) {
+    bad_argument ("Cannot create matrix file", path);
+  }
+  if (fwrite (&header, sizeof(header), 1, file) != 1) {
+    bad_argument ("Cannot write matrix file", path);
+  }
+}
+
+MatrixFileWriter::~MatrixFileWriter()
+{
+  if (fclose (file) != 0) {
+    bad_argument ("Cannot write matrix file", path.c_str());
+  }
+}
+
+void MatrixFileWriter::write(const void* data, index_t rows)
+{
+  size_t bytes = rows * rowBytes;
+
+  if ((bytes > 0) && (fwrite (data, 1, bytes, file) != bytes)) {
+    bad_argument ("Cannot write matrix file", path.c_str());
+  }
+}
+
+void MatrixFileWriter::writeBits(const UINT64* words, index_t rows)
+{
+  index_t wordsPerRow = bit_row_words (cols);
+  bool* cells = NULL;
+
+  try {
+    cells = NEW_VECTOR_SZ(bool, cols);
+  }
+  catch (...) {out_of_memory();}
+
+  for (index_t r = 0; r < rows; r++) {
+    const UINT64* in = words + r * wordsPerRow;
+    for (index_t c = 0; c < cols; c++) {
+      cells[c] = (in[c / BITS_PER_WORD] >> (c % BITS_PER_WORD)) & 1;
+    }
+    write (cells, 1);
+  }
+
+  DELETE_ARRAY(cells);
+}
+
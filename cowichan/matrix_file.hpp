@@ -0,0 +1,275 @@
+/**
+ * \file matrix_file.hpp
+ * \brief Binary files holding one matrix or vector.
+ */
+
+#ifndef __matrix_file_hpp__
+#define __matrix_file_hpp__
+
+#include <cstdio>
+#include <string>
+
+/**
+ * Extension of matrix files.
+ */
+#define MATRIX_FILE_EXTENSION ".cwm"
+
+/**
+ * Written in every header by the producer; it reads back byte swapped on a
+ * machine with the other byte order.
+ */
+#define MATRIX_FILE_BYTE_ORDER 0x01020304
+
+/**
+ * \brief Element type of a matrix file.
+ */
+enum MatrixFileType {
+  MATRIX_FILE_INT = 1,   ///< INT_TYPE (IntMatrix, IntVector).
+  MATRIX_FILE_BOOL = 2,  ///< bool (BoolMatrix, BoolVector).
+  MATRIX_FILE_REAL = 3,  ///< real (Matrix, Vector).
+  MATRIX_FILE_POINT = 4  ///< Point (PointVector).
+};
+
+/**
+ * \brief Header at the start of a matrix file.
+ *
+ * The elements follow in row-major order, exactly as they are laid out in
+ * memory; vectors have one column. The header takes 64 bytes so that the
+ * elements of a mapped file are cache-line aligned.
+ */
+struct MatrixFileHeader {
+
+  /**
+   * "COWICHAN".
+   */
+  char magic[8];
+
+  /**
+   * MATRIX_FILE_BYTE_ORDER.
+   */
+  UINT32 byteOrder;
+
+  /**
+   * MatrixFileType of the elements.
+   */
+  UINT32 type;
+
+  /**
+   * Size of an element in bytes (real and INT_TYPE depend on the build).
+   */
+  UINT32 elementSize;
+
+  /**
+   * Always 0.
+   */
+  UINT32 reserved;
+
+  /**
+   * Matrix size.
+   */
+  UINT64 rows, cols;
+
+  /**
+   * Always 0.
+   */
+  char padding[24];
+
+};
+
+/**
+ * \param matrix any IntMatrix or IntVector.
+ * \return The file type of its elements.
+ */
+inline MatrixFileType matrix_file_type(const INT_TYPE* /* matrix */)
+{
+  return MATRIX_FILE_INT;
+}
+
+/**
+ * \param matrix any BoolMatrix or BoolVector.
+ * \return The file type of its elements.
+ */
+inline MatrixFileType matrix_file_type(const bool* /* matrix */)
+{
+  return MATRIX_FILE_BOOL;
+}
+
+/**
+ * \param matrix any Matrix or Vector.
+ * \return The file type of its elements.
+ */
+inline MatrixFileType matrix_file_type(const real* /* matrix */)
+{
+  return MATRIX_FILE_REAL;
+}
+
+/**
+ * \param points any PointVector.
+ * \return The file type of its elements.
+ */
+inline MatrixFileType matrix_file_type(const Point* /* points */)
+{
+  return MATRIX_FILE_POINT;
+}
+
+/**
+ * Check whether a file starts with a matrix file header.
+ * \param path path of the file.
+ * \return true if it does, false otherwise (or if it cannot be read).
+ */
+bool is_matrix_file(const char* path);
+
+/**
+ * \brief Read-only access to a matrix file, mapped into memory.
+ *
+ * The elements are used where they are, without parsing or copying: the
+ * pointer returned by data() can be passed straight to a kernel. Writes to
+ * it stay private to the process. Every error (missing file, bad header,
+ * other byte order, wrong element type) exits through bad_argument.
+ */
+class MatrixFile {
+public:
+
+  /**
+   * Map a matrix file.
+   * \param path path of the file.
+   */
+  explicit MatrixFile(const char* path);
+
+  ~MatrixFile();
+
+  /**
+   * \return Element type.
+   */
+  MatrixFileType type() const { return (MatrixFileType) header->type; }
+
+  /**
+   * \return Number of rows (number of elements for a vector).
+   */
+  index_t rows() const { return (index_t) header->rows; }
+
+  /**
+   * \return Number of columns (1 for a vector).
+   */
+  index_t cols() const { return (index_t) header->cols; }
+
+  /**
+   * \return The elements, checked to be of type T.
+   */
+  template <typename T>
+  T* data() const {
+    check(matrix_file_type((const T*) NULL), sizeof(T));
+    return (T*) (header + 1);
+  }
+
+private:
+
+  /**
+   * Exit unless the header is valid and matches the file length.
+   */
+  void checkHeader() const;
+
+  /**
+   * Exit unless the elements are of the given type and size.
+   */
+  void check(MatrixFileType expected, size_t size) const;
+
+  /**
+   * Path of the file, for error messages.
+   */
+  std::string path;
+
+  /**
+   * Start and length of the mapping (or of the copy where mapping is not
+   * available).
+   */
+  void* base;
+  size_t length;
+
+  /**
+   * Header at the start of the mapping.
+   */
+  const MatrixFileHeader* header;
+
+  // not copyable
+  MatrixFile(const MatrixFile&);
+  MatrixFile& operator=(const MatrixFile&);
+
+};
+
+/**
+ * \brief Writes a matrix file a band of rows at a time.
+ */
+class MatrixFileWriter {
+public:
+
+  /**
+   * Create (or truncate) a matrix file and write its header. Exits through
+   * bad_argument if the file cannot be created.
+   * \param path path of the file.
+   * \param type element type.
+   * \param elementSize size of an element in bytes.
+   * \param rows number of rows.
+   * \param cols number of columns.
+   */
+  MatrixFileWriter(const char* path, MatrixFileType type, size_t elementSize,
+      index_t rows, index_t cols);
+
+  ~MatrixFileWriter();
+
+  /**
+   * Append rows.
+   * \param data the rows, in row-major order.
+   * \param rows number of rows.
+   */
+  void write(const void* data, index_t rows);
+
+  /**
+   * Append rows of a bool file from packed rows (see BitMatrix).
+   * \param words the packed rows.
+   * \param rows number of rows.
+   */
+  void writeBits(const UINT64* words, index_t rows);
+
+private:
+
+  /**
+   * Path of the file, for error messages.
+   */
+  std::string path;
+
+  /**
+   * The open file.
+   */
+  FILE* file;
+
+  /**
+   * Number of columns, and bytes per row.
+   */
+  index_t cols;
+  size_t rowBytes;
+
+  // not copyable
+  MatrixFileWriter(const MatrixFileWriter&);
+  MatrixFileWriter& operator=(const MatrixFileWriter&);
+
+};
+
+/**
+ * Write a whole matrix or vector to a matrix file.
+ * \param path path of the file.
+ * \param data the elements.
+ * \param rows number of rows (number of elements for a vector).
+ * \param cols number of columns (1 for a vector).
+ */
+template <typename T>
+void matrix_file_write(const char* path, const T* data, index_t rows,
+    index_t cols)
+{
+  MatrixFileWriter writer(path, matrix_file_type(data), sizeof(T), rows,
+      cols);
+  writer.write(data, rows);
+}
+
+#endif
+
@@ -0,0 +1,118 @@
+/**
+ * \file matrix_view.hpp
+ * \brief Strided view of a matrix stored in row-major order.
+ */
+
+#ifndef __matrix_view_hpp__
+#define __matrix_view_hpp__
+
+/**
+ * \def RESTRICT
+ * Restrict qualifier: the pointer is the only way its memory is reached in
+ * its scope. Use it on row pointers taken from MatrixView::row.
+ */
+#if defined(_MSC_VER)
+#define RESTRICT __restrict
+#elif defined(__GNUC__)
+#define RESTRICT __restrict__
+#else
+#define RESTRICT
+#endif
+
+/**
+ * \brief Row-major matrix of T with a row stride that may exceed its width.
+ *
+ * A view does not own its elements. Copying a view is cheap, and block()
+ * gives a view of a sub-matrix sharing the same stride, for tiled kernels.
+ * Hot loops should take a RESTRICT row pointer with row() so that the
+ * compiler knows rows of different views do not alias.
+ */
+template <typename T>
+class MatrixView {
+public:
+
+  /**
+   * View a dense rows x cols matrix.
+   * \param data first element.
+   * \param rows number of rows.
+   * \param cols number of columns.
+   */
+  MatrixView(T* data, index_t rows, index_t cols): data(data), numRows(rows),
+      numCols(cols), rowStride(cols) { }
+
+  /**
+   * View a rows x cols matrix whose rows start stride elements apart.
+   * \param data first element.
+   * \param rows number of rows.
+   * \param cols number of columns.
+   * \param stride distance between the starts of two rows, in elements.
+   */
+  MatrixView(T* data, index_t rows, index_t cols, index_t stride): data(data),
+      numRows(rows), numCols(cols), rowStride(stride) { }
+
+  /**
+   * Access an element.
+   * \param r row.
+   * \param c column.
+   * \return The element.
+   */
+  T& operator()(index_t r, index_t c) const {
+    return data[r * rowStride + c];
+  }
+
+  /**
+   * \param r row.
+   * \return Pointer to the first element of row r.
+   */
+  T* row(index_t r) const {
+    return data + r * rowStride;
+  }
+
+  /**
+   * View a sub-matrix.
+   * \param r first row.
+   * \param c first column.
+   * \param rows number of rows.
+   * \param cols number of columns.
+   * \return The sub-matrix, with the same stride.
+   */
+  MatrixView<T> block(index_t r, index_t c, index_t rows, index_t cols) const {
+    return MatrixView<T>(row(r) + c, rows, cols, rowStride);
+  }
+
+  /**
+   * \return Number of rows.
+   */
+  index_t rows() const { return numRows; }
+
+  /**
+   * \return Number of columns.
+   */
+  index_t cols() const { return numCols; }
+
+  /**
+   * \return Distance between the starts of two rows, in elements.
+   */
+  index_t stride() const { return rowStride; }
+
+private:
+
+  /**
+   * First element.
+   */
+  T* data;
+
+  /**
+   * Matrix size.
+   */
+  index_t numRows, numCols;
+
+  /**
+   * Row stride in elements.
+   */
+  index_t rowStride;
+
+};
+
+#endif
+
@@ -0,0 +1,237 @@
+/**
+ * \file memory.cpp
+ * \brief Implementation of aligned allocation.
+ */
+
+#include "memory.hpp"
+#include <cstdlib>
+
+#if defined(WIN64) || defined(WIN32)   // Windows
+#include <windows.h>
+#else                // Linux
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Bookkeeping stored just before every block returned by memory_alloc.
+ */
+struct BlockHeader {
+
+  /**
+   * Start of the underlying allocation.
+   */
+  void* base;
+
+  /**
+   * Length of the underlying allocation in bytes.
+   */
+  size_t length;
+
+  /**
+   * Whether the allocation was mapped (munmap) or malloc'ed (free).
+   */
+  bool mapped;
+
+};
+
+/**
+ * Current huge page mode.
+ */
+static HugePageMode hugePages = HUGE_PAGES_THP;
+
+/**
+ * Bytes currently allocated, and the high-water mark.
+ */
+static size_t bytesInUse = 0, bytesPeak = 0;
+
+/**
+ * Account for an allocation (positive) or a free (negative). Allocations may
+ * come from several threads; the peak update itself is not atomic and may
+ * miss a concurrent maximum, which is fine for reporting.
+ */
+static void account(ptrdiff_t bytes)
+{
+#if defined(__GNUC__)
+  size_t now = __sync_add_and_fetch(&bytesInUse, (size_t)bytes);
+#else
+  size_t now = (bytesInUse += (size_t)bytes);
+#endif
+  if (now > bytesPeak) {
+    bytesPeak = now;
+  }
+}
+
+void memory_set_huge_pages(HugePageMode mode)
+{
+  hugePages = mode;
+}
+
+HugePageMode memory_huge_pages()
+{
+  return hugePages;
+}
+
+/**
+ * Round value up to a multiple of alignment (a power of two).
+ */
+static inline size_t round_up(size_t value, size_t alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * Allocate a small block with malloc, aligned to CACHE_LINE_SIZE.
+ */
+static void* alloc_small(size_t bytes)
+{
+  size_t length = bytes + CACHE_LINE_SIZE + sizeof(BlockHeader);
+  void* base = malloc(length);
+  if (base == NULL) {
+    throw std::bad_alloc();
+  }
+
+  char* block = (char*) round_up((size_t) base + sizeof(BlockHeader),
+      CACHE_LINE_SIZE);
+  BlockHeader* header = ((BlockHeader*) block) - 1;
+  header->base = base;
+  header->length = length;
+  header->mapped = false;
+  return block;
+}
+
+#if defined(WIN64) || defined(WIN32)
+
+static void* alloc_large(size_t bytes)
+{
+  return alloc_small(bytes);
+}
+
+static void free_large(BlockHeader*) { }
+
+#else
+
+/**
+ * Map a large block directly. The block is page aligned, or aligned to
+ * MEMORY_HUGE_PAGE and rounded up to whole huge pages when huge pages are
+ * requested (according to hugePages), since only aligned 2MB ranges can be
+ * backed by them. The page before the block holds the header, outside the
+ * aligned range.
+ */
+static void* alloc_large(size_t bytes)
+{
+  size_t page = (size_t) sysconf(_SC_PAGESIZE);
+  size_t align = (hugePages == HUGE_PAGES_NONE) ? page : MEMORY_HUGE_PAGE;
+  size_t data = round_up(bytes, align);
+  size_t length = 0;
+  void* base = MAP_FAILED;
+  char* block = NULL;
+
+#ifdef MAP_HUGETLB
+  if (hugePages == HUGE_PAGES_HUGETLB) {
+    // the pool maps whole aligned huge pages, so the header takes one; fall
+    // back if the pool is empty.
+    length = align + data;
+    base = mmap(NULL, length, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    block = (char*) base + align;
+  }
+#endif
+
+  if (base == MAP_FAILED) {
+    // map enough to move the block onto an aligned boundary past the header
+    // page, then unmap the rest
+    length = align + data;
+    base = mmap(NULL, length, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    block = (char*) round_up((size_t) base + page, align);
+
+    char* start = block - page;
+    char* end = block + data;
+    if (start > (char*) base) {
+      munmap(base, start - (char*) base);
+    }
+    if (end < (char*) base + length) {
+      munmap(end, (char*) base + length - end);
+    }
+    base = start;
+    length = page + data;
+#ifdef MADV_HUGEPAGE
+    if (hugePages != HUGE_PAGES_NONE) {
+      madvise(block, data, MADV_HUGEPAGE);
+    }
+#endif
+  }
+
+  BlockHeader* header = ((BlockHeader*) block) - 1;
+  header->base = base;
+  header->length = length;
+  header->mapped = true;
+  return block;
+}
+
+/**
+ * Unmap a block mapped by alloc_large.
+ */
+static void free_large(BlockHeader* header)
+{
+  munmap(header->base, header->length);
+}
+
+#endif
+
+void* memory_alloc(size_t bytes)
+{
+  void* block = (bytes >= MEMORY_MAP_THRESHOLD) ? alloc_large(bytes)
+      : alloc_small(bytes);
+  account((ptrdiff_t)(((BlockHeader*) block) - 1)->length);
+  return block;
+}
+
+void memory_free(void* block)
+{
+  if (block == NULL) {
+    return;
+  }
+
+  BlockHeader* header = ((BlockHeader*) block) - 1;
+  account(-(ptrdiff_t)header->length);
+  if (header->mapped) {
+    free_large(header);
+  }
+  else {
+    free(header->base);
+  }
+}
+
+void memory_prefault(void* block, size_t bytes)
+{
+#if defined(WIN64) || defined(WIN32)
+  size_t page = 4096;
+#else
+  size_t page = (size_t) sysconf(_SC_PAGESIZE);
+#endif
+  volatile char* p = (volatile char*) block;
+  for (size_t i = 0; i < bytes; i += page) {
+    p[i] = p[i];
+  }
+}
+
+size_t memory_in_use()
+{
+  return bytesInUse;
+}
+
+size_t memory_peak()
+{
+  return bytesPeak;
+}
+
+void memory_reset_peak()
+{
+  bytesPeak = bytesInUse;
+}
+
@@ -0,0 +1,129 @@
+/**
+ * \file memory.hpp
+ * \brief Aligned allocation of matrices and vectors for Cowichan programs.
+ */
+
+#ifndef __memory_hpp__
+#define __memory_hpp__
+
+#include <cstddef>
+#include <new>
+
+/**
+ * Alignment of every block returned by memory_alloc (one cache line).
+ */
+#define CACHE_LINE_SIZE 64
+
+/**
+ * Blocks of at least this many bytes are mapped directly from the operating
+ * system, page aligned, and are candidates for huge pages.
+ */
+#define MEMORY_MAP_THRESHOLD (1 << 20)
+
+/**
+ * Size of the huge pages requested for mapped blocks, which are aligned to
+ * it unless huge pages are off.
+ */
+#define MEMORY_HUGE_PAGE (2 << 20)
+
+/**
+ * \brief How large blocks are backed by huge pages.
+ */
+enum HugePageMode {
+  HUGE_PAGES_NONE,    ///< regular pages only.
+  HUGE_PAGES_THP,     ///< ask for transparent huge pages (madvise).
+  HUGE_PAGES_HUGETLB  ///< map from the hugetlbfs pool, falling back to THP.
+};
+
+/**
+ * Set the huge page mode for subsequent allocations.
+ * \param mode huge page mode.
+ */
+void memory_set_huge_pages(HugePageMode mode);
+
+/**
+ * \return The current huge page mode.
+ */
+HugePageMode memory_huge_pages();
+
+/**
+ * Allocate a block aligned to CACHE_LINE_SIZE. Blocks of at least
+ * MEMORY_MAP_THRESHOLD bytes are page aligned, or MEMORY_HUGE_PAGE aligned
+ * and rounded up to whole huge pages unless huge pages are off. The memory is
+ * not touched.
+ * \param bytes size of the block.
+ * \return The block.
+ * \throws std::bad_alloc if the memory cannot be allocated.
+ */
+void* memory_alloc(size_t bytes);
+
+/**
+ * Free a block returned by memory_alloc (NULL is ignored).
+ * \param block the block.
+ */
+void memory_free(void* block);
+
+/**
+ * Touch every page of a block so that later writes do not page fault. Pages
+ * already touched (for example by Cowichan::firstTouch) are left in place.
+ * \param block the block.
+ * \param bytes size of the block.
+ */
+void memory_prefault(void* block, size_t bytes);
+
+/**
+ * \return Bytes currently allocated with memory_alloc, including alignment
+ * and page rounding.
+ */
+size_t memory_in_use();
+
+/**
+ * \return Highest value of memory_in_use() since the last memory_reset_peak.
+ */
+size_t memory_peak();
+
+/**
+ * Restart peak tracking from the current memory_in_use().
+ */
+void memory_reset_peak();
+
+/**
+ * Default-construct count elements in place. Construction of plain types
+ * costs nothing and leaves the pages untouched.
+ * \param array uninitialised memory for count elements.
+ * \param count number of elements.
+ * \return The array.
+ */
+template <typename T>
+T* memory_construct(T* array, size_t count)
+{
+  for (size_t i = 0; i < count; i++) {
+    new (array + i) T;
+  }
+  return array;
+}
+
+/**
+ * Allocate an array of count default-constructed elements with memory_alloc.
+ * \param count number of elements.
+ * \return The array.
+ */
+template <typename T>
+T* memory_new(size_t count)
+{
+  return memory_construct((T*) memory_alloc(count * sizeof(T)), count);
+}
+
+/**
+ * Free an array allocated with memory_new. Destructors are not run: every
+ * Cowichan element type has a trivial destructor.
+ * \param array the array.
+ */
+template <typename T>
+void memory_delete(T* array)
+{
+  memory_free((void*) array);
+}
+
+#endif
+
@@ -0,0 +1,89 @@
+/**
+ * \file memory_plan.cpp
+ * \brief Implementation of the offline memory planner.
+ */
+
+#include "cowichan.hpp"
+
+namespace
+{
+
+/**
+ * Orders buffer numbers by decreasing size.
+ */
+class LargerFirst {
+public:
+  LargerFirst(const std::vector<size_t>& sizes): sizes(sizes) { }
+  bool operator()(index_t a, index_t b) const {
+    return (sizes[a] > sizes[b]) || ((sizes[a] == sizes[b]) && (a < b));
+  }
+private:
+  const std::vector<size_t>& sizes;
+};
+
+}
+
+MemoryPlan::MemoryPlan(): arenaBytes(0) { }
+
+index_t MemoryPlan::add(size_t bytes, index_t first, index_t last)
+{
+  Buffer buffer;
+  buffer.bytes = (bytes + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+  buffer.first = first;
+  buffer.last = last;
+  buffer.offset = 0;
+  buffers.push_back(buffer);
+  return (index_t)buffers.size() - 1;
+}
+
+void MemoryPlan::plan()
+{
+  std::vector<size_t> sizes;
+  std::vector<index_t> order, placed;
+  index_t i, j, k;
+
+  for (i = 0; i < (index_t)buffers.size(); i++) {
+    sizes.push_back(buffers[i].bytes);
+    order.push_back(i);
+  }
+  std::sort(order.begin(), order.end(), LargerFirst(sizes));
+
+  arenaBytes = 0;
+  for (i = 0; i < (index_t)order.size(); i++) {
+    Buffer& buffer = buffers[order[i]];
+
+    // placed buffers live at the same time, by offset
+    std::vector<std::pair<size_t, size_t> > busy;
+    for (j = 0; j < (index_t)placed.size(); j++) {
+      const Buffer& other = buffers[placed[j]];
+      if ((other.first <= buffer.last) && (buffer.first <= other.last)) {
+        busy.push_back(std::make_pair(other.offset,
+            other.offset + other.bytes));
+      }
+    }
+    std::sort(busy.begin(), busy.end());
+
+    // lowest gap that fits
+    size_t offset = 0;
+    for (k = 0; k < (index_t)busy.size(); k++) {
+      if (offset + buffer.bytes <= busy[k].first) {
+        break;
+      }
+      offset = std::max(offset, busy[k].second);
+    }
+
+    buffer.offset = offset;
+    arenaBytes = std::max(arenaBytes, offset + buffer.bytes);
+    placed.push_back(order[i]);
+  }
+}
+
+size_t MemoryPlan::totalSize() const
+{
+  size_t total = 0;
+  for (size_t i = 0; i < buffers.size(); i++) {
+    total += buffers[i].bytes;
+  }
+  return total;
+}
+
@@ -0,0 +1,79 @@
+/**
+ * \file memory_plan.hpp
+ * \brief Placement of buffers with known lifetimes in a single arena.
+ */
+
+#ifndef __memory_plan_hpp__
+#define __memory_plan_hpp__
+
+/**
+ * \brief Offline memory planner.
+ *
+ * Buffers are described by their size and the range of steps during which
+ * they are live. plan() gives every buffer an offset in one arena so that
+ * buffers that are live at the same step never overlap, while buffers with
+ * disjoint lifetimes may share memory. Offsets are multiples of
+ * CACHE_LINE_SIZE.
+ */
+class MemoryPlan {
+public:
+
+  MemoryPlan();
+
+  /**
+   * Add a buffer.
+   * \param bytes size of the buffer.
+   * \param first first step at which the buffer is live.
+   * \param last last step at which the buffer is live.
+   * \return Buffer number, counting from 0 in the order of the calls.
+   */
+  index_t add(size_t bytes, index_t first, index_t last);
+
+  /**
+   * Assign offsets to all buffers, largest first, each at the lowest offset
+   * that does not overlap a placed buffer with an overlapping lifetime.
+   */
+  void plan();
+
+  /**
+   * \param buffer buffer number.
+   * \return Offset of the buffer in the arena.
+   */
+  size_t offset(index_t buffer) const { return buffers[buffer].offset; }
+
+  /**
+   * \return Size of the arena needed by the plan.
+   */
+  size_t size() const { return arenaBytes; }
+
+  /**
+   * \return Sum of all buffer sizes (the arena size without reuse).
+   */
+  size_t totalSize() const;
+
+private:
+
+  /**
+   * \brief A planned buffer.
+   */
+  struct Buffer {
+    size_t bytes;  ///< size, rounded up to CACHE_LINE_SIZE.
+    index_t first; ///< first live step.
+    index_t last;  ///< last live step.
+    size_t offset; ///< offset in the arena.
+  };
+
+  /**
+   * Buffers in the order they were added.
+   */
+  std::vector<Buffer> buffers;
+
+  /**
+   * Arena size after plan().
+   */
+  size_t arenaBytes;
+
+};
+
+#endif
+
@@ -0,0 +1,142 @@
+/**
+ * \file perf_counters.cpp
+ * \brief Implementation of hardware performance counters.
+ */
+
+#include "cowichan.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+const char* PerfCounters::name(PerfCounter counter)
+{
+  switch (counter) {
+  case PERF_CYCLES:
+    return "cycles";
+  case PERF_INSTRUCTIONS:
+    return "instructions";
+  case PERF_LLC_MISSES:
+    return "llc_misses";
+  case PERF_BRANCH_MISSES:
+    return "branch_misses";
+  case PERF_DTLB_MISSES:
+    return "dtlb_misses";
+  default:
+    return "";
+  }
+}
+
+bool PerfCounters::any() const
+{
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    if (fd[i] >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#if defined(__linux__)
+
+/**
+ * Open one counter for the calling thread and the threads it creates.
+ * \param type event type (PERF_TYPE_*).
+ * \param config event within the type.
+ * \return File descriptor, or -1 if the event is not available.
+ */
+static int open_counter(UINT32 type, UINT64 config)
+{
+  struct perf_event_attr attr;
+
+  memset (&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.inherit = 1;
+  // user space only: allowed with perf_event_paranoid up to 2
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+      | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  return (int) syscall (SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/**
+ * \param cache PERF_COUNT_HW_CACHE_* cache.
+ * \return Config of the read misses of the cache.
+ */
+static UINT64 cache_read_misses(UINT64 cache)
+{
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+      | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+PerfCounters::PerfCounters()
+{
+  fd[PERF_CYCLES] = open_counter (PERF_TYPE_HARDWARE,
+      PERF_COUNT_HW_CPU_CYCLES);
+  fd[PERF_INSTRUCTIONS] = open_counter (PERF_TYPE_HARDWARE,
+      PERF_COUNT_HW_INSTRUCTIONS);
+  fd[PERF_LLC_MISSES] = open_counter (PERF_TYPE_HW_CACHE,
+      cache_read_misses (PERF_COUNT_HW_CACHE_LL));
+  if (fd[PERF_LLC_MISSES] < 0) {
+    // generic cache misses are last level misses on most processors
+    fd[PERF_LLC_MISSES] = open_counter (PERF_TYPE_HARDWARE,
+        PERF_COUNT_HW_CACHE_MISSES);
+  }
+  fd[PERF_BRANCH_MISSES] = open_counter (PERF_TYPE_HARDWARE,
+      PERF_COUNT_HW_BRANCH_MISSES);
+  fd[PERF_DTLB_MISSES] = open_counter (PERF_TYPE_HW_CACHE,
+      cache_read_misses (PERF_COUNT_HW_CACHE_DTLB));
+}
+
+PerfCounters::~PerfCounters()
+{
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    if (fd[i] >= 0) {
+      close (fd[i]);
+    }
+  }
+}
+
+void PerfCounters::read(PerfSample& sample) const
+{
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    // value, time enabled, time running
+    UINT64 values[3];
+
+    sample.value[i] = 0;
+    sample.valid[i] = (fd[i] >= 0)
+        && (::read (fd[i], values, sizeof(values)) == sizeof(values))
+        && (values[2] > 0);
+    if (sample.valid[i]) {
+      sample.value[i] = (values[2] < values[1])
+          ? (UINT64)((double)values[0] * values[1] / values[2]) : values[0];
+    }
+  }
+}
+
+#else                // no perf_event_open
+
+PerfCounters::PerfCounters()
+{
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    fd[i] = -1;
+  }
+}
+
+PerfCounters::~PerfCounters() { }
+
+void PerfCounters::read(PerfSample& sample) const
+{
+  for (index_t i = 0; i < NUM_PERF_COUNTERS; i++) {
+    sample.value[i] = 0;
+    sample.valid[i] = false;
+  }
+}
+
+#endif
+
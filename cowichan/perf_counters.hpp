@@ -0,0 +1,89 @@
+/**
+ * \file perf_counters.hpp
+ * \brief Hardware performance counters around kernel runs.
+ */
+
+#ifndef __perf_counters_hpp__
+#define __perf_counters_hpp__
+
+/**
+ * \brief Hardware events counted by PerfCounters.
+ */
+enum PerfCounter {
+  PERF_CYCLES,         ///< CPU cycles.
+  PERF_INSTRUCTIONS,   ///< retired instructions.
+  PERF_LLC_MISSES,     ///< last level cache read misses.
+  PERF_BRANCH_MISSES,  ///< mispredicted branches.
+  PERF_DTLB_MISSES,    ///< data TLB read misses.
+  NUM_PERF_COUNTERS
+};
+
+/**
+ * \brief Values of all counters at one time.
+ */
+struct PerfSample {
+
+  /**
+   * Counter values, scaled up when the kernel multiplexed the counter.
+   */
+  UINT64 value[NUM_PERF_COUNTERS];
+
+  /**
+   * Whether each counter could be read.
+   */
+  bool valid[NUM_PERF_COUNTERS];
+
+};
+
+/**
+ * \brief Counters of the calling process, read around each kernel.
+ *
+ * The counters are opened with perf_event_open for the calling thread and
+ * inherited by every thread it creates afterwards, so they must be opened
+ * before the implementation starts its worker threads; reads then include
+ * the work of all threads. Counters that cannot be opened (no PMU in a
+ * virtual machine, perf_event_paranoid, other operating systems) are simply
+ * marked invalid in every sample.
+ */
+class PerfCounters {
+public:
+
+  /**
+   * Open every counter that is available.
+   */
+  PerfCounters();
+
+  ~PerfCounters();
+
+  /**
+   * \return Whether at least one counter is available.
+   */
+  bool any() const;
+
+  /**
+   * Read all counters.
+   * \param sample where to store the values.
+   */
+  void read(PerfSample& sample) const;
+
+  /**
+   * \param counter a counter.
+   * \return Short name of the counter, as used in reports.
+   */
+  static const char* name(PerfCounter counter);
+
+private:
+
+  /**
+   * File descriptor of each counter (-1 if not available).
+   */
+  int fd[NUM_PERF_COUNTERS];
+
+  // not copyable
+  PerfCounters(const PerfCounters&);
+  PerfCounters& operator=(const PerfCounters&);
+
+};
+
+#endif
+
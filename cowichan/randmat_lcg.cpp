@@ -0,0 +1,108 @@
+/**
+ * \file randmat_lcg.cpp
+ * \brief Jumps ahead in the randmat generator.
+ */
+
+#include "cowichan.hpp"
+
+RandmatJump randmat_jump(UINT64 steps)
+{
+  // result, and the generator after 2^k steps
+  RandmatJump jump = {1, 0};
+  RandmatJump power = {RANDMAT_A % RAND_M, RANDMAT_C % RAND_M};
+
+  for (; steps > 0; steps >>= 1) {
+    if (steps & 1) {
+      jump.a = randmat_mod(power.a * jump.a);
+      jump.c = randmat_mod(power.a * jump.c + power.c);
+    }
+    power.c = randmat_mod(power.a * power.c + power.c);
+    power.a = randmat_mod(power.a * power.a);
+  }
+  return jump;
+}
+
+INT_TYPE randmat_value(INT_TYPE seed, UINT64 i)
+{
+  return randmat_apply(randmat_jump(i), seed % RAND_M);
+}
+
+void randmat_fill(INT_TYPE* values, index_t count, INT_TYPE seed,
+    UINT64 first, UINT64 stride)
+{
+  randmat_fill_from(values, count, randmat_value(seed, first), stride);
+}
+
+void randmat_fill_from(INT_TYPE* values, index_t count, INT_TYPE start,
+    UINT64 stride)
+{
+  if (count <= 0) {
+    return;
+  }
+
+  RandmatJump step = randmat_jump(stride);
+  UINT32 lanes[RANDMAT_LANES];
+  index_t i = 0, j;
+
+  lanes[0] = start;
+  for (j = 1; j < RANDMAT_LANES; j++) {
+    lanes[j] = randmat_apply(step, lanes[j - 1]);
+  }
+
+  // every lane jumps over the other lanes' elements
+  RandmatJump leap = randmat_jump(stride * RANDMAT_LANES);
+  for (; i + RANDMAT_LANES <= count; i += RANDMAT_LANES) {
+    for (j = 0; j < RANDMAT_LANES; j++) {
+      values[i + j] = lanes[j];
+      lanes[j] = randmat_mod(leap.a * lanes[j] + leap.c);
+    }
+  }
+
+  for (j = 0; i < count; i++, j++) {
+    values[i] = lanes[j];
+  }
+}
+
+RandmatHalfView::RandmatHalfView(index_t nr, index_t nc, INT_TYPE seed):
+    nr(nr), nc(nc), rowStart(NULL), columnJump(NULL)
+{
+  try {
+    rowStart = NEW_VECTOR_SZ(INT_TYPE, nr);
+    columnJump = NEW_VECTOR_SZ(RandmatJump, nc);
+  }
+  catch (...) {out_of_memory();}
+
+  index_t middle_r = (nr + 1) / 2;
+  index_t middle_c = (nc + 1) / 2;
+
+  // rows and columns in generator order, each one step after the last
+  RandmatJump down = randmat_jump(nc);
+  INT_TYPE v = seed % RAND_M;
+  for (index_t r = 0; r < nr; r++) {
+    rowStart[half_position(r, middle_r)] = v;
+    v = randmat_apply(down, v);
+  }
+
+  RandmatJump jump = {1, 0};
+  for (index_t c = 0; c < nc; c++) {
+    columnJump[half_position(c, middle_c)] = jump;
+    jump.a = randmat_mod(RANDMAT_A * jump.a);
+    jump.c = randmat_mod(RANDMAT_A * jump.c + RANDMAT_C);
+  }
+}
+
+RandmatHalfView::~RandmatHalfView()
+{
+  DELETE_ARRAY(rowStart);
+  DELETE_ARRAY(columnJump);
+}
+
+void RandmatHalfView::row(index_t r, INT_TYPE* values) const
+{
+  // half moves even columns to the left half, odd ones to the right half
+  index_t middle_c = (nc + 1) / 2;
+  randmat_fill_from(values, middle_c, rowStart[r], 2);
+  if (nc > 1) {
+    randmat_fill_from(values + middle_c, nc / 2, (*this)(r, middle_c), 2);
+  }
+}
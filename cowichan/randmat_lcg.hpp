@@ -0,0 +1,159 @@
+/**
+ * \file randmat_lcg.hpp
+ * \brief The randmat generator v -> (RANDMAT_A * v + RANDMAT_C) mod RAND_M,
+ * with jumps ahead and without divisions.
+ *
+ * Element i of the sequence is the value at row i / nc, column i % nc of
+ * the randmat matrix; element 0 is seed mod RAND_M.
+ */
+
+#ifndef __randmat_lcg_hpp__
+#define __randmat_lcg_hpp__
+
+/**
+ * floor((2^32 - 1) / RAND_M), for Barrett reduction. RAND_M must be at most
+ * 65535, so that a * v + c < 2^32 for any a, c and v below it.
+ */
+#define RANDMAT_BARRETT ((UINT32)(0xFFFFFFFFu / RAND_M))
+
+/**
+ * Values generated together by randmat_fill, one per lane.
+ */
+#define RANDMAT_LANES 16
+
+/**
+ * \brief The generator after some number of steps: v -> (a * v + c) mod
+ * RAND_M.
+ */
+struct RandmatJump {
+  UINT32 a, c;
+};
+
+/**
+ * Reduce modulo RAND_M with a multiplication: the estimated quotient is
+ * short by at most 2.
+ * \param x number to reduce.
+ * \return x mod RAND_M.
+ */
+inline UINT32 randmat_mod(UINT32 x)
+{
+  UINT32 q = (UINT32)(((UINT64)x * RANDMAT_BARRETT) >> 32);
+  UINT32 r = x - q * RAND_M;
+  r -= (r >= RAND_M) ? RAND_M : 0;
+  r -= (r >= RAND_M) ? RAND_M : 0;
+  return r;
+}
+
+/**
+ * \param jump the generator after some steps.
+ * \param v a value.
+ * \return The value that many steps after v.
+ */
+inline INT_TYPE randmat_apply(const RandmatJump& jump, INT_TYPE v)
+{
+  return randmat_mod(jump.a * v + jump.c);
+}
+
+/**
+ * Compose the generator with itself, by squaring for every bit of steps.
+ * \param steps number of steps.
+ * \return The generator after steps steps.
+ */
+RandmatJump randmat_jump(UINT64 steps);
+
+/**
+ * \param seed random seed.
+ * \param i element number.
+ * \return Element i of the sequence, in O(log i).
+ */
+INT_TYPE randmat_value(INT_TYPE seed, UINT64 i);
+
+/**
+ * Store elements first, first + stride, first + 2 stride, ... of the
+ * sequence. RANDMAT_LANES lanes each start at one of them and jump
+ * RANDMAT_LANES strides at a time.
+ * \param values where to store them.
+ * \param count number of elements.
+ * \param seed random seed.
+ * \param first first element.
+ * \param stride distance between elements.
+ */
+void randmat_fill(INT_TYPE* values, index_t count, INT_TYPE seed,
+    UINT64 first, UINT64 stride);
+
+/**
+ * Store a value of the sequence and the values stride, 2 stride, ... after
+ * it, as randmat_fill does.
+ * \param values where to store them.
+ * \param count number of elements.
+ * \param start first value (below RAND_M).
+ * \param stride distance between elements.
+ */
+void randmat_fill_from(INT_TYPE* values, index_t count, INT_TYPE start,
+    UINT64 stride);
+
+/**
+ * \brief The randmat matrix after half, generated on demand instead of
+ * stored.
+ *
+ * Keeps the first value of every row and the jump to every column, so any
+ * element costs one step of the generator.
+ */
+class RandmatHalfView {
+public:
+
+  /**
+   * Compute the row states and the column jumps.
+   * \param nr number of rows.
+   * \param nc number of columns.
+   * \param seed random seed.
+   */
+  RandmatHalfView(index_t nr, index_t nc, INT_TYPE seed);
+
+  ~RandmatHalfView();
+
+  index_t rows() const {
+    return nr;
+  }
+
+  index_t cols() const {
+    return nc;
+  }
+
+  /**
+   * \param r row (after half).
+   * \param c column (after half).
+   * \return The element, as randmatHalf would store it.
+   */
+  INT_TYPE operator()(index_t r, index_t c) const {
+    return randmat_apply(columnJump[c], rowStart[r]);
+  }
+
+  /**
+   * Generate a whole row.
+   * \param r row (after half).
+   * \param values where to store its nc elements.
+   */
+  void row(index_t r, INT_TYPE* values) const;
+
+private:
+
+  index_t nr, nc;
+
+  /**
+   * First value (column 0 before half) of every row after half.
+   */
+  INT_TYPE* rowStart;
+
+  /**
+   * Jump from the first value of a row to every column after half.
+   */
+  RandmatJump* columnJump;
+
+  // not copyable
+  RandmatHalfView(const RandmatHalfView&);
+  RandmatHalfView& operator=(const RandmatHalfView&);
+
+};
+
+#endif
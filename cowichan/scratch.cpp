@@ -0,0 +1,72 @@
+/**
+ * \file scratch.cpp
+ * \brief Implementation of memory-mapped scratch files.
+ */
+
+#include "cowichan.hpp"
+
+#if defined(WIN64) || defined(WIN32)   // Windows
+
+ScratchFile::ScratchFile(const std::string& /* dir */, size_t bytes): fd(-1),
+    length(bytes)
+{
+  bad_argument ("Scratch files are not supported on", "Windows");
+}
+
+ScratchFile::~ScratchFile() { }
+
+ScratchWindow::ScratchWindow(ScratchFile& /* file */, size_t /* offset */,
+    size_t /* bytes */): base(NULL), length(0), start(NULL) { }
+
+ScratchWindow::~ScratchWindow() { }
+
+#else                // Linux
+
+#include <sys/mman.h>
+#include <fcntl.h>
+
+ScratchFile::ScratchFile(const std::string& dir, size_t bytes): fd(-1),
+    length(bytes)
+{
+  std::string name = dir + "/cowichan-XXXXXX";
+  std::vector<char> path (name.begin(), name.end());
+  path.push_back ('\0');
+
+  fd = mkstemp (&path[0]);
+  if (fd < 0) {
+    bad_argument ("Cannot create scratch file in", dir.c_str());
+  }
+  unlink (&path[0]);
+
+  if (ftruncate (fd, (off_t) bytes) != 0) {
+    bad_argument ("Cannot grow scratch file in", dir.c_str());
+  }
+}
+
+ScratchFile::~ScratchFile()
+{
+  close (fd);
+}
+
+ScratchWindow::ScratchWindow(ScratchFile& file, size_t offset, size_t bytes):
+    base(NULL), length(0), start(NULL)
+{
+  size_t page = (size_t) sysconf(_SC_PAGESIZE);
+  size_t first = offset - offset % page;
+
+  length = bytes + (offset - first);
+  base = mmap (NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd,
+      (off_t) first);
+  if (base == MAP_FAILED) {
+    out_of_memory ();
+  }
+  start = (char*) base + (offset - first);
+}
+
+ScratchWindow::~ScratchWindow()
+{
+  munmap (base, length);
+}
+
+#endif
+
@@ -0,0 +1,97 @@
+/**
+ * \file scratch.hpp
+ * \brief Memory-mapped scratch files for matrices larger than memory.
+ */
+
+#ifndef __scratch_hpp__
+#define __scratch_hpp__
+
+#include <string>
+
+/**
+ * \brief Anonymous temporary file holding a matrix out of core.
+ *
+ * The file is removed from its directory as soon as it is created, so it
+ * disappears when closed, even if the program is killed. Parts of it are
+ * accessed through ScratchWindow mappings; pages of a window that has been
+ * unmapped no longer count towards the resident set.
+ */
+class ScratchFile {
+public:
+
+  /**
+   * Create a scratch file.
+   * \param dir directory to create the file in.
+   * \param bytes size of the file.
+   */
+  ScratchFile(const std::string& dir, size_t bytes);
+
+  ~ScratchFile();
+
+  /**
+   * \return Size of the file in bytes.
+   */
+  size_t size() const { return length; }
+
+private:
+
+  friend class ScratchWindow;
+
+  /**
+   * File descriptor.
+   */
+  int fd;
+
+  /**
+   * Size of the file in bytes.
+   */
+  size_t length;
+
+  // not copyable
+  ScratchFile(const ScratchFile&);
+  ScratchFile& operator=(const ScratchFile&);
+
+};
+
+/**
+ * \brief Mapping of part of a ScratchFile, unmapped on destruction.
+ */
+class ScratchWindow {
+public:
+
+  /**
+   * Map part of a scratch file for reading and writing.
+   * \param file the file.
+   * \param offset first byte (need not be page aligned).
+   * \param bytes number of bytes.
+   */
+  ScratchWindow(ScratchFile& file, size_t offset, size_t bytes);
+
+  ~ScratchWindow();
+
+  /**
+   * \return First mapped byte, at the requested offset.
+   */
+  char* data() const { return start; }
+
+private:
+
+  /**
+   * Start and length of the page aligned mapping.
+   */
+  void* base;
+  size_t length;
+
+  /**
+   * Requested offset within the mapping.
+   */
+  char* start;
+
+  // not copyable
+  ScratchWindow(const ScratchWindow&);
+  ScratchWindow& operator=(const ScratchWindow&);
+
+};
+
+#endif
+
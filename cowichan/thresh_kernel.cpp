@@ -0,0 +1,285 @@
+/**
+ * \file thresh_kernel.cpp
+ * \brief Implementation of the thresh histogram and threshold.
+ *
+ * The OR of a row, the merge of the sub-histograms and the comparisons of
+ * the threshold use SSE2 on x86-64 (where index_t has 64 bits); the other
+ * platforms use the plain loops that finish every vector path.
+ */
+
+#include "cowichan.hpp"
+
+#if ((defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)) \
+    || defined(_M_X64)
+#define THRESH_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * Number of sub-histograms of a ThreshHistogram.
+ */
+#define THRESH_LANES 4
+
+/**
+ * Counters between the end of a sub-histogram and the next one (a cache
+ * line), so that the same bin of two of them does not share a cache set.
+ */
+#define THRESH_PAD 16
+
+/**
+ * OR the values of a row.
+ * \param in the row.
+ * \param count number of cells.
+ * \return Every bit set in some value.
+ */
+static INT_TYPE thresh_or(const INT_TYPE* in, index_t count)
+{
+  INT_TYPE bits = 0;
+  index_t c = 0;
+
+#ifdef THRESH_SSE2
+  __m128i v = _mm_setzero_si128();
+  for (; c + 4 <= count; c += 4) {
+    v = _mm_or_si128(v, _mm_loadu_si128((const __m128i*)(in + c)));
+  }
+  v = _mm_or_si128(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_or_si128(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  bits = (INT_TYPE)_mm_cvtsi128_si32(v);
+#endif
+
+  for (; c < count; c++) {
+    bits |= in[c];
+  }
+  return bits;
+}
+
+/**
+ * Add bins of all sub-histograms to totals.
+ * \param totals counts of each value.
+ * \param counts the sub-histograms (their sum must fit in 32 bits).
+ * \param stride counters from one sub-histogram to the next.
+ * \param first first bin.
+ * \param last one past the last bin.
+ */
+static void thresh_merge(index_t* totals, const UINT32* counts,
+    index_t stride, index_t first, index_t last)
+{
+  index_t v = first;
+  int k;
+
+#ifdef THRESH_SSE2
+  // 4 bins at a time, widened to 64 bits
+  const __m128i zero = _mm_setzero_si128();
+  for (; v + 4 <= last; v += 4) {
+    __m128i sum = _mm_loadu_si128((const __m128i*)(counts + v));
+    for (k = 1; k < THRESH_LANES; k++) {
+      sum = _mm_add_epi32(sum,
+          _mm_loadu_si128((const __m128i*)(counts + k * stride + v)));
+    }
+    __m128i* out = (__m128i*)(totals + v);
+    _mm_storeu_si128(out, _mm_add_epi64(_mm_loadu_si128(out),
+        _mm_unpacklo_epi32(sum, zero)));
+    _mm_storeu_si128(out + 1, _mm_add_epi64(_mm_loadu_si128(out + 1),
+        _mm_unpackhi_epi32(sum, zero)));
+  }
+#endif
+
+  for (; v < last; v++) {
+    index_t sum = 0;
+    for (k = 0; k < THRESH_LANES; k++) {
+      sum += counts[k * stride + v];
+    }
+    totals[v] += sum;
+  }
+}
+
+ThreshHistogram::ThreshHistogram(): counts(NULL), size(0), stride(0),
+    pending(0)
+{
+  grow(0);
+}
+
+ThreshHistogram::~ThreshHistogram()
+{
+  DELETE_ARRAY(counts);
+}
+
+void ThreshHistogram::grow(INT_TYPE value)
+{
+  UINT64 bigger = std::max((UINT64)size, (UINT64)THRESH_BINS);
+  while (bigger <= value) {
+    bigger *= 2;
+  }
+  index_t wider = (index_t)bigger + THRESH_PAD;
+
+  UINT32* more = NULL;
+  try {
+    more = NEW_VECTOR_SZ(UINT32, THRESH_LANES * wider);
+    if (!spill.empty()) {
+      spill.resize((size_t)bigger, 0);
+    }
+  }
+  catch (...) {out_of_memory();}
+
+  memset(more, 0, THRESH_LANES * wider * sizeof(UINT32));
+  if (counts != NULL) {
+    for (int k = 0; k < THRESH_LANES; k++) {
+      memcpy(more + k * wider, counts + k * stride, size * sizeof(UINT32));
+    }
+    DELETE_ARRAY(counts);
+  }
+  counts = more;
+  size = (index_t)bigger;
+  stride = wider;
+}
+
+void ThreshHistogram::flush()
+{
+  try {
+    spill.resize((size_t)size, 0);
+  }
+  catch (...) {out_of_memory();}
+
+  thresh_merge(&spill[0], counts, stride, 0, size);
+  memset(counts, 0, THRESH_LANES * stride * sizeof(UINT32));
+  pending = 0;
+}
+
+void ThreshHistogram::count(const MatrixView<INT_TYPE>& values, index_t first,
+    index_t last)
+{
+  index_t nc = values.cols();
+  index_t r, c;
+  int k;
+
+  for (r = first; r < last; r++) {
+    const INT_TYPE* RESTRICT row = values.row(r);
+
+    // the counters of all sub-histograms add up to 32 bits at most
+    if (pending + nc > 0xFFFFFFFFull) {
+      flush();
+    }
+    if ((thresh_or(row, nc) & ~(INT_TYPE)(size - 1)) != 0) {
+      grow(*std::max_element(row, row + nc));
+    }
+
+    UINT32* RESTRICT lanes = counts;
+    for (c = 0; c + THRESH_LANES <= nc; c += THRESH_LANES) {
+      for (k = 0; k < THRESH_LANES; k++) {
+        lanes[k * stride + row[c + k]]++;
+      }
+    }
+    for (; c < nc; c++) {
+      lanes[row[c]]++;
+    }
+    pending += nc;
+  }
+}
+
+void ThreshHistogram::add(index_t* totals, index_t first, index_t last) const
+{
+  last = std::min(last, size);
+  if (first >= last) {
+    return;
+  }
+
+  thresh_merge(totals, counts, stride, first, last);
+  if (!spill.empty()) {
+    for (index_t v = first; v < last; v++) {
+      totals[v] += spill[v];
+    }
+  }
+}
+
+index_t thresh_level(const index_t* totals, index_t bins, index_t retain)
+{
+  index_t i;
+
+  // include
+  for (i = bins - 1; ((i >= 0) && (retain > 0)); i--) {
+    retain -= totals[i];
+  }
+  return i;
+}
+
+#ifdef THRESH_SSE2
+
+/**
+ * Compare 4 cells with the level, as signed numbers: both have their top
+ * bit flipped.
+ * \param in the cells.
+ * \param bias the top bit of every element.
+ * \param level the level, with its top bit flipped.
+ * \return All ones in the elements of the cells above the level.
+ */
+static inline __m128i thresh_above(const INT_TYPE* in, __m128i bias,
+    __m128i level)
+{
+  return _mm_cmpgt_epi32(
+      _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), bias), level);
+}
+
+#endif
+
+void thresh_bools(bool* out, const INT_TYPE* in, index_t count,
+    index_t level)
+{
+  index_t c = 0;
+
+#ifdef THRESH_SSE2
+  // every cell is above a level of -1, which has no 32-bit vector form
+  if (level >= 0) {
+    const __m128i bias = _mm_set1_epi32((int)0x80000000);
+    const __m128i limit = _mm_xor_si128(_mm_set1_epi32((int)level), bias);
+    const __m128i one = _mm_set1_epi8(1);
+
+    // 16 comparisons packed into 16 bytes of 0 or -1
+    for (; c + 16 <= count; c += 16) {
+      __m128i low = _mm_packs_epi32(thresh_above(in + c, bias, limit),
+          thresh_above(in + c + 4, bias, limit));
+      __m128i high = _mm_packs_epi32(thresh_above(in + c + 8, bias, limit),
+          thresh_above(in + c + 12, bias, limit));
+      _mm_storeu_si128((__m128i*)(out + c),
+          _mm_and_si128(_mm_packs_epi16(low, high), one));
+    }
+  }
+#endif
+
+  for (; c < count; c++) {
+    out[c] = ((index_t)in[c]) > level;
+  }
+}
+
+void thresh_bits(UINT64* out, const INT_TYPE* in, index_t count,
+    index_t level)
+{
+  index_t words = bit_row_words(count);
+  index_t i, j;
+
+#ifdef THRESH_SSE2
+  const __m128i bias = _mm_set1_epi32((int)0x80000000);
+  const __m128i limit = _mm_xor_si128(_mm_set1_epi32((int)level), bias);
+#endif
+
+  for (i = 0; i < words; i++) {
+    const INT_TYPE* RESTRICT cells = in + i * BITS_PER_WORD;
+    index_t bits = std::min((index_t)BITS_PER_WORD, count - i * BITS_PER_WORD);
+    UINT64 word = 0;
+    j = 0;
+
+#ifdef THRESH_SSE2
+    // 4 comparisons to 4 bits (see thresh_bools for level -1)
+    if (level >= 0) {
+      for (; j + 4 <= bits; j += 4) {
+        word |= (UINT64)_mm_movemask_ps(_mm_castsi128_ps(
+            thresh_above(cells + j, bias, limit))) << j;
+      }
+    }
+#endif
+
+    for (; j < bits; j++) {
+      word |= (UINT64)(((index_t)cells[j]) > level) << j;
+    }
+    out[i] = word;
+  }
+}
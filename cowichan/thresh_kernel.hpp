@@ -0,0 +1,119 @@
+/**
+ * \file thresh_kernel.hpp
+ * \brief The thresh histogram and threshold shared by the serial and OpenMP
+ * implementations.
+ */
+
+#ifndef __thresh_kernel_hpp__
+#define __thresh_kernel_hpp__
+
+/**
+ * \brief Histogram of matrix values, counted in a single pass over the rows.
+ *
+ * Cells are counted in THRESH_LANES sub-histograms in turn, so that runs of
+ * equal values do not wait on the counter they just stored. The bins start
+ * at THRESH_BINS and double past the largest value found: an OR of each row
+ * tells whether it has a value out of range, so randmat values end up in
+ * 65536 bins (below RAND_M) and mandel values in 256 (up to MANDEL_MAX_ITER)
+ * without a pass to find the largest value first.
+ */
+class ThreshHistogram {
+public:
+
+  ThreshHistogram();
+
+  ~ThreshHistogram();
+
+  /**
+   * Count the values of some rows.
+   * \param values the matrix.
+   * \param first first row.
+   * \param last one past the last row.
+   */
+  void count(const MatrixView<INT_TYPE>& values, index_t first, index_t last);
+
+  /**
+   * \return Number of bins: every value counted is below it.
+   */
+  index_t bins() const {
+    return size;
+  }
+
+  /**
+   * Add the counts of some bins to totals.
+   * \param totals counts of each value, of at least last elements.
+   * \param first first bin.
+   * \param last one past the last bin (bins above bins() are empty).
+   */
+  void add(index_t* totals, index_t first, index_t last) const;
+
+private:
+
+  /**
+   * Make room for a value, and keep the counts.
+   * \param value the value.
+   */
+  void grow(INT_TYPE value);
+
+  /**
+   * Move the counts of the sub-histograms to spill before they overflow.
+   */
+  void flush();
+
+  /**
+   * Sub-histograms; bin v of sub-histogram k is at counts[k * stride + v].
+   */
+  UINT32* counts;
+
+  /**
+   * Number of bins, and of counters from one sub-histogram to the next.
+   */
+  index_t size, stride;
+
+  /**
+   * Cells counted since the last flush.
+   */
+  UINT64 pending;
+
+  /**
+   * Counts flushed (empty before the first flush).
+   */
+  std::vector<index_t> spill;
+
+  // not copyable
+  ThreshHistogram(const ThreshHistogram&);
+  ThreshHistogram& operator=(const ThreshHistogram&);
+
+};
+
+/**
+ * Find the largest value that is not retained.
+ * \param totals count of each value.
+ * \param bins number of values.
+ * \param retain number of cells to retain.
+ * \return Cells greater than this value are retained.
+ */
+index_t thresh_level(const index_t* totals, index_t bins, index_t retain);
+
+/**
+ * Threshold a row into a mask: out[c] = in[c] > level.
+ * \param out the row of the mask.
+ * \param in the row of the matrix.
+ * \param count number of cells.
+ * \param level the value from thresh_level.
+ */
+void thresh_bools(bool* out, const INT_TYPE* in, index_t count,
+    index_t level);
+
+/**
+ * Threshold a row into a bit mask: bit c % 64 of out[c / 64] is
+ * in[c] > level, and the bits past count are clear.
+ * \param out the row of the mask, of bit_row_words(count) words.
+ * \param in the row of the matrix.
+ * \param count number of cells.
+ * \param level the value from thresh_level.
+ */
+void thresh_bits(UINT64* out, const INT_TYPE* in, index_t count,
+    index_t level);
+
+#endif
@@ -1,3 +1,3 @@
 #!/bin/bash
-g++ -Wall -m64 -Os -Iinclude -c ../cowichan/cowichan.cpp
-g++ -Wall -m64 -Os -llinuxtuples -Wno-write-strings -I../linuxtuples-1.03 -o cowichan_lt src/*.cpp cowichan.o
+g++ -Wall -m64 -Os -Iinclude -c ../cowichan/*.cpp
+g++ -Wall -m64 -Os -llinuxtuples -Wno-write-strings -I../linuxtuples-1.03 -o cowichan_lt src/*.cpp *.o
@@ -18,3 +18,7 @@ int main(int argc, char* argv[]) {
  * The host where the LinuxTuples server can be found.
  */
 const char* CowichanLinuxTuples::SERVER = "localhost";
+
+index_t CowichanLinuxTuples::setNumThreads(index_t threads) {
+	return threads;
+}
@@ -25,10 +25,14 @@ public:
 	 */
 	static const int PORT = 25000;
 
+protected:
+
 	/**
-	 * The number of worker processes to spawn.
+	 * Set the number of worker processes to spawn for each tuple-space program.
+	 * \param threads number of worker processes.
+	 * \return The number of worker processes.
 	 */
-	static const int NUM_WORKERS = 2;
+	index_t setNumThreads(index_t threads);
 
 protected: // chaining functions
 
@@ -22,12 +22,12 @@ void CowichanLinuxTuples::gauss(Matrix matrix, Vector target, Vector solution) {
 
 	// forward-elimination.
 	// forward puts the target and matrix into tuple space, and returns them.
-	LTForward forward;
+	LTForward forward(n);
 	forward.addInput(0, matrix);
 	forward.addInput(1, target);
 	forward.addOutput(0, matrix);
 	forward.addOutput(1, target);
-	forward.start(SERVER, PORT, NUM_WORKERS);
+	forward.start(SERVER, PORT, threads);
 
 	// backward-substitution and solution creation (from serial implementation).
 	for (index_t k = (n - 1); k >= 0; k--) {
@@ -41,6 +41,8 @@ void CowichanLinuxTuples::gauss(Matrix matrix, Vector target, Vector solution) {
 
 //===========================================================================//
 
+LTForward::LTForward(index_t n): n(n) { }
+
 void LTForward::consumeInput() {
 
 	// grab pointers locally.
@@ -53,10 +55,10 @@ void LTForward::consumeInput() {
 	tuple *targetTuple = make_tuple("ss", TARGET);
 
 	// put the matrix (row-by-row) and the target vector into the tuple space.
-	for (size_t r = 0; r < GAUSS_N; ++r) {
+	for (index_t r = 0; r < n; ++r) {
 		row->elements[1].data.i = r;
-		row->elements[2].data.s.len = sizeof(matrix) / GAUSS_N;
-		row->elements[2].data.s.ptr = (char*) &MATRIX_RECT_NC(matrix, r, 0, GAUSS_N);
+		row->elements[2].data.s.len = sizeof(matrix) / n;
+		row->elements[2].data.s.ptr = (char*) &MATRIX_RECT_NC(matrix, r, 0, n);
 		put_tuple(row, &ctx);
 	}
 	targetTuple->elements[1].data.s.len = sizeof(target);
@@ -67,7 +69,7 @@ void LTForward::consumeInput() {
 	// one column at-a-time.
 	tuple *grabRow = make_tuple("si?", MATRIX_ROW);
 	tuple *grabTarget = make_tuple("s?", TARGET);
-	for (index_t c = 0; c < GAUSS_N; ++c) {
+	for (index_t c = 0; c < n; ++c) {
 
 		// create a "rows reporting" tuple, so that we
 		// know when the computation has ended (workers are done)
@@ -76,7 +78,7 @@ void LTForward::consumeInput() {
 
 	    // get row with maximum column i
 	    index_t maxRow = c;
-	    for (index_t r = c + 1; r < GAUSS_N; ++r) {
+	    for (index_t r = c + 1; r < n; ++r) {
 
 	    	// grab the two rows (r and maxRow)
 	    	grabRow->elements[1].data.i = r;
@@ -100,7 +102,7 @@ void LTForward::consumeInput() {
 		}
 
 		// swap max row with row c to put largest value on diagonal
-		for (index_t r = c; r < GAUSS_N; ++r) {
+		for (index_t r = c; r < n; ++r) {
 
 	    	// grab the two rows (c and maxRow)
 	    	grabRow->elements[1].data.i = c;
@@ -131,14 +133,14 @@ void LTForward::consumeInput() {
 		destroy_tuple(targetTuple);
 
 		// create a forward request for each row under the diagonal
-		for (index_t r = c + 1; r < GAUSS_N; ++r) {
+		for (index_t r = c + 1; r < n; ++r) {
 			send->elements[1].data.i = r; // row
 			send->elements[2].data.i = c; // column
 			put_tuple(send, &ctx);
 		}
 
 		// wait for the workers to finish this column
-		size_t rowsToBeDone = GAUSS_N - (c + 1);
+		size_t rowsToBeDone = n - (c + 1);
 		rowsReporting->elements[1].data.i = rowsToBeDone;
 		destroy_tuple(get_tuple(rowsReporting, &ctx));
 
@@ -181,7 +183,7 @@ void LTForward::work() {
 		// actual computation.
     	real column_i = iRowVector[i];
 		real factor = -(jRowVector[i] / column_i);
-		for (index_t k = GAUSS_N - 1; k >= i; k--) {
+		for (index_t k = n - 1; k >= i; k--) {
 			jRowVector[k] += iRowVector[k] * factor;
 		}
 
@@ -225,11 +227,11 @@ void LTForward::produceOutput() {
 	get_tuple(forwardDone, &ctx);
 
 	// get the matrix (row-by-row)...
-	for (size_t r = 0; r < GAUSS_N; ++r) {
+	for (index_t r = 0; r < n; ++r) {
 		grabRow->elements[1].data.i = r;
 		tuple* grabbedRow = get_tuple(grabRow, &ctx);
 		memcpy(
-			&MATRIX_SQUARE_N(matrix, grabbedRow->elements[1].data.i, 0, GAUSS_N),
+			&MATRIX_SQUARE_N(matrix, grabbedRow->elements[1].data.i, 0, n),
 			grabbedRow->elements[2].data.s.ptr,
 			grabbedRow->elements[2].data.s.len);
 		destroy_tuple(grabbedRow);
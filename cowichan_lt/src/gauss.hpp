@@ -15,8 +15,21 @@
 	 * forward elimination on a square matrix in parallel.
 	 */
 	class LTForward: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param n the number of rows and columns of the matrix.
+		 */
+		LTForward(index_t n);
+
 	protected:
 
+		/**
+		 * The number of rows and columns of the matrix.
+		 */
+		index_t n;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
@@ -13,16 +13,18 @@ const char* LTHalf::REQUEST = "half request";
 const char* LTHalf::DONE = "half done";
 
 void CowichanLinuxTuples::half(IntMatrix matrixIn, IntMatrix matrixOut) {
-	LTHalf app;
+	LTHalf app(nr, nc);
 	app.addInput(0, matrixIn);
 	app.addOutput(0, matrixOut);
-	app.start(SERVER, PORT, NUM_WORKERS);
+	app.start(SERVER, PORT, threads);
 }
 
+LTHalf::LTHalf(index_t nr, index_t nc): nr(nr), nc(nc) { }
+
 void LTHalf::consumeInput() {
 
 	// send off a request for each grid row.
-	for (size_t y = 0; y < HALF_NR; ++y) {
+	for (index_t y = 0; y < nr; ++y) {
 		tuple *send = make_tuple("si", REQUEST, y);
 		put_tuple(send, &ctx);
 		destroy_tuple(send);
@@ -47,21 +49,21 @@ void LTHalf::work() {
 		// a buffer for the results of the computation.
 		size_t y = gotten->elements[1].data.i;
 		tuple *send = make_tuple("sis", DONE, y, "");
-		IntVector buffer = NEW_VECTOR_SZ(INT_TYPE, HALF_NC);
-		send->elements[2].data.s.len = sizeof(INT_TYPE) * HALF_NC;
+		IntVector buffer = NEW_VECTOR_SZ(INT_TYPE, nc);
+		send->elements[2].data.s.len = sizeof(INT_TYPE) * nc;
 		send->elements[2].data.s.ptr = (char*) buffer;
 
 		// perform the actual computation for this row.
 		#define FLIP(item) (item % 2 == 0 ? (item + 1) : (item - 1))
-		for (size_t x = 0; x < HALF_NC; ++x) {
-			buffer[x] = MATRIX_RECT_NC(input, FLIP(y),FLIP(x), HALF_NC);
+		for (index_t x = 0; x < nc; ++x) {
+			buffer[x] = MATRIX_RECT_NC(input, FLIP(y),FLIP(x), nc);
 		}
 	
 		// send off the new tuple and purge local memory of the one we got
 		put_tuple(send, &ctx);
 		destroy_tuple(gotten);
 		destroy_tuple(send);
-		delete[] buffer;
+		DELETE_ARRAY(buffer);
 
 	}
 
@@ -80,13 +82,13 @@ void LTHalf::produceOutput() {
 
 	// grab all of the mandelbrot computations from the workers,
 	// in an unspecified order.
-	int computations = HALF_NR;
+	int computations = nr;
 	while (computations > 0) {
 
 		// get the tuple and copy it into the matrix.
 		tuple* received = get_tuple(recv, &ctx);
 		memcpy(
-			&MATRIX_RECT_NC(output, received->elements[1].data.i, 0, HALF_NC),
+			&MATRIX_RECT_NC(output, received->elements[1].data.i, 0, nc),
 			received->elements[2].data.s.ptr,
 			received->elements[2].data.s.len);
 		computations--;
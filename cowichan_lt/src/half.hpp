@@ -15,7 +15,22 @@
 	 * Generates an output matrix using LinuxTuples.
 	 */
 	class LTHalf: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param nr the number of rows.
+		 * \param nc the number of columns.
+		 */
+		LTHalf(index_t nr, index_t nc);
+
 	protected:
+
+		/**
+		 * The number of rows and columns.
+		 */
+		index_t nr, nc;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
@@ -33,13 +33,13 @@ void CowichanLinuxTuples::hull(PointVector pointsIn, PointVector pointsOut) {
 	int order = 0;
 
 	// while not all points are used up then run quickhull on the rest of points
-	while (order < HULL_N) {
+	while (order < n) {
 
 		// Run quickhull on the decided points as a tuple-space problem.
-		LTHull app(HULL_N - order);
+		LTHull app(n, n - order);
 		app.addInput(0, pointsIn);
 		app.addOutput(0, pointsOut + order); // offset into the array
-		app.start(SERVER, PORT, NUM_WORKERS);
+		app.start(SERVER, PORT, threads);
 
 		// get and remove the num-points "order" tuple from tuple space
 		// add it to the order so we can keep track of the number of
@@ -68,7 +68,7 @@ void CowichanLinuxTuples::hull(PointVector pointsIn, PointVector pointsOut) {
 
 //===========================================================================//
 
-LTHull::LTHull(size_t left): numLeft(left) { }
+LTHull::LTHull(index_t n, size_t left): n(n), numLeft(left) { }
 
 void LTHull::consumeInput() {
 
@@ -83,7 +83,7 @@ void LTHull::consumeInput() {
 
 		// search for the only point
 		index_t pos;
-		for (pos = 0; pos < HULL_N; ++pos) {
+		for (pos = 0; pos < n; ++pos) {
 			if (!isMasked(pos)) break;
 		}
 
@@ -167,12 +167,12 @@ void LTHull::computeCross(index_t p1, index_t p2, index_t *maxPoint, real* maxCr
 
 	// split points, based on a cluster size of the square-root of the
 	// number of points given.
-	index_t skip = (size_t) sqrt((real) HULL_N);
+	index_t skip = (size_t) sqrt((real) n);
 	index_t numToReport = 0;
-	for (index_t pos = 0; pos < HULL_N; pos += skip) {
+	for (index_t pos = 0; pos < n; pos += skip) {
 		++numToReport;
 		send->elements[2].data.i = pos;
-		send->elements[3].data.i = std::min(pos + skip, HULL_N);
+		send->elements[3].data.i = std::min(pos + skip, n);
 		put_tuple(send, &ctx);
 	}
 
@@ -205,12 +205,12 @@ void LTHull::computeMinMax(index_t *minPoint, index_t *maxPoint) {
 
 	// split points, based on a cluster size of the square-root of the
 	// number of points given.
-	index_t skip = (size_t) sqrt((real) HULL_N);
+	index_t skip = (size_t) sqrt((real) n);
 	index_t numToReport = 0;
-	for (index_t pos = 0; pos < HULL_N; pos += skip) {
+	for (index_t pos = 0; pos < n; pos += skip) {
 		++numToReport;
 		send->elements[2].data.i = pos;
-		send->elements[3].data.i = std::min(pos + skip, HULL_N);
+		send->elements[3].data.i = std::min(pos + skip, n);
 		put_tuple(send, &ctx);
 	}
 
@@ -33,9 +33,10 @@
 
 		/**
 		 * Constructor.
+		 * \param n the number of points in the input.
 		 * \param numLeft the number of points left unmasked in the input.
 		 */
-		LTHull(size_t numLeft);
+		LTHull(index_t n, size_t numLeft);
 
 		/**
 		 * The index of a point that is masked off (i.e. already selected) in the input.
@@ -45,6 +46,11 @@
 
 	protected:
 
+		/**
+		 * The number of points in the input.
+		 */
+		index_t n;
+
 		/**
 		 * The number of points left unmasked in the input.
 		 */
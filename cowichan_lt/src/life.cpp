@@ -12,18 +12,20 @@ void CowichanLinuxTuples::life(BoolMatrix matrixIn, BoolMatrix matrixOut) {
 
 	// overwrite the output matrix
 	memcpy(matrixOut, matrixIn,
-		sizeof(bool) * LIFE_NR * LIFE_NC);
+		sizeof(bool) * nr * nc);
 
 	// operate in-place on matrixOut the number of iterations we should.
-	for (size_t i = 0; i < LIFE_ITERATIONS; ++i) {
-		LTLife app;
+	for (index_t i = 0; i < lifeIterations; ++i) {
+		LTLife app(nr, nc);
 		app.addInput(0, matrixOut);
 		app.addOutput(0, matrixOut);
-		app.start(SERVER, PORT, NUM_WORKERS);
+		app.start(SERVER, PORT, threads);
 	}
 
 }
 
+LTLife::LTLife(index_t nr, index_t nc): nr(nr), nc(nc) { }
+
 /**
  * Calculate number of peers.
  */
@@ -36,19 +38,19 @@ index_t LTLife::sumNeighbours(index_t y, index_t x) {
 
 	// calculate possible neighbour positions
 	bool l = (x > 0);
-	bool r = (x < (LIFE_NC - 1));
+	bool r = (x < (nc - 1));
 	bool u = (y > 0);
-	bool d = (y < (LIFE_NR - 1));
+	bool d = (y < (nr - 1));
 
 	// calculate no. of neighbours
-	if (l &&       MATRIX_RECT_NC(first, y    , x - 1, LIFE_NC)) ++peers;
-	if (l && u &&  MATRIX_RECT_NC(first, y - 1, x - 1, LIFE_NC)) ++peers;
-	if (u &&       MATRIX_RECT_NC(first, y - 1, x    , LIFE_NC)) ++peers;
-	if (r && u &&  MATRIX_RECT_NC(first, y - 1, x + 1, LIFE_NC)) ++peers;
-	if (r &&       MATRIX_RECT_NC(first, y    , x + 1, LIFE_NC)) ++peers;
-	if (r && d &&  MATRIX_RECT_NC(first, y + 1, x + 1, LIFE_NC)) ++peers;
-	if (d &&       MATRIX_RECT_NC(first, y + 1, x    , LIFE_NC)) ++peers;
-	if (l && d &&  MATRIX_RECT_NC(first, y + 1, x - 1, LIFE_NC)) ++peers;
+	if (l &&       MATRIX_RECT_NC(first, y    , x - 1, nc)) ++peers;
+	if (l && u &&  MATRIX_RECT_NC(first, y - 1, x - 1, nc)) ++peers;
+	if (u &&       MATRIX_RECT_NC(first, y - 1, x    , nc)) ++peers;
+	if (r && u &&  MATRIX_RECT_NC(first, y - 1, x + 1, nc)) ++peers;
+	if (r &&       MATRIX_RECT_NC(first, y    , x + 1, nc)) ++peers;
+	if (r && d &&  MATRIX_RECT_NC(first, y + 1, x + 1, nc)) ++peers;
+	if (d &&       MATRIX_RECT_NC(first, y + 1, x    , nc)) ++peers;
+	if (l && d &&  MATRIX_RECT_NC(first, y + 1, x - 1, nc)) ++peers;
 
 	return peers;
 
@@ -60,7 +62,7 @@ void LTLife::consumeInput() {
 	tuple *send = make_tuple("si", "life request");
 
 	// send off a request for each grid row.
-	for (size_t y = 0; y < LIFE_NR; ++y) {
+	for (index_t y = 0; y < nr; ++y) {
 		send->elements[1].data.i = y;
 		put_tuple(send, &ctx);
 	}
@@ -87,12 +89,12 @@ void LTLife::work() {
 		// a buffer for the results of the computation.
 		size_t y = gotten->elements[1].data.i;
 		tuple *send = make_tuple("sis", "life done", y, "");
-		BoolVector buffer = (BoolVector) NEW_VECTOR_SZ(bool, LIFE_NC);
-		send->elements[2].data.s.len = sizeof(bool) * LIFE_NC;
+		BoolVector buffer = (BoolVector) NEW_VECTOR_SZ(bool, nc);
+		send->elements[2].data.s.len = sizeof(bool) * nc;
 		send->elements[2].data.s.ptr = (char*) buffer;
 
 		// perform the actual computation for this row.
-		for (int x = 0; x < LIFE_NC; ++x) {
+		for (int x = 0; x < nc; ++x) {
 
 	        index_t peers = sumNeighbours(y, x);
 	        if (peers < 2 || peers > 3) {
@@ -100,7 +102,7 @@ void LTLife::work() {
 	        } else if (peers == 3) {
 	          buffer[x] = true; // breeding
 	        } else {
-	          buffer[x] = MATRIX_RECT_NC(input, y, x, LIFE_NC); // nothing
+	          buffer[x] = MATRIX_RECT_NC(input, y, x, nc); // nothing
 	        }
 
 		}
@@ -124,14 +126,14 @@ void LTLife::produceOutput() {
 
 	// grab all of the life computations from the workers,
 	// in an unspecified order.
-	int computations = LIFE_NR;
+	int computations = nr;
 	while (computations > 0) {
 
 		// get the tuple and copy it into the matrix.
 		tuple *recv = make_tuple("s??", "life done");
 		tuple* received = get_tuple(recv, &ctx);
 		memcpy(
-			&MATRIX_RECT_NC(output, received->elements[1].data.i, 0, LIFE_NC),
+			&MATRIX_RECT_NC(output, received->elements[1].data.i, 0, nc),
 			received->elements[2].data.s.ptr,
 			received->elements[2].data.s.len);
 		computations--;
@@ -14,7 +14,22 @@
 	 * Cellular automata done in LinuxTuples.
 	 */
 	class LTLife: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param nr the number of rows.
+		 * \param nc the number of columns.
+		 */
+		LTLife(index_t nr, index_t nc);
+
 	protected:
+
+		/**
+		 * The number of rows and columns.
+		 */
+		index_t nr, nc;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
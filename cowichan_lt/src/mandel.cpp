@@ -9,15 +9,20 @@
 #include "mandel.hpp"
 
 void CowichanLinuxTuples::mandel(IntMatrix matrix) {
-	LTMandel mandelApp;
+	LTMandel mandelApp(nr, nc, mandelX0, mandelY0, mandelDx, mandelDy,
+		mandelMaxIter, mandelInfinity);
 	mandelApp.addOutput(0, matrix);
-	mandelApp.start(SERVER, PORT, NUM_WORKERS);
+	mandelApp.start(SERVER, PORT, threads);
 }
 
+LTMandel::LTMandel(index_t nr, index_t nc, real x0, real y0, real dx, real dy,
+	index_t maxIter, real infinity): nr(nr), nc(nc), x0(x0), y0(y0), dx(dx),
+	dy(dy), maxIter(maxIter), infinity(infinity) { }
+
 void LTMandel::consumeInput() {
 
 	// send off a mandelbrot request for each grid row.
-	for (size_t y = 0; y < MANDEL_NR; ++y) {
+	for (index_t y = 0; y < nr; ++y) {
 		tuple *send = make_tuple("si", "mandel request");
 		send->elements[1].data.i = y;
 		put_tuple(send, &ctx);
@@ -44,7 +49,7 @@ int LTMandel::mandelCalc(real x, real y) {
 		// "step" the simulation for this co-ordinate.
 		++numIterations;			
 	
-	} while ((numIterations < MANDEL_MAX_ITER) && ((rs + is) < MANDEL_INFINITY));
+	} while ((numIterations < maxIter) && ((rs + is) < infinity));
 
 	// we are interested if the series converges or diverges. Return the
 	// number of iterations before such an event (divergence).
@@ -57,8 +62,8 @@ void LTMandel::work() {
 	tuple *recv = make_tuple("s?", "mandel request");
 	
 	// 2D delta between calculated points
-	real dX = MANDEL_DX / (MANDEL_NC - 1);
-	real dY = MANDEL_DY / (MANDEL_NR - 1);
+	real dX = dx / (nc - 1);
+	real dY = dy / (nr - 1);
 
 	// satisfy mandelbrot requests.
 	while (1) {
@@ -69,14 +74,14 @@ void LTMandel::work() {
 		// copy over row co-ordinate of the computation; create
 		// a buffer for the results of the computation.
 		tuple *send = make_tuple("sis", "mandel done", gotten->elements[1].data.i, "");
-		int* buffer = (int*) malloc(sizeof(int) * MANDEL_NC);
-		send->elements[2].data.s.len = sizeof(int) * MANDEL_NC;
+		int* buffer = (int*) malloc(sizeof(int) * nc);
+		send->elements[2].data.s.len = sizeof(int) * nc;
 		send->elements[2].data.s.ptr = (char*) buffer;
 
 		// perform the actual computation for this row.
-		double rY = MANDEL_Y0 + dY * send->elements[1].data.i;
-		double rX = MANDEL_X0;
-		for (int x = 0; x < MANDEL_NC; ++x, rX += dX) {
+		double rY = y0 + dY * send->elements[1].data.i;
+		double rX = x0;
+		for (int x = 0; x < nc; ++x, rX += dX) {
 			buffer[x] = mandelCalc(rX, rY);
 		}
 	
@@ -103,13 +108,13 @@ void LTMandel::produceOutput() {
 
 	// grab all of the mandelbrot computations from the workers,
 	// in an unspecified order.
-	int computations = MANDEL_NR;
+	int computations = nr;
 	while (computations > 0) {
 
 		// get the tuple and copy it into the matrix.
 		tuple* received = get_tuple(recv, &ctx);
 		memcpy(
-			&MATRIX_RECT_NC(output, received->elements[1].data.i, 0, MANDEL_NC),
+			&MATRIX_RECT_NC(output, received->elements[1].data.i, 0, nc),
 			received->elements[2].data.s.ptr,
 			received->elements[2].data.s.len);
 		computations--;
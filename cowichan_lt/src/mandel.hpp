@@ -15,7 +15,44 @@
 	 * Uses LinuxTuples to do the heavy lifting.
 	 */
 	class LTMandel: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param nr the number of rows.
+		 * \param nc the number of columns.
+		 * \param x0 x-coordinate of the lower left corner.
+		 * \param y0 y-coordinate of the lower left corner.
+		 * \param dx extent of the region along the x axis.
+		 * \param dy extent of the region along the y axis.
+		 * \param maxIter maximum number of iterations per point.
+		 * \param infinity squared magnitude at which a point diverges.
+		 */
+		LTMandel(index_t nr, index_t nc, real x0, real y0, real dx, real dy,
+			index_t maxIter, real infinity);
+
 	protected:
+
+		/**
+		 * The number of rows and columns.
+		 */
+		index_t nr, nc;
+
+		/**
+		 * The lower left corner and extents of the region.
+		 */
+		real x0, y0, dx, dy;
+
+		/**
+		 * Maximum number of iterations per point.
+		 */
+		index_t maxIter;
+
+		/**
+		 * Squared magnitude at which a point diverges.
+		 */
+		real infinity;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
@@ -21,20 +21,22 @@ const char* LTNorm::MAX_POINT = "norm maxPoint";
 void CowichanLinuxTuples::norm(PointVector pointsIn, PointVector pointsOut) {
 
 	// calculate the 2D bounds of the point cloud
-	LTBounds bounds;
+	LTBounds bounds(n);
 	bounds.addInput(0, pointsIn);
-	bounds.start(SERVER, PORT, NUM_WORKERS);
+	bounds.start(SERVER, PORT, threads);
 
 	// transform all the points to lie in the unit square
-	LTNorm norm;
+	LTNorm norm(n);
 	norm.addInput(0, pointsIn);
 	norm.addOutput(0, pointsOut);
-	norm.start(SERVER, PORT, NUM_WORKERS);
+	norm.start(SERVER, PORT, threads);
 
 }
 
 //===========================================================================//
 
+LTBounds::LTBounds(index_t n): n(n) { }
+
 void LTBounds::consumeInput() {
 
 	// create a tuple synch lock
@@ -51,10 +53,10 @@ void LTBounds::consumeInput() {
 
 	// split points, based on a cluster size of the square-root of the
 	// number of points given.
-	index_t skip = (size_t) sqrt((real) NORM_N);
-	for (index_t pos = 0; pos < NORM_N; pos += skip) {
+	index_t skip = (size_t) sqrt((real) n);
+	for (index_t pos = 0; pos < n; pos += skip) {
 		send->elements[1].data.i = pos;
-		send->elements[2].data.i = std::min(pos + skip, NORM_N);
+		send->elements[2].data.i = std::min(pos + skip, n);
 		put_tuple(send, &ctx);
 	}
 
@@ -139,7 +141,7 @@ void LTBounds::work() {
 void LTBounds::produceOutput() {
 
 	// wait for all rows to be done.
-	tuple *allPointsReporting = make_tuple("si", POINTS_DONE, NORM_N);
+	tuple *allPointsReporting = make_tuple("si", POINTS_DONE, (int) n);
 	get_tuple(allPointsReporting, &ctx);
 
 	// at this point minPoint and maxPoint tuples exist in the space
@@ -152,6 +154,8 @@ void LTBounds::produceOutput() {
 
 //===========================================================================//
 
+LTNorm::LTNorm(index_t n): n(n) { }
+
 void LTNorm::consumeInput() {
 
 	// tuple template
@@ -159,10 +163,10 @@ void LTNorm::consumeInput() {
 
 	// split points, based on a cluster size of the square-root of the
 	// number of points given.
-	index_t skip = (size_t) sqrt((real) NORM_N);
-	for (index_t pos = 0; pos < NORM_N; pos += skip) {
+	index_t skip = (size_t) sqrt((real) n);
+	for (index_t pos = 0; pos < n; pos += skip) {
 		send->elements[1].data.i = pos;
-		send->elements[2].data.i = std::min(pos + skip, NORM_N);
+		send->elements[2].data.i = std::min(pos + skip, n);
 		put_tuple(send, &ctx);
 	}
 
@@ -239,7 +243,7 @@ void LTNorm::produceOutput() {
 
 	// grab all of the norm computations from the workers,
 	// in an unspecified order.
-	int computations = NORM_N;
+	int computations = n;
 	while (computations > 0) {
 
 		// get the tuple and copy it into the matrix.
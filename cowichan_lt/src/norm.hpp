@@ -16,8 +16,21 @@
 	 * values in the tuple space so they can be used later.
 	 */
 	class LTBounds: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param n the number of points.
+		 */
+		LTBounds(index_t n);
+
 	protected:
 
+		/**
+		 * The number of points.
+		 */
+		index_t n;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
@@ -46,8 +59,21 @@
 	 * lay in the unit square.
 	 */
 	class LTNorm: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param n the number of points.
+		 */
+		LTNorm(index_t n);
+
 	protected:
 
+		/**
+		 * The number of points.
+		 */
+		index_t n;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
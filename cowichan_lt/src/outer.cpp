@@ -18,16 +18,18 @@ const char* LTOuter::MATRIX_ENTRY = "outer matrix entry";
 void CowichanLinuxTuples::outer(PointVector points, Matrix matrix, Vector vector) {
 	std::cout << "outer" << std::endl;
 	// calculate the 2D bounds of the point cloud
-	LTOuter program;
+	LTOuter program(n);
 	program.addInput(0, points);
 	program.addOutput(0, matrix);
 	program.addOutput(1, vector);
-	program.start(SERVER, PORT, NUM_WORKERS);
+	program.start(SERVER, PORT, threads);
 
 }
 
 //===========================================================================//
 
+LTOuter::LTOuter(index_t n): n(n) { }
+
 void LTOuter::consumeInput() {
 
 	// create a tuple synch lock
@@ -39,10 +41,10 @@ void LTOuter::consumeInput() {
 
 	// split points, based on a cluster size of the square-root of the
 	// number of elements in the given vectors.
-	index_t skip = (size_t) sqrt((real) OUTER_N);
-	for (index_t pos = 0; pos < OUTER_N; pos += skip) {
+	index_t skip = (size_t) sqrt((real) n);
+	for (index_t pos = 0; pos < n; pos += skip) {
 		send->elements[1].data.i = pos;
-		send->elements[2].data.i = std::min(pos + skip, OUTER_N);
+		send->elements[2].data.i = std::min(pos + skip, n);
 		put_tuple(send, &ctx);
 	}
 
@@ -133,7 +135,7 @@ void LTOuter::produceOutput() {
 
 	// grab all of the outer computations from the workers,
 	// in an unspecified order.
-	int computations = (OUTER_N * (OUTER_N - 1)) / 2; // triangular portion
+	int computations = (n * (n - 1)) / 2; // triangular portion
 	while (computations > 0) {
 
 		// grab a tuple.
@@ -143,7 +145,7 @@ void LTOuter::produceOutput() {
 		real d = received->elements[3].data.d;
 
 		// put it in the upper- and lower-triangular portions of the output matrix.
-		MATRIX_SQUARE_N(matrix, row, col, OUTER_N) = MATRIX_SQUARE_N(matrix, col, row, OUTER_N) = d;
+		MATRIX_SQUARE_N(matrix, row, col, n) = MATRIX_SQUARE_N(matrix, col, row, n) = d;
 
 		// we just received and handled one computation.
 		destroy_tuple(received);
@@ -156,14 +158,14 @@ void LTOuter::produceOutput() {
 	tuple *tmpMax = make_tuple("s?", MAX_DISTANCE);
 	tuple *tupleMax = get_nb_tuple(tmpMax, &ctx);
 	real dMax = tupleMax->elements[1].data.d;
-	dMax *= OUTER_N;
-	for (index_t r = 0; r < OUTER_N; r++) {
-		MATRIX_SQUARE_N(matrix, r, r, OUTER_N) = dMax;
+	dMax *= n;
+	for (index_t r = 0; r < n; r++) {
+		MATRIX_SQUARE_N(matrix, r, r, n) = dMax;
 	}
 
 	// Finally, we can fill in the output vector.
 	// Rationale for doing this here in ::work()
-	for (index_t r = 0; r < OUTER_N; r++) {
+	for (index_t r = 0; r < n; r++) {
 		vector[r] = Point::distance(points[r], zeroPoint);
 	}
 
@@ -14,8 +14,21 @@
 	 * Performs the outer product with LinuxTuples.
 	 */
 	class LTOuter: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param n the number of points.
+		 */
+		LTOuter(index_t n);
+
 	protected:
 
+		/**
+		 * The number of points.
+		 */
+		index_t n;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
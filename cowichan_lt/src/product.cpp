@@ -10,20 +10,22 @@
 
 void CowichanLinuxTuples::product(Matrix matrix, Vector candidate, Vector solution) {
 	std::cout << "product" << std::endl;
-	LTProduct app;
+	LTProduct app(n);
 	app.addInput(0, matrix);
 	app.addInput(1, candidate);
 	app.addOutput(0, solution);
-	app.start(SERVER, PORT, NUM_WORKERS);
+	app.start(SERVER, PORT, threads);
 }
 
+LTProduct::LTProduct(index_t n): n(n) { }
+
 void LTProduct::consumeInput() {
 
 	// tuple template
 	tuple *send = make_tuple("si", "product request");
 
 	// send off a request for each grid row.
-	for (size_t y = 0; y < PRODUCT_N; ++y) {
+	for (index_t y = 0; y < n; ++y) {
 		send->elements[1].data.i = y;
 		put_tuple(send, &ctx);
 	}
@@ -55,8 +57,8 @@ void LTProduct::work() {
 
 		// perform and store the actual computation for this row.
 		real result = 0.0;
-		for (int c = 0; c < PRODUCT_N; ++c) {
-			result += MATRIX_SQUARE_N(matrix, r, c, PRODUCT_N) * VECTOR(candidate, c);
+		for (int c = 0; c < n; ++c) {
+			result += MATRIX_SQUARE_N(matrix, r, c, n) * VECTOR(candidate, c);
 		}
 		send->elements[2].data.d = result;
 	
@@ -82,7 +84,7 @@ void LTProduct::produceOutput() {
 
 	// grab all of the computations from the workers,
 	// in an unspecified order.
-	int computations = PRODUCT_N;
+	int computations = n;
 	while (computations > 0) {
 
 		// get the tuple and copy it into the matrix.
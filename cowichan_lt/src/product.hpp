@@ -14,7 +14,21 @@
 	 * Performs the product of a matrix and a vector in tuple-space.
 	 */
 	class LTProduct: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param n the number of rows and columns of the matrix.
+		 */
+		LTProduct(index_t n);
+
 	protected:
+
+		/**
+		 * The number of rows and columns of the matrix.
+		 */
+		index_t n;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
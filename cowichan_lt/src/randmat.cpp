@@ -11,29 +11,32 @@
 const char* LTRandmat::REQUEST = "randmat request";
 
 void CowichanLinuxTuples::randmat(IntMatrix matrix) {
-	LTRandmat app;
+	LTRandmat app(nr, nc, seed);
 	app.addOutput(0, matrix);
-	app.start(SERVER, PORT, NUM_WORKERS);
+	app.start(SERVER, PORT, threads);
 }
 
+LTRandmat::LTRandmat(index_t nr, index_t nc, INT_TYPE seed): nr(nr), nc(nc),
+	seed(seed) { }
+
 inline INT_TYPE LTRandmat::next(INT_TYPE& current) const {
 	return (RANDMAT_A * current + RANDMAT_C) % RAND_M;
 }
 
 void LTRandmat::setup() {
 
-    IntVector state = NEW_VECTOR_SZ(INT_TYPE, RANDMAT_NR);
+    IntVector state = NEW_VECTOR_SZ(INT_TYPE, nr);
 
     // generate first column values
-    VECTOR(state, 0) = RAND_SEED % RAND_M;
-    for (index_t row = 1; row < RANDMAT_NR; ++row) {
+    VECTOR(state, 0) = seed % RAND_M;
+    for (index_t row = 1; row < nr; ++row) {
       VECTOR(state, row) = next(VECTOR(state, row - 1));
     }
 
     // generate the A and C values for the next(k) method.
     aPrime = RANDMAT_A;
     cPrime = 1;
-    for (index_t i = 1; i < RANDMAT_NR; ++i) {
+    for (index_t i = 1; i < nr; ++i) {
       cPrime = (cPrime + aPrime) % RAND_M;
       aPrime = (aPrime * RANDMAT_A) % RAND_M;
     }
@@ -41,7 +44,7 @@ void LTRandmat::setup() {
 
     // emit the state vector to the tuple space.
     tuple *init = make_tuple("ss", "randmat state", "");
-    init->elements[1].data.s.len = sizeof(INT_TYPE) * RANDMAT_NR;
+    init->elements[1].data.s.len = sizeof(INT_TYPE) * nr;
     init->elements[1].data.s.ptr = (char*) state;
     put_tuple(init, &ctx);
     destroy_tuple(init);
@@ -57,7 +60,7 @@ void LTRandmat::consumeInput() {
 	tuple *send = make_tuple("si", REQUEST, 0);
 
 	// send off a request for each grid row.
-	for (size_t y = 0; y < RANDMAT_NR; ++y) {
+	for (index_t y = 0; y < nr; ++y) {
 		send->elements[1].data.i = y;
 		put_tuple(send, &ctx);
 	}
@@ -90,13 +93,13 @@ void LTRandmat::work() {
 		// a buffer for the results of the computation.
 		size_t row = gotten->elements[1].data.i;
 		tuple *send = make_tuple("sis", "randmat done", row, "");
-		IntVector buffer = (IntVector) NEW_VECTOR_SZ(INT_TYPE, RANDMAT_NC);
-		send->elements[2].data.s.len = sizeof(INT_TYPE) * RANDMAT_NC;
+		IntVector buffer = (IntVector) NEW_VECTOR_SZ(INT_TYPE, nc);
+		send->elements[2].data.s.len = sizeof(INT_TYPE) * nc;
 		send->elements[2].data.s.ptr = (char*) buffer;
 
 		// perform the actual computation for this row.
 		buffer[0] = VECTOR(initVector, row);
-		for (int x = 1; x < RANDMAT_NC; ++x) {
+		for (int x = 1; x < nc; ++x) {
 			buffer[x] = (aPrime * buffer[x-1] + cPrime) % RAND_M;
 		}
 	
@@ -104,7 +107,7 @@ void LTRandmat::work() {
 		put_tuple(send, &ctx);
 		destroy_tuple(gotten);
 		destroy_tuple(send);
-		delete[] buffer;
+		DELETE_ARRAY(buffer);
 
 	}
 
@@ -123,13 +126,13 @@ void LTRandmat::produceOutput() {
 
 	// grab all of the mandelbrot computations from the workers,
 	// in an unspecified order.
-	int computations = RANDMAT_NR;
+	int computations = nr;
 	while (computations > 0) {
 
 		// get the tuple and copy it into the matrix.
 		tuple* received = get_tuple(recv, &ctx);
 		memcpy(
-			&MATRIX_RECT_NC(output, received->elements[1].data.i, 0, RANDMAT_NC),
+			&MATRIX_RECT_NC(output, received->elements[1].data.i, 0, nc),
 			received->elements[2].data.s.ptr,
 			received->elements[2].data.s.len);
 		computations--;
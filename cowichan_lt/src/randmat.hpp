@@ -12,8 +12,28 @@
 	 * Tuple application to solve the bulk of the randmat cowichan problem.
 	 */
 	class LTRandmat: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param nr the number of rows.
+		 * \param nc the number of columns.
+		 * \param seed seed value of the generator.
+		 */
+		LTRandmat(index_t nr, index_t nc, INT_TYPE seed);
+
 	protected:
 
+		/**
+		 * The number of rows and columns.
+		 */
+		index_t nr, nc;
+
+		/**
+		 * Seed value of the generator.
+		 */
+		INT_TYPE seed;
+
 		/**
 		 * A value to use for the next-K parallel randmat computation.
 		 */
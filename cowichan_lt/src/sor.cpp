@@ -18,16 +18,19 @@ const char* LTSor::SOR_FLAG = "sor input consumed";
 void CowichanLinuxTuples::sor(Matrix matrix, Vector target, Vector solution) {
 	std::cout << "sor" << std::endl;
 	// calculate the 2D bounds of the point cloud
-	LTSor app;
+	LTSor app(n, sorOmega, sorTolerance, sorMaxIters);
 	app.addInput(0, matrix);
 	app.addInput(0, target);
 	app.addOutput(0, solution);
-	app.start(SERVER, PORT, NUM_WORKERS);
+	app.start(SERVER, PORT, threads);
 
 }
 
 //===========================================================================//
 
+LTSor::LTSor(index_t n, double omega, double tolerance, index_t maxIters):
+	n(n), omega(omega), tolerance(tolerance), maxIters(maxIters) { }
+
 void LTSor::consumeInput() {
 
 	// create a tuple synch lock
@@ -40,7 +43,7 @@ void LTSor::consumeInput() {
 	Matrix matrix = (Matrix) inputs[0];
 	Vector target = (Vector) inputs[1];
 	Vector solution = (Vector) outputs[0];
-	for (index_t r = 0; r < SOR_N; ++r) {
+	for (index_t r = 0; r < n; ++r) {
 		VECTOR(solution, r) = 1.0;
 	}
 
@@ -50,11 +53,11 @@ void LTSor::consumeInput() {
 	solutionTuple->elements[1].data.s.ptr = (char*) solution;
 
 	// loop until we get the desired tolerance
-	real maxDiff = (real)(2 * SOR_TOLERANCE);
-	for (index_t t = 0; (t < SOR_MAX_ITERS) && (maxDiff >= SOR_TOLERANCE); t++) {
+	real maxDiff = (real)(2 * tolerance);
+	for (index_t t = 0; (t < maxIters) && (maxDiff >= tolerance); t++) {
 
 		maxDiff = 0.0;
-		for (index_t r = 0; r < SOR_N; ++r) {
+		for (index_t r = 0; r < n; ++r) {
 
 			// compute sum
 			real sum = solutionSum(r);
@@ -62,8 +65,8 @@ void LTSor::consumeInput() {
 			// calculate new solution
 			real oldSolution = VECTOR(solution, r);
 			VECTOR(solution, r) = (real)(
-				(1.0 - SOR_OMEGA) * oldSolution +
-				SOR_OMEGA * (VECTOR(target, r) - sum) / MATRIX_SQUARE_N(matrix, r, r, SOR_N)
+				(1.0 - omega) * oldSolution +
+				omega * (VECTOR(target, r) - sum) / MATRIX_SQUARE_N(matrix, r, r, n)
 			);
 
 			// refresh the solution vector in tuple-space
@@ -101,15 +104,15 @@ real LTSor::solutionSum(index_t row) {
 
 	// split points, based on a cluster size of the square-root of the
 	// number of elements in the solution vector.
-	index_t skip = (size_t) sqrt((real) SOR_N);
-	for (index_t pos = 0; pos < SOR_N; pos += skip) {
+	index_t skip = (size_t) sqrt((real) n);
+	for (index_t pos = 0; pos < n; pos += skip) {
 		send->elements[1].data.i = pos;
-		send->elements[2].data.i = std::min(pos + skip, SOR_N);
+		send->elements[2].data.i = std::min(pos + skip, n);
 		put_tuple(send, &ctx);
 	}
 
 	// wait for all the rows to be consumed
-	rowsReporting->elements[1].data.i = SOR_N;
+	rowsReporting->elements[1].data.i = n;
 	get_tuple(rowsReporting, &ctx);
 
 	// get the sum of the tuple-space op
@@ -150,7 +153,7 @@ void LTSor::work() {
 		real sum = 0.0;
 		for (index_t col = start; col < stop; ++col) {
 			if (col != row) {
-				sum += MATRIX_SQUARE_N(matrix, row, col, SOR_N) * VECTOR(solution, col);
+				sum += MATRIX_SQUARE_N(matrix, row, col, n) * VECTOR(solution, col);
 			}
 		}
 
@@ -16,8 +16,39 @@
 	 * arbitrarily accurate. The computation is done in tuple space.
 	 */
 	class LTSor: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param n the number of rows and columns of the matrix.
+		 * \param omega relaxation factor.
+		 * \param tolerance largest change in the solution at which to stop.
+		 * \param maxIters maximum number of iterations.
+		 */
+		LTSor(index_t n, double omega, double tolerance, index_t maxIters);
+
 	protected:
 
+		/**
+		 * The number of rows and columns of the matrix.
+		 */
+		index_t n;
+
+		/**
+		 * Relaxation factor.
+		 */
+		double omega;
+
+		/**
+		 * Largest change in the solution at which to stop.
+		 */
+		double tolerance;
+
+		/**
+		 * Maximum number of iterations.
+		 */
+		index_t maxIters;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
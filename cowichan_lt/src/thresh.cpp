@@ -21,20 +21,23 @@ const char* LTThresh::POINT = "thresh point";
 void CowichanLinuxTuples::thresh(IntMatrix matrix, BoolMatrix outMatrix) {
 
 	// calculate the frequency breaking-point
-	LTFrequency freq;
+	LTFrequency freq(nr, nc, threshPercent);
 	freq.addInput(0, matrix);
-	freq.start(SERVER, PORT, NUM_WORKERS);
+	freq.start(SERVER, PORT, threads);
 
 	// calculate
-	LTThresh thresh;
+	LTThresh thresh(nr, nc);
 	thresh.addInput(0, matrix);
 	thresh.addOutput(0, outMatrix);
-	thresh.start(SERVER, PORT, NUM_WORKERS);
+	thresh.start(SERVER, PORT, threads);
 
 }
 
 //===========================================================================//
 
+LTFrequency::LTFrequency(index_t nr, index_t nc, real percent):
+	nr(nr), nc(nc), percent(percent) { }
+
 void LTFrequency::consumeInput() {
 
 	// create a tuple synch lock
@@ -49,7 +52,7 @@ void LTFrequency::consumeInput() {
 	destroy_tuple(rowsReporting);
 
 	// communicate all of the rows
-	for (size_t y = 0; y < THRESH_NR; ++y) {
+	for (index_t y = 0; y < nr; ++y) {
 		tuple *send = make_tuple("si", REQUEST, y);
 		put_tuple(send, &ctx);
 		destroy_tuple(send);
@@ -74,8 +77,8 @@ void LTFrequency::work() {
 
 		// perform the actual computation for this row (counting)
 		std::map<INT_TYPE, size_t> freq;
-		for (index_t x = 0; x < THRESH_NC; ++x) {
-			freq[MATRIX_RECT_NC(matrix, y,x, THRESH_NC)] += 1;
+		for (index_t x = 0; x < nc; ++x) {
+			freq[MATRIX_RECT_NC(matrix, y,x, nc)] += 1;
 		}
 
 		// purge local memory of the tuple we received
@@ -118,12 +121,12 @@ void LTFrequency::work() {
 void LTFrequency::produceOutput() {
 
 	// wait for all rows to be done.
-	tuple *allRowsReporting = make_tuple("si", ROWS_DONE, THRESH_NR);
+	tuple *allRowsReporting = make_tuple("si", ROWS_DONE, (int) nr);
 	destroy_tuple(get_tuple(allRowsReporting, &ctx));
 	destroy_tuple(allRowsReporting);
 
 	// figure out when we have to stop.
-	index_t retain = (index_t)(THRESH_PERCENT * THRESH_NC * THRESH_NR);
+	index_t retain = (index_t)(percent * nc * nr);
 
 	// go through all tuple values until we have reached the threshold point
 	for (size_t n = 0; n < MAXIMUM_INT; ++n) {
@@ -165,10 +168,12 @@ void LTFrequency::produceOutput() {
 
 //===========================================================================//
 
+LTThresh::LTThresh(index_t nr, index_t nc): nr(nr), nc(nc) { }
+
 void LTThresh::consumeInput() {
 
 	// send off a request for each grid row.
-	for (size_t y = 0; y < THRESH_NR; ++y) {
+	for (index_t y = 0; y < nr; ++y) {
 		tuple *send = make_tuple("si", REQUEST, y);
 		put_tuple(send, &ctx);
 		destroy_tuple(send);
@@ -198,19 +203,19 @@ void LTThresh::work() {
 		// a buffer for the results of the computation.
 		index_t y = gotten->elements[1].data.i;
 		tuple *send = make_tuple("sis", DONE, y, "");
-		BoolVector buffer = (BoolVector) NEW_VECTOR_SZ(bool, THRESH_NC);
-		send->elements[2].data.s.len = sizeof(bool) * THRESH_NC;
+		BoolVector buffer = (BoolVector) NEW_VECTOR_SZ(bool, nc);
+		send->elements[2].data.s.len = sizeof(bool) * nc;
 		send->elements[2].data.s.ptr = (char*) buffer;
 
 		// perform the actual computation for this row.
-		for (index_t x = 0; x < THRESH_NC; ++x) {
-			buffer[x] = (MATRIX_RECT_NC(input, y,x, THRESH_NC) > threshold);
+		for (index_t x = 0; x < nc; ++x) {
+			buffer[x] = (MATRIX_RECT_NC(input, y,x, nc) > threshold);
 		}
 
 		// send off the new tuple and purge local memory of the one we got
 		put_tuple(send, &ctx);
 		destroy_tuple(gotten);
-		delete[] buffer;
+		DELETE_ARRAY(buffer);
 
 	}
 
@@ -227,15 +232,15 @@ void LTThresh::produceOutput() {
 
 	// grab all of the threshold computations from the workers,
 	// in an unspecified order.
-	int computations = THRESH_NR;
+	int computations = nr;
 	while (computations > 0) {
 
 		// get the tuple and copy it into the matrix.
 		tuple *recv = make_tuple("s??", DONE);
 		tuple* received = get_tuple(recv, &ctx);
 		BoolVector bv = (BoolVector) received->elements[2].data.s.ptr;
-		for (index_t x = 0; x < THRESH_NC; ++x) {
-			MATRIX_RECT_NC(output, received->elements[1].data.i, x, THRESH_NC) = bv[x];
+		for (index_t x = 0; x < nc; ++x) {
+			MATRIX_RECT_NC(output, received->elements[1].data.i, x, nc) = bv[x];
 		}
 		destroy_tuple(recv);
 
@@ -16,8 +16,28 @@
 	 * lay under the mark.
 	 */
 	class LTFrequency: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param nr the number of rows.
+		 * \param nc the number of columns.
+		 * \param percent fraction of the cells to retain.
+		 */
+		LTFrequency(index_t nr, index_t nc, real percent);
+
 	protected:
 
+		/**
+		 * The number of rows and columns.
+		 */
+		index_t nr, nc;
+
+		/**
+		 * Fraction of the cells to retain.
+		 */
+		real percent;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
@@ -47,8 +67,22 @@
 	 * false (not).
 	 */
 	class LTThresh: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param nr the number of rows.
+		 * \param nc the number of columns.
+		 */
+		LTThresh(index_t nr, index_t nc);
+
 	protected:
 
+		/**
+		 * The number of rows and columns.
+		 */
+		index_t nr, nc;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
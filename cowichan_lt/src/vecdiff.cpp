@@ -18,11 +18,11 @@ real CowichanLinuxTuples::vecdiff(Vector actual, Vector computed) {
 	real answer;
 
 	// calculate the 2D bounds of the point cloud
-	LTVecdiff program;
+	LTVecdiff program(n);
 	program.addInput(0, actual);
 	program.addInput(1, computed);
 	program.addOutput(0, &answer);
-	program.start(SERVER, PORT, NUM_WORKERS);
+	program.start(SERVER, PORT, threads);
 
 	// pass back the answer
 	return answer;
@@ -31,6 +31,8 @@ real CowichanLinuxTuples::vecdiff(Vector actual, Vector computed) {
 
 //===========================================================================//
 
+LTVecdiff::LTVecdiff(index_t n): n(n) { }
+
 void LTVecdiff::consumeInput() {
 
 	// create a tuple synch lock
@@ -47,10 +49,10 @@ void LTVecdiff::consumeInput() {
 
 	// split points, based on a cluster size of the square-root of the
 	// number of elements in the given vectors.
-	index_t skip = (size_t) sqrt((real) VECDIFF_N);
-	for (index_t pos = 0; pos < VECDIFF_N; pos += skip) {
+	index_t skip = (size_t) sqrt((real) n);
+	for (index_t pos = 0; pos < n; pos += skip) {
 		send->elements[1].data.i = pos;
-		send->elements[2].data.i = std::min(pos + skip, VECDIFF_N);
+		send->elements[2].data.i = std::min(pos + skip, n);
 		put_tuple(send, &ctx);
 	}
 
@@ -113,7 +115,7 @@ void LTVecdiff::work() {
 void LTVecdiff::produceOutput() {
 
 	// wait for all rows to be done.
-	tuple *allElsReporting = make_tuple("si", ELEMENTS_DONE, VECDIFF_N);
+	tuple *allElsReporting = make_tuple("si", ELEMENTS_DONE, (int) n);
 	get_tuple(allElsReporting, &ctx);
 
 	// we can now record the final maximum norm
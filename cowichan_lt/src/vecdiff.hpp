@@ -14,8 +14,21 @@
 	 * Performs the vector difference with LinuxTuples.
 	 */
 	class LTVecdiff: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param n the number of elements of the vectors.
+		 */
+		LTVecdiff(index_t n);
+
 	protected:
 
+		/**
+		 * The number of elements of the vectors.
+		 */
+		index_t n;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
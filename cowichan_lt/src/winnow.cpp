@@ -20,12 +20,12 @@ void CowichanLinuxTuples::winnow(IntMatrix matrix, BoolMatrix mask, PointVector
 	bool notEnoughPoints = false;
 
 	// calculate the 2D bounds of the point cloud
-	LTWinnow program;
+	LTWinnow program(nr, nc, n);
 	program.addInput(0, matrix);
 	program.addInput(1, mask);
 	program.addOutput(0, points);
 	program.addOutput(1, &notEnoughPoints);
-	program.start(SERVER, PORT, NUM_WORKERS);
+	program.start(SERVER, PORT, threads);
 
 	// error condition set by LTWinnow::produceOutput
 	if (notEnoughPoints) {
@@ -36,6 +36,8 @@ void CowichanLinuxTuples::winnow(IntMatrix matrix, BoolMatrix mask, PointVector
 
 //===========================================================================//
 
+LTWinnow::LTWinnow(index_t nr, index_t nc, index_t n): nr(nr), nc(nc), n(n) { }
+
 void LTWinnow::consumeInput() {
 
 	// create a tuple synch lock
@@ -52,7 +54,7 @@ void LTWinnow::consumeInput() {
 	destroy_tuple(rowsReporting);
 
 	// allow workers to grab work by-the-row
-	for (index_t row = 0; row < WINNOW_NR; ++row) {
+	for (index_t row = 0; row < nr; ++row) {
 		send->elements[1].data.i = row;
 		put_tuple(send, &ctx);
 	}
@@ -81,8 +83,8 @@ void LTWinnow::work() {
 		// perform the actual computation for these elements;
 		// check mask and add points to tuple space/count
 		index_t sum = 0;
-		for (index_t c = 0; c < WINNOW_NC; ++c) {
-			if (MATRIX_RECT_NC(mask, r, c, WINNOW_NC)) {
+		for (index_t c = 0; c < nc; ++c) {
+			if (MATRIX_RECT_NC(mask, r, c, nc)) {
 
 				++sum;
 
@@ -90,7 +92,7 @@ void LTWinnow::work() {
 				Point pt((real)c, (real)r);
 				send->elements[1].data.s.len = sizeof(WeightedPoint);
 				send->elements[1].data.s.ptr = (char*) &pt;
-				send->elements[2].data.i = MATRIX_RECT_NC(matrix, r, c, WINNOW_NC); // weight
+				send->elements[2].data.i = MATRIX_RECT_NC(matrix, r, c, nc); // weight
 				put_tuple(send, &ctx);
 
 			}
@@ -158,7 +160,7 @@ Point LTWinnow::nextWeightedPoint(INT_TYPE* order) {
 void LTWinnow::produceOutput() {
 
 	// wait for all rows to be computed.
-	tuple *rowsReporting = make_tuple("si", ROWS_DONE, WINNOW_NR);
+	tuple *rowsReporting = make_tuple("si", ROWS_DONE, (int) nr);
 	destroy_tuple(get_tuple(rowsReporting, &ctx));
 	destroy_tuple(rowsReporting);
 
@@ -169,7 +171,7 @@ void LTWinnow::produceOutput() {
 	tuple *tmpCount = make_tuple("s?", COUNT);
 	tuple *tupleCount = get_tuple(tmpCount, &ctx);
 	index_t count = tupleCount->elements[1].data.i;
-	if (count < WINNOW_N) {
+	if (count < n) {
 
 		std::cout << count << std::endl;
 
@@ -183,7 +185,7 @@ void LTWinnow::produceOutput() {
 	destroy_tuple(tupleCount);
 
 	// selection stride.
-	index_t stride = count / WINNOW_N;
+	index_t stride = count / n;
 
 	// loop over all generated points.
 	Point current;
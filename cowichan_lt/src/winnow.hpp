@@ -15,8 +15,28 @@
 	 * Uses a property of tuple-space which means no sorting needs to occur!
 	 */
 	class LTWinnow: public TupleApplication {
+	public:
+
+		/**
+		 * Constructor.
+		 * \param nr the number of rows.
+		 * \param nc the number of columns.
+		 * \param n the number of points to select.
+		 */
+		LTWinnow(index_t nr, index_t nc, index_t n);
+
 	protected:
 
+		/**
+		 * The number of rows and columns.
+		 */
+		index_t nr, nc;
+
+		/**
+		 * The number of points to select.
+		 */
+		index_t n;
+
 		void consumeInput();
 		void work();
 		void produceOutput();
@@ -1,4 +1,4 @@
 #!/bin/sh
 # not tested
-g++ -Wall -m32 -I../../boost/include/boost-1_37 -I../../MPICH/Include" -L../../boost/lib -L../../MPICH/Lib" -lmpich -D LIN32 -O2 -c ../cowichan/cowichan.cpp
-g++ -Wall -m32 -I../../boost/include/boost-1_37 -I../../MPICH/Include" -L../../boost/lib -L../../MPICH/Lib" -lmpich -D LIN32 -O2 -o cowichan_openmp *.cpp cowichan.o
+g++ -Wall -m32 -I../../boost/include/boost-1_37 -I../../MPICH/Include" -L../../boost/lib -L../../MPICH/Lib" -lmpich -D LIN32 -O2 -c ../cowichan/*.cpp
+g++ -Wall -m32 -I../../boost/include/boost-1_37 -I../../MPICH/Include" -L../../boost/lib -L../../MPICH/Lib" -lmpich -D LIN32 -O2 -o cowichan_openmp *.cpp *.o
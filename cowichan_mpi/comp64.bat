@@ -1,3 +1,3 @@
 REM not tested
-g++ -Wall -m64 -I..\..\boost2\include\boost-1_37 -I"C:\Program Files\MPICH2\Include" -L..\..\boost2\lib -L"C:\Program Files\MPICH2\Lib" -lmpi -lcxx -O2 -D WIN64 -c ../cowichan/cowichan.cpp
-g++ -Wall -m64 -I..\..\boost2\include\boost-1_37 -I"C:\Program Files\MPICH2\Include" -L..\..\boost2\lib -L"C:\Program Files\MPICH2\Lib" -lmpi -lcxx -O2 -D WIN64 -o cowichan_openmp *.cpp cowichan.o
+g++ -Wall -m64 -I..\..\boost2\include\boost-1_37 -I"C:\Program Files\MPICH2\Include" -L..\..\boost2\lib -L"C:\Program Files\MPICH2\Lib" -lmpi -lcxx -O2 -D WIN64 -c ../cowichan/*.cpp
+g++ -Wall -m64 -I..\..\boost2\include\boost-1_37 -I"C:\Program Files\MPICH2\Include" -L..\..\boost2\lib -L"C:\Program Files\MPICH2\Lib" -lmpi -lcxx -O2 -D WIN64 -o cowichan_openmp *.cpp *.o
@@ -1,4 +1,4 @@
 #!/bin/sh
 # not tested
-g++ -Wall -m64 -I../../boost2/include/boost-1_37 -I../../MPICH2/Include" -L../../boost2/lib -L../../MPICH2/Lib" -lmpi -lcxx -D LIN64 -O2 -c ../cowichan/cowichan.cpp
-g++ -Wall -m64 -I../../boost2/include/boost-1_37 -I../../MPICH2/Include" -L../../boost2/lib -L../../MPICH2/Lib" -lmpi -lcxx -D LIN64 -O2 -o cowichan_openmp *.cpp cowichan.o
+g++ -Wall -m64 -I../../boost2/include/boost-1_37 -I../../MPICH2/Include" -L../../boost2/lib -L../../MPICH2/Lib" -lmpi -lcxx -D LIN64 -O2 -c ../cowichan/*.cpp
+g++ -Wall -m64 -I../../boost2/include/boost-1_37 -I../../MPICH2/Include" -L../../boost2/lib -L../../MPICH2/Lib" -lmpi -lcxx -D LIN64 -O2 -o cowichan_openmp *.cpp *.o
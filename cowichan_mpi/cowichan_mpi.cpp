@@ -31,6 +31,16 @@ CowichanMPI::CowichanMPI(const mpi::communicator& world) : world(world)
 {
 }
 
+index_t CowichanMPI::setNumThreads(index_t /* threads */)
+{
+  return world.size();
+}
+
+void CowichanMPI::pinThreads()
+{
+  affinity_pin (world.rank());
+}
+
 
 namespace cowichan_mpi
 {
@@ -18,25 +18,6 @@ namespace mpi = boost::mpi;
 namespace cowichan_mpi
 {
 
-/**
- * Initialise the random state.
- * \param seed seed value
- * \param width number of participants
- * \param state per-thread state vector
- * \param aPrime new multiplicative
- * \param cPrime new additive value
- */
-void randStateInit(INT_TYPE seed, index_t width, IntVector state,
-    INT_TYPE* aPrime, INT_TYPE* cPrime);
-
-/**
- * Calculate a point in the mandelbrot set.
- * \param x x co-ordinate in the mandelbrot set.
- * \param y y co-ordinate in the mandelbrot set.
- * \return lesser of number of iterations to diverge and maximum iterations.
- */
-INT_TYPE mandel_calc (real x, real y);
-
 /**
  * Get a block (start, end) to work on in the range (lo, hi) for the current
  * process.
@@ -143,6 +124,17 @@ protected: // chaining functions
   void product(Matrix matrix, Vector candidate, Vector solution);
   real vecdiff(Vector actual, Vector computed);
 
+  /**
+   * The number of processes is fixed by mpirun.
+   * \return The number of processes.
+   */
+  index_t setNumThreads(index_t threads);
+
+  /**
+   * Pins each process to the processor of its rank.
+   */
+  void pinThreads();
+
 public:
 
   /**
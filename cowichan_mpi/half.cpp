@@ -68,7 +68,7 @@ void CowichanMPI::half (IntMatrix matrixIn, IntMatrix matrixOut)
   }
 
   // cleanup
-  delete [] tmp_matrix;
+  DELETE_ARRAY(tmp_matrix);
 
   /* return */
 }
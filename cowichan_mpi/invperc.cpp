@@ -5,139 +5,566 @@
  */
 
 #include "cowichan_mpi.hpp"
-#include <queue>
+#include <functional>
 
 namespace cowichan_mpi
 {
 
 /**
- * \brief Percolation point.
+ * Key of a cell for comparisons across processes: value << 32 | cell, in the
+ * order of InvpercBuckets.
+ */
+#define INVPERC_KEY(value, cell) (((UINT64)(value) << 32) | (UINT32)(cell))
+
+/**
+ * Key of no cell, after every other key.
+ */
+#define INVPERC_NO_KEY (~(UINT64)0)
+
+/**
+ * \brief One process's part of invasion percolation: a block of rows, with
+ * its frontier cells.
  *
- * These are put into a heap to extract the one with lowest value.
+ * Every process keeps the values of its rows and of the rows just above and
+ * below them (the halo), and a frontier and a bitmap of its own cells only.
+ * Cells are filled in rounds, as with InvpercBatch: all processes agree on
+ * the lowest frontier value (a reduction), pick the same limit and flood
+ * from their frontier cells up to it. A flood reaching a halo cell sends it
+ * to its owner, which floods on from it; the processes exchange such cells
+ * with their neighbours until none of them has cells left to visit, or the
+ * flood no longer fits.
+ *
+ * When even a flood at the lowest value does not fit, cells are filled one
+ * at a time: all processes share the key of their first cell, and the
+ * process with the lowest one fills its first cells for as long as they
+ * stay below the keys of the others and of the halo cells it reached.
+ *
+ * The frontiers are InvpercBuckets, so every value of the matrix has to be
+ * below INVPERC_BUCKETS_MAX (see bounded).
  */
-class PercPoint {
+class InvpercBlock {
 public:
 
   /**
-   * Point.
+   * Seed invasion percolation with the middle cell.
+   * \param world communicator.
+   * \param values the matrix (only the rows of the block and its halo are
+   * read).
+   * \param filled the mask, with every filled cell of the block set.
+   * \param nfill number of cells to fill (at most rows * cols).
    */
-  Point point;
+  InvpercBlock(const mpi::communicator& world,
+      const MatrixView<INT_TYPE>& values, const MatrixView<bool>& filled,
+      index_t nfill);
 
   /**
-   * Matrix.
+   * \return Whether the frontiers hold every value of the matrix (the same
+   * on every process).
    */
-  IntMatrix matrix;
+  bool bounded() const {
+    return InvpercBuckets::holds(largest);
+  }
 
   /**
-   * Number of columns.
+   * Fill the cells of the block (every process has to call it, and only
+   * when bounded).
    */
-  index_t nc;
+  void fill();
 
-public:
+private:
 
   /**
-   * Construct a percolation point.
-   * \param point point.
+   * \param cell row-major index of a cell.
+   * \return Whether the cell is in the block.
    */
-  PercPoint(Point point): point(point) { }
+  bool own(UINT32 cell) const {
+    return cell >= (UINT64)lo * nc && cell < (UINT64)hi * nc;
+  }
 
   /**
-   * Less than comparison - we want to extract lowest values.
-   * \param other right hand side percolation point.
+   * \param cell row-major index of a cell of the block or its halo.
+   * \return Its value.
    */
-  bool operator<(const PercPoint &other) const {
-    return value() > other.value();
+  INT_TYPE value(UINT32 cell) const {
+    return block[cell - top * nc];
   }
 
   /**
-   * Get the value at this point.
-   * \return value from the matrix.
+   * Mark a cell of the block as filled, in the frontier or in the flood.
+   * \param cell row-major index of the cell.
+   * \return Whether it was not marked before.
    */
-  INT_TYPE value() const {
-    return MATRIX_RECT(matrix, (index_t)point.y, (index_t)point.x);
-  }
+  bool claim(UINT32 cell);
+
+  /**
+   * Clear the mark of a cell of the block.
+   * \param cell row-major index of the cell.
+   */
+  void release(UINT32 cell);
+
+  /**
+   * Claim the cells of the block next to a cell of the flood (up to the
+   * limit for the flood, above it for the frontier), and queue its halo
+   * neighbours for their owners.
+   * \param cell row-major index of the cell.
+   */
+  void visit(UINT32 cell);
+
+  /**
+   * Flood from the frontier cells up to the limit, across the processes.
+   * \return Number of cells in the whole flood, or more than the budget when
+   * it did not fit.
+   */
+  index_t flood();
+
+  /**
+   * Fill cells one at a time, as invperc_fill would next, across the
+   * processes.
+   * \return Whether there are frontier cells left.
+   */
+  bool step();
+
+  /**
+   * Send the halo cells queued to their owners, and receive the cells of the
+   * block the neighbours reached.
+   */
+  void exchange();
+
+  /**
+   * Communicator.
+   */
+  const mpi::communicator& world;
+
+  /**
+   * The mask.
+   */
+  MatrixView<bool> filled;
+
+  /**
+   * Size of the matrix, rows of the block (hi excluded) and of the block
+   * with its halo (bottom excluded).
+   */
+  index_t nr, nc, lo, hi, top, bottom;
+
+  /**
+   * Whether the block has rows.
+   */
+  bool work;
+
+  /**
+   * Values of the block and its halo, and the largest value of all blocks.
+   */
+  std::vector<INT_TYPE> block;
+  INT_TYPE largest;
+
+  /**
+   * Bit c % 64 of word c / 64 is set when cell lo * nc + c is filled, in
+   * the frontier or in the flood.
+   */
+  std::vector<UINT64> seen;
+
+  /**
+   * Frontier cells of the block.
+   */
+  InvpercBuckets frontier;
+
+  /**
+   * Number of cells left to fill, in all blocks.
+   */
+  index_t left;
+
+  /**
+   * Limit of the round, and how far the next one goes above the lowest
+   * value (0 after a flood that did not fit).
+   */
+  INT_TYPE limit;
+  UINT64 span;
+
+  /**
+   * Lowest limit known not to fit.
+   */
+  UINT64 ceiling;
+
+  /**
+   * Cells to fill one at a time before the next flood, and after the next
+   * flood at the lowest value that does not fit.
+   */
+  index_t steps, backoff;
+
+  /**
+   * Most cells the flood may have.
+   */
+  index_t budget;
+
+  /**
+   * Frontier cells up to the limit, cells of the block claimed up to the
+   * limit and above it.
+   */
+  std::vector<UINT32> seeds, grown, edge;
+
+  /**
+   * Halo cells reached above and below the block, and cells of the block
+   * the neighbours reached.
+   */
+  std::vector<UINT32> up, down, reached;
+
+  // not copyable
+  InvpercBlock(const InvpercBlock&);
+  InvpercBlock& operator=(const InvpercBlock&);
 
 };
 
+InvpercBlock::InvpercBlock(const mpi::communicator& world,
+    const MatrixView<INT_TYPE>& values, const MatrixView<bool>& filled,
+    index_t nfill): world(world), filled(filled), nr(values.rows()),
+    nc(values.cols()), left(nfill), limit(0), span(0), ceiling(0), steps(0),
+    backoff(1), budget(0)
+{
+  invperc_check(values);
+
+  work = get_block(world, 0, nr, &lo, &hi);
+  if (!work) {
+    lo = hi = 0;
+  }
+  top = std::max(lo - 1, (index_t)0);
+  bottom = work ? std::min(hi + 1, nr) : 0;
+
+  try {
+    block.resize((size_t)((bottom - top) * nc));
+    seen.resize((size_t)((hi - lo) * nc / BITS_PER_WORD + 1), 0);
+  }
+  catch (...) {out_of_memory();}
+
+  INT_TYPE most = 0;
+  for (index_t r = top; r < bottom; r++) {
+    for (index_t c = 0; c < nc; c++) {
+      block[(r - top) * nc + c] = values(r, c);
+      most = std::max(most, values(r, c));
+    }
+  }
+  all_reduce(world, most, largest, mpi::maximum<INT_TYPE>());
+
+  // "seed" with the middle value
+  UINT32 cell = (UINT32)(nr / 2 * nc + nc / 2);
+  if (bounded() && own(cell)) {
+    claim(cell);
+    frontier.push(value(cell), cell);
+  }
 }
 
-/*****************************************************************************/
+bool InvpercBlock::claim(UINT32 cell)
+{
+  UINT32 local = (UINT32)(cell - lo * nc);
+  UINT64& word = seen[local / BITS_PER_WORD];
+  UINT64 bit = (UINT64)1 << (local % BITS_PER_WORD);
+  if ((word & bit) != 0) {
+    return false;
+  }
+  word |= bit;
+  return true;
+}
 
-void CowichanMPI::invperc(IntMatrix matrix, BoolMatrix mask) {
-  
-  if (nr * nc < invpercNFill) {
-    not_enough_points();
+void InvpercBlock::release(UINT32 cell)
+{
+  UINT32 local = (UINT32)(cell - lo * nc);
+  seen[local / BITS_PER_WORD] &= ~((UINT64)1 << (local % BITS_PER_WORD));
+}
+
+void InvpercBlock::visit(UINT32 cell)
+{
+  index_t r = cell / nc;
+  index_t c = cell % nc;
+  index_t rr[4] = {r - 1, r + 1, r, r}, cc[4] = {c, c, c - 1, c + 1};
+
+  // add all of its neighbours to the party...
+  try {
+    for (int k = 0; k < 4; k++) {
+      if (rr[k] < 0 || rr[k] >= nr || cc[k] < 0 || cc[k] >= nc) {
+        continue;
+      }
+      UINT32 next = (UINT32)(rr[k] * nc + cc[k]);
+      if (rr[k] < lo) {
+        up.push_back(next);
+      }
+      else if (rr[k] >= hi) {
+        down.push_back(next);
+      }
+      else if (claim(next)) {
+        if (value(next) <= limit) {
+          grown.push_back(next);
+        }
+        else {
+          edge.push_back(next);
+        }
+      }
+    }
+  }
+  catch (...) {out_of_memory();}
+}
+
+void InvpercBlock::exchange()
+{
+  index_t rank = world.rank();
+  bool above = work && lo > 0, below = work && hi < nr;
+  int upCount = (int)up.size(), downCount = (int)down.size();
+  int fromAbove = 0, fromBelow = 0;
+  std::vector<mpi::request> requests;
+
+  // counts first, then cells
+  if (above) {
+    requests.push_back(world.isend((int)rank - 1, 0, upCount));
+    requests.push_back(world.irecv((int)rank - 1, 0, fromAbove));
+  }
+  if (below) {
+    requests.push_back(world.isend((int)rank + 1, 0, downCount));
+    requests.push_back(world.irecv((int)rank + 1, 0, fromBelow));
+  }
+  mpi::wait_all(requests.begin(), requests.end());
+  requests.clear();
+
+  try {
+    reached.resize((size_t)(fromAbove + fromBelow));
+  }
+  catch (...) {out_of_memory();}
+
+  if (upCount > 0) {
+    requests.push_back(world.isend((int)rank - 1, 1, &up[0], upCount));
+  }
+  if (fromAbove > 0) {
+    requests.push_back(world.irecv((int)rank - 1, 1, &reached[0],
+        fromAbove));
+  }
+  if (downCount > 0) {
+    requests.push_back(world.isend((int)rank + 1, 1, &down[0], downCount));
+  }
+  if (fromBelow > 0) {
+    requests.push_back(world.irecv((int)rank + 1, 1, &reached[fromAbove],
+        fromBelow));
+  }
+  mpi::wait_all(requests.begin(), requests.end());
+
+  up.clear();
+  down.clear();
+}
+
+index_t InvpercBlock::flood()
+{
+  index_t count[2], total[2];
+
+  size_t next = 0;
+  for (size_t i = 0; i < seeds.size(); i++) {
+    visit(seeds[i]);
+  }
+
+  for (;;) {
+    // the cells claimed are also the ones to visit, while they may fit
+    while (next < grown.size() &&
+        (index_t)(seeds.size() + grown.size()) <= budget) {
+      visit(grown[next++]);
+    }
+
+    // the neighbours' flood goes on in the block
+    exchange();
+    try {
+      for (size_t i = 0; i < reached.size(); i++) {
+        if (claim(reached[i])) {
+          if (value(reached[i]) <= limit) {
+            grown.push_back(reached[i]);
+          }
+          else {
+            edge.push_back(reached[i]);
+          }
+        }
+      }
+    }
+    catch (...) {out_of_memory();}
+
+    // cells in the flood, and cells left to visit
+    count[0] = (index_t)(seeds.size() + grown.size());
+    count[1] = (index_t)(grown.size() - next);
+    all_reduce(world, count, 2, total, std::plus<index_t>());
+    if (total[0] > budget || total[1] == 0) {
+      return total[0];
+    }
+  }
+}
+
+bool InvpercBlock::step()
+{
+  index_t rank = world.rank(), size = world.size();
+  std::vector<UINT64> keys;
+
+  UINT64 key = frontier.empty() ? INVPERC_NO_KEY :
+      INVPERC_KEY(frontier.first(), frontier.firstCell());
+  all_gather(world, key, keys);
+
+  // the first cell, and the first one of any other block
+  index_t owner = 0;
+  for (index_t i = 1; i < size; i++) {
+    if (keys[i] < keys[owner]) {
+      owner = i;
+    }
+  }
+  if (keys[owner] == INVPERC_NO_KEY) {
+    return false;
+  }
+  UINT64 bound = INVPERC_NO_KEY;
+  for (index_t i = 0; i < size; i++) {
+    if (i != owner) {
+      bound = std::min(bound, keys[i]);
+    }
   }
 
-  PercPoint pp(Point(0, 0));
-  pp.matrix = matrix;
-  pp.nc = nc;
-  
-  // "seed" with the middle value; start a priority queue.
-  std::vector<PercPoint> points;
-
-  PercPoint initialPoint(Point((real) (nc / 2), (real) (nr / 2)));
-  initialPoint.matrix = matrix;
-  initialPoint.nc = nc;
-  points.push_back(initialPoint);
-  std::make_heap(points.begin(), points.end());
-
-  // perform invasion percolation nfill times.
-  index_t r, c;
-  for (index_t it = 0; it < invpercNFill; ++it) {
-
-    // get the highest-priority point that hasn't already
-    // been filled.
-    do {
-      std::pop_heap(points.begin(), points.end());
-      pp = points.back();
-      points.pop_back();
-      r = (index_t)pp.point.y;
-      c = (index_t)pp.point.x;
-    } while (MATRIX_RECT(mask, r, c)); // find a free one
-
-    // fill it.
-    MATRIX_RECT(mask, r, c) = true;
-
-    // add all of its neighbours to the party...
-    
-    // top neighbour
-    if (r > 0) {
-      PercPoint topPoint(Point((real)c, (real)r - 1));
-      topPoint.matrix = matrix;
-      topPoint.nc = nc;
-      points.push_back(topPoint);
-      push_heap(points.begin(), points.end());
+  index_t count = 0;
+  if (rank == owner) {
+    // fill first cells while no other block, or halo cell queued, has a
+    // lower one
+    limit = 0;
+    index_t most = std::min(steps, left);
+    while (count < most && !frontier.empty() &&
+        INVPERC_KEY(frontier.first(), frontier.firstCell()) < bound) {
+      UINT32 cell = frontier.pop();
+      filled(cell / nc, cell % nc) = true;
+      count++;
+
+      size_t above = up.size(), below = down.size();
+      visit(cell);
+      for (size_t i = 0; i < edge.size(); i++) {
+        frontier.push(value(edge[i]), edge[i]);
+      }
+      for (size_t i = 0; i < grown.size(); i++) {
+        frontier.push(value(grown[i]), grown[i]);
+      }
+      grown.clear();
+      edge.clear();
+      for (size_t i = above; i < up.size(); i++) {
+        bound = std::min(bound, INVPERC_KEY(value(up[i]), up[i]));
+      }
+      for (size_t i = below; i < down.size(); i++) {
+        bound = std::min(bound, INVPERC_KEY(value(down[i]), down[i]));
+      }
     }
-    
-    // bottom neighbour
-    if (r < (nr - 1)) {
-      PercPoint bottomPoint(Point((real)c, (real)r + 1));
-      bottomPoint.matrix = matrix;
-      bottomPoint.nc = nc;
-      points.push_back(bottomPoint);
-      push_heap(points.begin(), points.end());
+  }
+
+  // halo cells join the frontier of their block
+  exchange();
+  for (size_t i = 0; i < reached.size(); i++) {
+    if (claim(reached[i])) {
+      frontier.push(value(reached[i]), reached[i]);
     }
-    
-    // left neighbour
-    if (c > 0) {
-      PercPoint leftPoint(Point((real)c - 1, (real)r));
-      leftPoint.matrix = matrix;
-      leftPoint.nc = nc;
-      points.push_back(leftPoint);
-      push_heap(points.begin(), points.end());
+  }
+
+  broadcast(world, count, (int)owner);
+  left -= count;
+  steps -= count;
+  return true;
+}
+
+void InvpercBlock::fill()
+{
+  INT_TYPE first, lowest;
+
+  while (left > 0) {
+    while (steps > 0 && left > 0) {
+      if (!step()) {
+        return;
+      }
+    }
+    if (left == 0) {
+      return;
     }
-    
-    // right neighbour
-    if (c < (nc - 1)) {
-      PercPoint rightPoint(Point((real)c + 1, (real)r));
-      rightPoint.matrix = matrix;
-      rightPoint.nc = nc;
-      points.push_back(rightPoint);
-      push_heap(points.begin(), points.end());
+
+    first = frontier.empty() ? (INT_TYPE)0xFFFFFFFF : frontier.first();
+    all_reduce(world, first, lowest, mpi::minimum<INT_TYPE>());
+    if (lowest == (INT_TYPE)0xFFFFFFFF) {
+      // no frontier cells (or only ones of the largest value): finish one
+      // cell at a time
+      steps = left;
+      continue;
     }
-    
+
+    // the lowest value after a flood that did not fit, then halfway to its
+    // limit, or twice as far above the lowest value as last time
+    UINT64 top = (span == 0) ? lowest : (ceiling > lowest) ?
+        lowest + (ceiling - lowest) / 2 : lowest + span;
+    limit = (INT_TYPE)std::min(top, (UINT64)0xFFFFFFFFull);
+
+    seeds.clear();
+    frontier.peek(limit, seeds);
+    budget = std::min(left,
+        (index_t)((limit == lowest) ? INVPERC_FLOOD : INVPERC_GUESS));
+    index_t count = flood();
+
+    if (count <= budget) {
+      for (size_t i = 0; i < seeds.size(); i++) {
+        filled(seeds[i] / nc, seeds[i] % nc) = true;
+      }
+      for (size_t i = 0; i < grown.size(); i++) {
+        filled(grown[i] / nc, grown[i] % nc) = true;
+      }
+      left -= count;
+
+      // the seeds left the frontier, the cells above the limit joined
+      frontier.drop(limit);
+      for (size_t i = 0; i < edge.size(); i++) {
+        frontier.push(value(edge[i]), edge[i]);
+      }
+      span = std::min(2 * span + 1, (UINT64)0xFFFFFFFFull);
+      backoff = 1;
+    }
+    else {
+      // the seeds stay in the frontier; the other cells were not claimed
+      for (size_t i = 0; i < grown.size(); i++) {
+        release(grown[i]);
+      }
+      for (size_t i = 0; i < edge.size(); i++) {
+        release(edge[i]);
+      }
+      ceiling = limit;
+      span = 0;
+
+      // no flood fits: fill cells one at a time for a while, longer each
+      // time
+      if (limit == lowest) {
+        steps = backoff;
+        backoff *= 2;
+      }
+    }
+    grown.clear();
+    edge.clear();
   }
-  
 }
 
+}
+
+/*****************************************************************************/
+
+void CowichanMPI::invperc(IntMatrix matrix, BoolMatrix mask) {
+
+  index_t lo, hi; // work controls
+  index_t i; // process index
+
+  if (nr * nc < invpercNFill) {
+    not_enough_points();
+  }
+
+  // every process fills the cells of its block...
+  InvpercBlock block(world, rectView(matrix), rectView(mask), invpercNFill);
+  if (!block.bounded()) {
+    // ...unless the values are too large for buckets: every process then
+    // fills the whole mask
+    invperc_fill(rectView(matrix), rectView(mask), invpercNFill,
+        INVPERC_HEAP);
+    return;
+  }
+  block.fill();
+
+  // ...and then gets everyone else's
+  for (i = 0; i < world.size(); i++) {
+    if (get_block(world, 0, nr, &lo, &hi, i)) {
+      broadcast(world, &MATRIX_RECT(mask, lo, 0), (int)((hi - lo) * nc),
+          (int)i);
+    }
+  }
+
+}
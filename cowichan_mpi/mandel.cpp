@@ -6,20 +6,27 @@
 
 #include "cowichan_mpi.hpp"
 void CowichanMPI::mandel(IntMatrix matrix) {
-  index_t r, c; // row and column indices
+  index_t r; // row index
   real dx, dy; // per-step deltas
+  real* x = NULL; // column co-ordinates
   index_t row_count = 0;
   int i;
   mpi::status status;
   int source;
   const int WORK_REQUEST_TAG = 0;
   const int WORK_RESPONSE_TAG = 1;
-  const int NO_MORE_WORK = -1;
+  const index_t NO_MORE_WORK = -1; // same type as the row numbers
   int processed_rows = 0;
 
   dx = mandelDx / (nc - 1);
   dy = mandelDy / (nr - 1);
-  
+
+  try {
+    x = NEW_VECTOR_SZ(real, nc);
+  }
+  catch (...) {out_of_memory();}
+  mandel_columns (x, nc, mandelX0, dx, mandelCol0, false);
+
   if (world.size () > 1) {
     if (world.rank () == 0) {
       // control process
@@ -29,14 +36,14 @@ void CowichanMPI::mandel(IntMatrix matrix) {
         status = world.recv (mpi::any_source, WORK_REQUEST_TAG);
         source = status.source ();
         // send next row
-        world.isend (source, WORK_RESPONSE_TAG, row_count);
+        world.send (source, WORK_RESPONSE_TAG, row_count);
         row_count++;
       }
       // send out no more work
       for (i = 1; i < world.size (); i++) {
         status = world.recv (mpi::any_source, WORK_REQUEST_TAG);
         source = status.source ();
-        world.isend (source, WORK_RESPONSE_TAG, NO_MORE_WORK);
+        world.send (source, WORK_RESPONSE_TAG, NO_MORE_WORK);
       }
       // receive results
       for (r = 0; r < nr; r++) {
@@ -51,10 +58,8 @@ void CowichanMPI::mandel(IntMatrix matrix) {
         world.send (0, WORK_REQUEST_TAG);
         world.recv (0, WORK_RESPONSE_TAG, r);
         if (r != NO_MORE_WORK) {
-          for (c = 0; c < nc; c++) {
-            MATRIX_RECT(matrix, r, c) = mandel_calc (mandelX0 + (c * dx),
-                mandelY0 + (r * dy));
-          }
+          mandel_row (&MATRIX_RECT(matrix, r, 0), x, nc, mandel_coordinate (mandelY0, mandelRow0 + r, dy),
+              mandelMaxIter, mandelInfinity);
           processed_rows++;
           // send results
           world.isend (0, (int)(r + 1), &MATRIX_RECT(matrix, r, 0), (int)nc);
@@ -75,37 +80,13 @@ void CowichanMPI::mandel(IntMatrix matrix) {
   else {
     // compute serially, as we only have one process
     for (r = 0; r < nr; r++) {
-      for (c = 0; c < nc; c++) {
-        MATRIX_RECT(matrix, r, c) = mandel_calc (mandelX0 + (c * dx),
-            mandelY0 + (r * dy));
-      }
+      mandel_row (&MATRIX_RECT(matrix, r, 0), x, nc, mandel_coordinate (mandelY0, mandelRow0 + r, dy),
+          mandelMaxIter, mandelInfinity);
     }
   }
 
-  /* return */
-}
-
-/*****************************************************************************/
-
-namespace cowichan_mpi
-{
-
-INT_TYPE mandel_calc (real x, real y)
-{
-  real r = 0.0, i = 0.0; // real and imaginary parts
-  real rs = 0.0, is = 0.0; // " ", squared
-  INT_TYPE iter = 0; // number of iterations
-
-  do {
-    i = (((real)2.0) * r * i) + x;
-    r = (rs - is) + y;
-    iter++;
-    rs = r * r;
-    is = i * i;
-  } while ((iter < MANDEL_MAX_ITER) && ((rs + is) < MANDEL_INFINITY));
-
-  return iter;
-}
+  DELETE_ARRAY(x);
 
+  /* return */
 }
 
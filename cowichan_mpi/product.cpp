@@ -12,11 +12,11 @@ void CowichanMPI::product(Matrix matrix, Vector vector, Vector result)
   int rank;
 
   // work
-  if (get_block (world, 0, nr, &lo, &hi)) {
+  if (get_block (world, 0, n, &lo, &hi)) {
 
     for (r = lo; r < hi; r ++) {
       result[r] = MATRIX(matrix, r, 0) * vector[0];
-      for (c = 1; c < nc; c++) {
+      for (c = 1; c < n; c++) {
         result[r] += MATRIX(matrix, r, c) * vector[c];
       }
     }
@@ -25,7 +25,7 @@ void CowichanMPI::product(Matrix matrix, Vector vector, Vector result)
 
   // broadcast result
   for (rank = 0; rank < world.size (); rank++) {
-    if (get_block (world, 0, nr, &lo, &hi, rank)) {
+    if (get_block (world, 0, n, &lo, &hi, rank)) {
       broadcast (world, &result[lo], (int)(hi - lo), rank);
     }
   }
@@ -17,11 +17,11 @@ void CowichanMPI::sor(Matrix matrix, Vector target, Vector solution)
   for (r = 0; r < n; r++){
     solution[r] = 1.0;
   }
-  dmax = (real)(2 * SOR_TOLERANCE); // to forestall early exit
+  dmax = (real)(2 * sorTolerance); // to forestall early exit
 
   // work
   work = get_block (world, 0, n, &lo, &hi);
-  for (t = 0; (t < SOR_MAX_ITERS) && (dmax >= SOR_TOLERANCE); t++) {
+  for (t = 0; (t < sorMaxIters) && (dmax >= sorTolerance); t++) {
     dmax_local = 0.0;
     if (work) {
       // compute sum_local
@@ -36,8 +36,8 @@ void CowichanMPI::sor(Matrix matrix, Vector target, Vector solution)
 
         // compute difference
         old = solution[r];
-        solution[r] = (real)((1.0 - SOR_OMEGA) * old
-          + SOR_OMEGA * (target[r] - sum) / MATRIX(matrix, r, r));
+        solution[r] = (real)((1.0 - sorOmega) * old
+          + sorOmega * (target[r] - sum) / MATRIX(matrix, r, r));
         d = (real)fabs((double)(old - solution[r]));
         if (d > dmax_local) {
           dmax_local = d;
@@ -94,7 +94,7 @@ void CowichanMPI::winnow(IntMatrix matrix, BoolMatrix mask,
   std::cout << std::endl;
 #endif
 
-  delete [] weightedPoints;
+  DELETE_ARRAY(weightedPoints);
 }
 
 /*****************************************************************************/
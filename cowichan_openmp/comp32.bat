@@ -1,3 +1,3 @@
 REM not tested
-g++ -Wall -m32 -fopenmp -O2 -D WIN32 -c ../cowichan/cowichan.cpp
-g++ -Wall -m32 -fopenmp -O2 -D WIN32 -o cowichan_openmp *.cpp cowichan.o
+g++ -Wall -m32 -fopenmp -O2 -D WIN32 -c ../cowichan/*.cpp
+g++ -Wall -m32 -fopenmp -O2 -D WIN32 -o cowichan_openmp *.cpp *.o
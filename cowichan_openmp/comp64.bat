@@ -1,3 +1,3 @@
 REM not tested
-g++ -Wall -m64 -fopenmp -O2 -D WIN64 -c ../cowichan/cowichan.cpp
-g++ -Wall -m64 -fopenmp -O2 -D WIN64 -o cowichan_openmp *.cpp cowichan.o
+g++ -Wall -m64 -fopenmp -O2 -D WIN64 -c ../cowichan/*.cpp
+g++ -Wall -m64 -fopenmp -O2 -D WIN64 -o cowichan_openmp *.cpp *.o
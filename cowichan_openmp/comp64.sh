@@ -1,3 +1,3 @@
 #!/bin/sh
-g++ -Wall -m64 -fopenmp -D LIN64 -O2 -c ../cowichan/cowichan.cpp
-g++ -Wall -m64 -fopenmp -D LIN64 -O2 -o cowichan_openmp *.cpp cowichan.o
+g++ -Wall -m64 -fopenmp -D LIN64 -O2 -c ../cowichan/*.cpp
+g++ -Wall -m64 -fopenmp -D LIN64 -O2 -o cowichan_openmp *.cpp *.o
@@ -14,10 +14,76 @@ int main(int argc, char* argv[])
 {
   Cowichan* openmp = new CowichanOpenMP ();
 
-  omp_set_num_threads(2);
-
   openmp->main(argc, argv, false, true);
 
   return 0;
 }
 
+index_t CowichanOpenMP::setNumThreads(index_t threads)
+{
+  omp_set_num_threads((int)threads);
+  return threads;
+}
+
+void CowichanOpenMP::pinThreads()
+{
+  // the runtime keeps the same threads for later teams of the same size
+#pragma omp parallel
+  affinity_pin((index_t)omp_get_thread_num());
+}
+
+
+void CowichanOpenMP::firstTouch(void* array, index_t rows, size_t rowBytes)
+{
+  index_t r;
+
+  // same static partition of rows as parallelRows and the row kernels;
+  // mandel hands out its tiles dynamically to balance them instead
+#pragma omp parallel for schedule(static)
+  for (r = 0; r < rows; ++r) {
+    memset((char*)array + r * rowBytes, 0, rowBytes);
+  }
+}
+
+index_t CowichanOpenMP::parallelRows(index_t rows, RowTask& task)
+{
+  index_t r;
+  index_t sum = 0;
+
+  // static, so that each thread works on the rows it touched first
+#pragma omp parallel for schedule(static) reduction(+:sum)
+  for (r = 0; r < rows; ++r) {
+    sum += task.run(r, r + 1);
+  }
+
+  return sum;
+}
+
+void CowichanOpenMP::runBranches(ChainBranch& first, ChainBranch& second,
+    index_t firstThreads)
+{
+  if (threads < 2) {
+    Cowichan::runBranches(first, second, firstThreads);
+    return;
+  }
+
+  firstThreads = std::min(std::max(firstThreads, (index_t)1), threads - 1);
+  int levels = omp_get_max_active_levels();
+
+  // one thread per branch, each with its own nested team for the kernels
+  omp_set_max_active_levels(2);
+#pragma omp parallel sections num_threads(2)
+  {
+#pragma omp section
+    {
+      omp_set_num_threads((int)firstThreads);
+      first.run();
+    }
+#pragma omp section
+    {
+      omp_set_num_threads((int)(threads - firstThreads));
+      second.run();
+    }
+  }
+  omp_set_max_active_levels(levels);
+}
@@ -44,6 +44,19 @@ protected:
   void product(Matrix matrix, Vector candidate, Vector solution);
   real vecdiff(Vector actual, Vector computed);
 
+  void randmatHalf(IntMatrix matrix);
+  void mandelHalf(IntMatrix matrix);
+  void threshBits(IntMatrix matrix, BitMatrix& mask);
+  void lifeBits(BitMatrix& world);
+  void winnowBits(IntMatrix matrix, const BitMatrix& mask, PointVector points);
+
+  index_t setNumThreads(index_t threads);
+  void pinThreads();
+  void firstTouch(void* array, index_t rows, size_t rowBytes);
+  index_t parallelRows(index_t rows, RowTask& task);
+  void runBranches(ChainBranch& first, ChainBranch& second,
+      index_t firstThreads);
+
 public:
 
   /**
@@ -8,6 +8,7 @@
 
 void CowichanOpenMP::gauss (Matrix matrix, Vector target, Vector solution)
 {
+  MatrixView<real> a = squareView(matrix);
   index_t i, j, k;
 
   // forward elimination
@@ -15,30 +16,34 @@ void CowichanOpenMP::gauss (Matrix matrix, Vector target, Vector solution)
     // get row with maximum column i
     index_t max = i;
     for (j = i + 1; j < n; j++) {
-      if (fabs(MATRIX(matrix, j, i)) > fabs(MATRIX(matrix, max, i))) {
+      if (fabs(a(j, i)) > fabs(a(max, i))) {
         max = j;
       }
     }
 
     real tmp;
     // swap max row with row i
-    for (j = i; j < n; j++) {
-      tmp = MATRIX(matrix, i, j);
-      MATRIX(matrix, i, j) = MATRIX(matrix, max, j);
-      MATRIX(matrix, max, j) = tmp;
+    real* RESTRICT rowI = a.row(i);
+    real* RESTRICT rowMax = a.row(max);
+    if (max != i) {
+      for (j = i; j < n; j++) {
+        tmp = rowI[j];
+        rowI[j] = rowMax[j];
+        rowMax[j] = tmp;
+      }
     }
     tmp = target[i];
     target[i] = target[max];
     target[max] = tmp;
 
     // eliminate i-th column in j-th row
-    real column_i = MATRIX(matrix, i, i);
-#pragma omp parallel for schedule(static)
+    real column_i = rowI[i];
+#pragma omp parallel for schedule(static) private(k)
     for (j = i + 1; j < n; j++) {
-      real factor = -(MATRIX(matrix, j, i) / column_i);
-#pragma omp parallel for schedule(static)
+      real* RESTRICT rowJ = a.row(j);
+      real factor = -(rowJ[i] / column_i);
       for (k = n - 1; k >= i; k--) {
-        MATRIX(matrix, j, k) += MATRIX(matrix, i, k) * factor;
+        rowJ[k] += rowI[k] * factor;
       }
       target[j] += target[i] * factor;
     }
@@ -46,9 +51,9 @@ void CowichanOpenMP::gauss (Matrix matrix, Vector target, Vector solution)
 
   // back substitution
   for (k = (n - 1); k >= 0; k--) {
-    solution[k] = target[k] / MATRIX_SQUARE(matrix, k, k);
+    solution[k] = target[k] / a(k, k);
     for (i = k - 1; i >= 0; i--) {
-      target[i] = target[i] - (MATRIX_SQUARE(matrix, i, k) * solution[k]);
+      target[i] = target[i] - (a(i, k) * solution[k]);
     }
   }
 }
@@ -136,8 +136,8 @@ void quickhull(PointVector pointsIn, index_t n, PointVector pointsOut,
       }
     }
 
-    delete [] minPoints;
-    delete [] maxPoints;
+    DELETE_ARRAY(minPoints);
+    DELETE_ARRAY(maxPoints);
   }
   else {
     minPoint = &pointsIn[0];
@@ -206,8 +206,8 @@ void split (PointVector pointsIn, index_t n, PointVector pointsOut, index_t* hn,
       }
     }
 
-    delete [] maxPoints;
-    delete [] maxCrosses;
+    DELETE_ARRAY(maxPoints);
+    DELETE_ARRAY(maxCrosses);
   }
   else
   {
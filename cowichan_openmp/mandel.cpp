@@ -6,60 +6,92 @@
 
 #include "cowichan_openmp.hpp"
 
-namespace cowichan_openmp
-{
-
 /**
- * Calculate mandelbrot value.
- * \param x x-coordinate.
- * \param y y-coordinate.
- * \return Mandelbrot value.
+ * Computes the mandelbrot matrix in tiles, which threads take one at a time
+ * in row-major order as they become free.
+ * \param view the matrix.
+ * \param x x-coordinate of each column.
+ * \param y y-coordinate of each row.
+ * \param tileRows rows per tile (0 for all).
+ * \param tileCols columns per tile (0 for all).
+ * \param maxIter maximum number of iterations.
+ * \param infinity squared magnitude considered divergent.
  */
-INT_TYPE mandel_calc (real x, real y);
-
-}
+static void mandel_tiles (const MatrixView<INT_TYPE>& view, const real* x,
+    const real* y, index_t tileRows, index_t tileCols, index_t maxIter,
+    real infinity)
+{
+  index_t nr = view.rows ();
+  index_t nc = view.cols ();
+  index_t t;
 
-/*****************************************************************************/
+  if ((tileRows == 0) || (tileRows > nr)) {
+    tileRows = nr;
+  }
+  if ((tileCols == 0) || (tileCols > nc)) {
+    tileCols = nc;
+  }
 
-void CowichanOpenMP::mandel (IntMatrix matrix)
-{
-  index_t r, c;
-  real dx, dy;
+  index_t tilesAcross = (nc + tileCols - 1) / tileCols;
+  index_t tiles = tilesAcross * ((nr + tileRows - 1) / tileRows);
 
-  dx = mandelDx / (nc - 1);
-  dy = mandelDy / (nr - 1);
-  
+  // the dynamic schedule hands out tiles from a shared counter
 #pragma omp parallel for schedule(dynamic)
-  for (r = 0; r < nr; r++) {
-#pragma omp parallel for schedule(static)
-    for (c = 0; c < nc; c++) {
-      MATRIX_RECT(matrix, r, c) = mandel_calc (mandelX0 + (c * dx),
-          mandelY0 + (r * dy));
+  for (t = 0; t < tiles; t++) {
+    index_t r0 = (t / tilesAcross) * tileRows;
+    index_t c0 = (t % tilesAcross) * tileCols;
+    index_t r1 = std::min (r0 + tileRows, nr);
+    index_t width = std::min (c0 + tileCols, nc) - c0;
+
+    for (index_t r = r0; r < r1; r++) {
+      mandel_row (view.row(r) + c0, x + c0, width, y[r], maxIter, infinity);
     }
   }
 }
 
-/*****************************************************************************/
-
-namespace cowichan_openmp
+void CowichanOpenMP::mandel (IntMatrix matrix)
 {
+  real* x = NULL;
+  real* y = NULL;
 
-INT_TYPE mandel_calc (real x, real y)
-{
-  real r = 0.0, i = 0.0; // real and imaginary parts
-  real rs = 0.0, is = 0.0; // " ", squared
-  INT_TYPE iter = 0; // number of iterations
-
-  do {
-    i = (((real)2.0) * r * i) + x;
-    r = (rs - is) + y;
-    iter++;
-    rs = r * r;
-    is = i * i;
-  } while ((iter < MANDEL_MAX_ITER) && ((rs + is) < MANDEL_INFINITY));
-
-  return iter;
-}
+  try {
+    x = NEW_VECTOR_SZ(real, nc);
+    y = NEW_VECTOR_SZ(real, nr);
+  }
+  catch (...) {out_of_memory();}
 
+  mandel_columns (x, nc, mandelX0, mandelDx / (nc - 1), mandelCol0,
+      false);
+  mandel_columns (y, nr, mandelY0, mandelDy / (nr - 1), mandelRow0,
+      false);
+
+  mandel_tiles (rectView(matrix), x, y, mandelTileRows, mandelTileCols,
+      mandelMaxIter, mandelInfinity);
+
+  DELETE_ARRAY(x);
+  DELETE_ARRAY(y);
 }
 
+void CowichanOpenMP::mandelHalf (IntMatrix matrix)
+{
+  real* x = NULL;
+  real* y = NULL;
+
+  try {
+    x = NEW_VECTOR_SZ(real, nc);
+    y = NEW_VECTOR_SZ(real, nr);
+  }
+  catch (...) {out_of_memory();}
+
+  // compute the points that half would move here
+  mandel_columns (x, nc, mandelX0, mandelDx / (nc - 1), mandelCol0,
+      true);
+  mandel_columns (y, nr, mandelY0, mandelDy / (nr - 1), mandelRow0,
+      true);
+
+  mandel_tiles (rectView(matrix), x, y, mandelTileRows, mandelTileCols,
+      mandelMaxIter, mandelInfinity);
+
+  DELETE_ARRAY(x);
+  DELETE_ARRAY(y);
+}
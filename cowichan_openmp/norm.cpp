@@ -107,8 +107,8 @@ void findMinMax(PointVector points, index_t n, Point* minPoint,
     }
   }
 
-  delete [] minPoints;
-  delete [] maxPoints;
+  DELETE_ARRAY(minPoints);
+  DELETE_ARRAY(maxPoints);
 
 }
 
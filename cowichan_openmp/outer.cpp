@@ -12,6 +12,7 @@ void CowichanOpenMP::outer (PointVector points, Matrix matrix, Vector vector)
   real d; // distance between points
   real dMax; // maximum distance
   index_t r, c; // loop indices
+  MatrixView<real> distances = squareView(matrix);
 
   index_t num_threads = omp_get_max_threads();
   Vector dMaxes = NULL;
@@ -22,7 +23,7 @@ void CowichanOpenMP::outer (PointVector points, Matrix matrix, Vector vector)
   catch (...) {out_of_memory();}
 
   // all elements except matrix diagonal
-#pragma omp parallel private(dMax, d)
+#pragma omp parallel private(dMax, d, c)
   {
     index_t thread_num = omp_get_thread_num();
     d = 0.0;
@@ -30,13 +31,12 @@ void CowichanOpenMP::outer (PointVector points, Matrix matrix, Vector vector)
 #pragma omp for schedule(guided)
     for (r = 0; r < n; r++) {
       vector[r] = Point::distance (points[r], zeroPoint);
-#pragma omp parallel for schedule(static)
       for (c = 0; c < r; c++) {
         d = Point::distance (points[r], points[c]);
         if (d > dMax) {
           dMax = d;
         }
-        MATRIX_SQUARE(matrix, r, c) = MATRIX_SQUARE(matrix, c, r) = d;
+        distances(r, c) = distances(c, r) = d;
       }
     }
     dMaxes[thread_num] = dMax;
@@ -49,13 +49,13 @@ void CowichanOpenMP::outer (PointVector points, Matrix matrix, Vector vector)
     }
   }
 
-  delete [] dMaxes;
+  DELETE_ARRAY(dMaxes);
 
   // matrix diagonal
   dMax *= n;
 #pragma omp parallel for schedule(static)
   for (r = 0; r < n; r++) {
-    MATRIX_SQUARE(matrix, r, r) = dMax;
+    distances(r, r) = dMax;
   }
 }
 
@@ -8,38 +8,30 @@
 
 void CowichanOpenMP::randmat (IntMatrix matrix)
 {
-  IntVector state = NULL;
+  MatrixView<INT_TYPE> view = rectView(matrix);
+  index_t r;
 
-  // initialize first column values
-  try {
-    state = NEW_VECTOR_SZ(INT_TYPE, nr);
+  // every row jumps ahead to its place in the sequence
+#pragma omp parallel for schedule(static)
+  for (r = 0; r < nr; r++) {
+    randmat_fill (view.row(r), nc, seed, (UINT64)r * nc, 1);
   }
-  catch (...) {out_of_memory();}
+}
 
+void CowichanOpenMP::randmatHalf (IntMatrix matrix)
+{
+  MatrixView<INT_TYPE> view = rectView(matrix);
   index_t r;
-  INT_TYPE aPrime, cPrime;
 
-  state[0] = seed % RAND_M;
-  aPrime = RANDMAT_A;
-  cPrime = 1;
-  for (r = 1; r < nr; r++) {
-    state[r] = (RANDMAT_A * state[r - 1] + RANDMAT_C) % RAND_M;
-    cPrime = (cPrime + aPrime) % RAND_M;
-    aPrime = (aPrime * RANDMAT_A) % RAND_M;
-  }
-  cPrime = (cPrime * RANDMAT_C) % RAND_M;
-
-  // fill in random matrix
-  index_t c;
-  INT_TYPE v;
+  index_t middle_r = (nr + 1) / 2;
+  index_t middle_c = (nc + 1) / 2;
 
-#pragma omp parallel for schedule(static) private(c, v)
+  // fill in random matrix, each row where half would move it
+#pragma omp parallel for schedule(static)
   for (r = 0; r < nr; r++) {
-    v = state[r];
-    for (c = 0; c < nc; c++) {
-      MATRIX_RECT(matrix, r, c) = v;
-      v = (aPrime * v + cPrime) % RAND_M;
-    }
+    // half moves even columns to the left half, odd ones to the right half
+    INT_TYPE* even = view.row(half_position(r, middle_r));
+    randmat_fill (even, middle_c, seed, (UINT64)r * nc, 2);
+    randmat_fill (even + middle_c, nc / 2, seed, (UINT64)r * nc + 1, 2);
   }
 }
-
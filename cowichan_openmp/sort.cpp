@@ -61,8 +61,8 @@ void histogram_sort(WeightedPointVector vector, index_t len)
     }
   }
 
-  delete [] minWeights;
-  delete [] maxWeights;
+  DELETE_ARRAY(minWeights);
+  DELETE_ARRAY(maxWeights);
 
   // count number of elements in each bucket
   index_t** threadCounts = NULL;
@@ -101,9 +101,9 @@ void histogram_sort(WeightedPointVector vector, index_t len)
   }
 
   for (i = 0; i < num_threads; i++) {
-    delete [] threadCounts[i];
+    DELETE_ARRAY(threadCounts[i]);
   }
-  delete [] threadCounts;
+  DELETE_ARRAY(threadCounts);
 
   // calculate offsets
   index_t offset = 0;
@@ -138,7 +138,7 @@ void histogram_sort(WeightedPointVector vector, index_t len)
     vector[src] = tmpPoint;
   }
 
-  delete [] counts;
+  DELETE_ARRAY(counts);
 
   // sort individual buckets
 #pragma omp parallel for schedule(dynamic)
@@ -148,7 +148,7 @@ void histogram_sort(WeightedPointVector vector, index_t len)
     }
   }
 
-  delete [] offsets;
+  DELETE_ARRAY(offsets);
 }
 
 #if defined(LIN32) || defined(LIN64)
@@ -6,112 +6,117 @@
 
 #include "cowichan_openmp.hpp"
 
+namespace cowichan_openmp
+{
+
+/**
+ * Find the largest value that is not retained.
+ * \param values image.
+ * \param percent fraction of the cells to retain.
+ * \return Cells greater than this value are retained.
+ */
+index_t thresh_retain(const MatrixView<INT_TYPE>& values, real percent);
+
+}
+
+/*****************************************************************************/
+
 /**
  * Works only on positive input.
  */
 void CowichanOpenMP::thresh(IntMatrix matrix, BoolMatrix mask) {
 
+  index_t r;
+  MatrixView<INT_TYPE> values = rectView(matrix);
+  MatrixView<bool> selected = rectView(mask);
+
+  index_t retain = thresh_retain (values, threshPercent);
+
+  // threshold
+#pragma omp parallel for schedule(static)
+  for (r = 0; r < nr; r++) {
+    thresh_bools (selected.row(r), values.row(r), nc, retain);
+  }
+
+}
+
+void CowichanOpenMP::threshBits(IntMatrix matrix, BitMatrix& mask) {
+
+  index_t r;
+  MatrixView<INT_TYPE> values = rectView(matrix);
+
+  index_t retain = thresh_retain (values, threshPercent);
+
+  // threshold, 64 cells per word
+#pragma omp parallel for schedule(static)
+  for (r = 0; r < nr; r++) {
+    thresh_bits (mask.row(r), values.row(r), nc, retain);
+  }
+
+}
+
+/*****************************************************************************/
+
+namespace cowichan_openmp
+{
+
+index_t thresh_retain(const MatrixView<INT_TYPE>& values, real percent) {
+
   index_t* hist = NULL; // histogram
   index_t i, j;
-  index_t r, c;
-  INT_TYPE vMax; // max value in matrix
-  index_t retain; // selection
+  index_t r;
+  index_t nr = values.rows(), nc = values.cols();
+  index_t bins = 0;
 
   index_t num_threads = omp_get_max_threads();
 
-  INT_TYPE* vMaxLocal = NULL;
+  ThreshHistogram* histLocal = NULL;
   try {
-    vMaxLocal = NEW_VECTOR_SZ(INT_TYPE, num_threads);
+    histLocal = new ThreshHistogram[num_threads];
   }
   catch (...) {out_of_memory();}
 
-  // find max value in matrix
+  // count, in one pass
 #pragma omp parallel
   {
-  index_t cur_thread = omp_get_thread_num();
-  vMaxLocal[cur_thread] = 0;
+    ThreshHistogram& local = histLocal[omp_get_thread_num()];
 #pragma omp for schedule(static)
-  for (r = 0; r < nr; r++) {
-#pragma omp parallel for schedule(static)
-    for (c = 0; c < nc; c++) {
-      if (vMaxLocal[cur_thread] < MATRIX_RECT(matrix, r, c)) {
-        vMaxLocal[cur_thread] = MATRIX_RECT(matrix, r, c);
-      }
+    for (r = 0; r < nr; r++) {
+      local.count (values, r, r + 1);
     }
   }
-  }
 
-  vMax = 0;
   for (i = 0; i < num_threads; i++) {
-    if (vMax < vMaxLocal[i]) {
-      vMax = vMaxLocal[i];
-    }
-  }
-
-  delete [] vMaxLocal;
-
-  // initialize histogram
-  try {
-    hist = NEW_VECTOR_SZ(index_t, vMax + 1);
+    bins = std::max(bins, histLocal[i].bins());
   }
-  catch (...) {out_of_memory();}
 
-  index_t** histLocal = NULL;
   try {
-    histLocal = NEW_VECTOR_SZ(index_t*, num_threads);
-    for (i = 0; i < num_threads; i++) {
-      histLocal[i] = NEW_VECTOR_SZ(index_t, vMax + 1);
-    }
+    hist = NEW_VECTOR_SZ(index_t, bins);
   }
   catch (...) {out_of_memory();}
 
+  // merge, every thread a block of bins
 #pragma omp parallel for schedule(static) private(j)
-  for (i = 0; i <= (index_t)vMax; i++) {
-    hist[i] = 0;
-    for (j = 0; j < num_threads; j++) {
-      histLocal[j][i] = 0;
-    }
-  }
-
-  // count
-#pragma omp parallel
-  {
-    index_t cur_thread = omp_get_thread_num();
-#pragma omp for schedule(static)
-    for (r = 0; r < nr; r++) {
-#pragma omp parallel for schedule(static)
-      for (c = 0; c < nc; c++) {
-        histLocal[cur_thread][MATRIX_RECT(matrix, r, c)]++;
-      }
+  for (i = 0; i < bins; i += THRESH_MERGE_BINS) {
+    index_t last = std::min(i + THRESH_MERGE_BINS, bins);
+    for (j = i; j < last; j++) {
+      hist[j] = 0;
     }
-  }
-
-  for (i = 0; i < num_threads; i++) {
-    for (j = 0; j <= (index_t)vMax; j++) {
-      hist[j] += histLocal[i][j];
+    for (j = 0; j < num_threads; j++) {
+      histLocal[j].add (hist, i, last);
     }
-    delete [] histLocal[i];
   }
 
-  delete [] histLocal;
+  delete[] histLocal;
 
   // include
-  retain = (index_t)(threshPercent * nc * nr);
-  for (i = vMax; ((i >= 0) && (retain > 0)); i--) {
-    retain -= hist[i];
-  }
-  retain = i;
+  index_t retain = thresh_level (hist, bins, (index_t)(percent * nc * nr));
 
-  delete [] hist;
+  DELETE_ARRAY(hist);
 
-  // threshold
-#pragma omp parallel for schedule(static)
-  for (r = 0; r < nr; r++) {
-#pragma omp parallel for schedule(static)
-    for (c = 0; c < nc; c++) {
-      MATRIX_RECT(mask, r, c) = ((index_t)MATRIX_RECT(matrix, r, c)) > retain;
-    }
-  }
+  return retain;
+
+}
 
 }
 
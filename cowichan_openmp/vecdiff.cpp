@@ -41,7 +41,7 @@ real CowichanOpenMP::vecdiff (Vector actual, Vector computed)
     }
   }
 
-  delete [] maxDiffs;
+  DELETE_ARRAY(maxDiffs);
 
   return maxDiff;
 }
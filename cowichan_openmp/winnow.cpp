@@ -13,11 +13,19 @@ namespace cowichan_openmp
 /**
  * Count the number of set cells in each thread bucket.
  * \param mask boolean mask.
- * \param nr number of rows in mask.
- * \param nc number of columns in mask.
  * \param buckets number of cells in each bucket.
  */
-void mask_count(BoolMatrix mask, index_t nr, index_t nc, index_t* buckets);
+void mask_count(const MatrixView<bool>& mask, index_t* buckets);
+
+/**
+ * Sort weighted points and select n of them evenly, heaviest last.
+ * \param weightedPoints weighted points (sorted in place).
+ * \param len number of weighted points.
+ * \param points selected points.
+ * \param n number of points to select.
+ */
+void winnow_select(WeightedPointVector weightedPoints, index_t len,
+    PointVector points, index_t n);
 
 }
 
@@ -28,8 +36,9 @@ void CowichanOpenMP::winnow(IntMatrix matrix, BoolMatrix mask,
 
   index_t r, c;
   index_t len; // number of points
-  index_t stride; // selection stride
   index_t i;
+  MatrixView<INT_TYPE> values = rectView(matrix);
+  MatrixView<bool> selected = rectView(mask);
 
   index_t num_threads = omp_get_max_threads();
 
@@ -41,7 +50,7 @@ void CowichanOpenMP::winnow(IntMatrix matrix, BoolMatrix mask,
   catch (...) {out_of_memory();}
 
   // count set cell in each bucket
-  mask_count (mask, nr, nc, buckets);
+  mask_count (selected, buckets);
 
   // calculate offsets
   len = 0;
@@ -62,23 +71,112 @@ void CowichanOpenMP::winnow(IntMatrix matrix, BoolMatrix mask,
   catch (...) {out_of_memory();}
 
   // fill temporary vector
-#pragma omp parallel private(i)
+#pragma omp parallel private(i, c)
   {
     index_t thread_num = omp_get_thread_num();
     i = buckets[thread_num];
 #pragma omp for schedule(static)
     for (r = 0; r < nr; r++) {
-#pragma omp parallel for schedule(static)
       for (c = 0; c < nc; c++) {
-        if (MATRIX_RECT(mask, r, c)) {
+        if (selected(r, c)) {
           weightedPoints[i++] = WeightedPoint((real)c, (real)r,
-              MATRIX_RECT(matrix, r, c));
+              values(r, c));
+        }
+      }
+    }
+  }
+
+  DELETE_ARRAY(buckets);
+
+  winnow_select (weightedPoints, len, points, n);
+
+  DELETE_ARRAY(weightedPoints);
+}
+
+void CowichanOpenMP::winnowBits(IntMatrix matrix, const BitMatrix& mask,
+    PointVector points) {
+
+  index_t r, w;
+  index_t len; // number of points
+  index_t i;
+  MatrixView<INT_TYPE> values = rectView(matrix);
+
+  index_t num_threads = omp_get_max_threads();
+
+  index_t* buckets = NULL;
+
+  try {
+    buckets = NEW_VECTOR_SZ(index_t, num_threads);
+  }
+  catch (...) {out_of_memory();}
+
+  // count set cell in each bucket
+#pragma omp parallel private(w)
+  {
+    index_t sum = 0;
+#pragma omp for schedule(static)
+    for (r = 0; r < nr; r++) {
+      const UINT64* RESTRICT bits = mask.row(r);
+      for (w = 0; w < mask.rowWords(); w++) {
+        sum += popcount64(bits[w]);
+      }
+    }
+    buckets[omp_get_thread_num()] = sum;
+  }
+
+  // calculate offsets
+  len = 0;
+  for (i = 0; i < num_threads; i++) {
+    index_t tmp = buckets[i];
+    buckets[i] = len;
+    len += tmp;
+  }
+
+  if (len < n) {
+    not_enough_points();
+  }
+
+  WeightedPointVector weightedPoints = NULL;
+  try {
+    weightedPoints = NEW_VECTOR_SZ(WeightedPoint, len);
+  }
+  catch (...) {out_of_memory();}
+
+  // fill temporary vector, visiting only the set bits
+#pragma omp parallel private(i, w)
+  {
+    index_t thread_num = omp_get_thread_num();
+    i = buckets[thread_num];
+#pragma omp for schedule(static)
+    for (r = 0; r < nr; r++) {
+      const UINT64* RESTRICT bits = mask.row(r);
+      const INT_TYPE* RESTRICT row = values.row(r);
+      for (w = 0; w < mask.rowWords(); w++) {
+        for (UINT64 word = bits[w]; word != 0; word &= word - 1) {
+          index_t c = w * BITS_PER_WORD + lowest_bit64(word);
+          weightedPoints[i++] = WeightedPoint((real)c, (real)r, row[c]);
         }
       }
     }
   }
 
-  delete [] buckets;
+  DELETE_ARRAY(buckets);
+
+  winnow_select (weightedPoints, len, points, n);
+
+  DELETE_ARRAY(weightedPoints);
+}
+
+/*****************************************************************************/
+
+namespace cowichan_openmp
+{
+
+void winnow_select(WeightedPointVector weightedPoints, index_t len,
+    PointVector points, index_t n) {
+
+  index_t i;
+  index_t stride; // selection stride
 
 #ifdef SORT_TIME
   INT64 start, end;
@@ -119,29 +217,21 @@ void CowichanOpenMP::winnow(IntMatrix matrix, BoolMatrix mask,
   std::cout << std::endl;
 #endif
 
-  delete [] weightedPoints;
 }
 
-/*****************************************************************************/
-
-namespace cowichan_openmp
-{
-
-void mask_count(BoolMatrix mask, index_t nr, index_t nc, index_t* buckets) {
+void mask_count(const MatrixView<bool>& mask, index_t* buckets) {
 
   index_t r, c;
   index_t sum = 0;
 
-#pragma omp parallel firstprivate(sum)
+#pragma omp parallel firstprivate(sum) private(c)
   {
     index_t thread_num = omp_get_thread_num();
 #pragma omp for schedule(static)
-    for (r = 0; r < nr; r++) {
-#pragma omp parallel for schedule(static)
-      for (c = 0; c < nc; c++) {
-        if (MATRIX_RECT_NC(mask, r, c, nc)) {
-          sum++;
-        }
+    for (r = 0; r < mask.rows(); r++) {
+      const bool* RESTRICT row = mask.row(r);
+      for (c = 0; c < mask.cols(); c++) {
+        sum += row[c];
       }
     }
     buckets[thread_num] = sum;
@@ -1,2 +1,2 @@
-g++ -Wall -m32 -O2 -D WIN32 -c ../cowichan/cowichan.cpp
-g++ -Wall -m32 -O2 -D WIN32 -o cowichan_serial *.cpp cowichan.o
+g++ -Wall -m32 -O2 -D WIN32 -c ../cowichan/*.cpp
+g++ -Wall -m32 -O2 -D WIN32 -o cowichan_serial *.cpp *.o
@@ -1,4 +1,4 @@
 #!/bin/sh
 # not tested
-g++ -Wall -m32 -O2 -D LIN32 -c ../cowichan/cowichan.cpp
-g++ -Wall -m32 -O2 -D LIN32 -o cowichan_serial *.cpp cowichan.o
+g++ -Wall -m32 -O2 -D LIN32 -c ../cowichan/*.cpp
+g++ -Wall -m32 -O2 -D LIN32 -o cowichan_serial *.cpp *.o
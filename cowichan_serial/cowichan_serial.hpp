@@ -42,6 +42,12 @@ protected:
   void product(Matrix matrix, Vector candidate, Vector solution);
   real vecdiff(Vector actual, Vector computed);
 
+  void randmatHalf(IntMatrix matrix);
+  void mandelHalf(IntMatrix matrix);
+  void threshBits(IntMatrix matrix, BitMatrix& mask);
+  void lifeBits(BitMatrix& world);
+  void winnowBits(IntMatrix matrix, const BitMatrix& mask, PointVector points);
+
 };
 
 #endif
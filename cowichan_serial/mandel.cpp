@@ -6,54 +6,57 @@
 
 #include "cowichan_serial.hpp"
 
-namespace cowichan_serial
-{
-
-/**
- * Calculate mandelbrot value.
- * \param x x-coordinate.
- * \param y y-coordinate.
- * \return Mandelbrot value.
- */
-INT_TYPE mandel_calc (real x, real y);
-
-}
-
 void CowichanSerial::mandel (IntMatrix matrix)
 {
-  index_t r, c;
+  MatrixView<INT_TYPE> view = rectView(matrix);
+  index_t r;
   real dx, dy;
+  real* x = NULL;
 
   dx = mandelDx / (nc - 1);
   dy = mandelDy / (nr - 1);
 
+  try {
+    x = NEW_VECTOR_SZ(real, nc);
+  }
+  catch (...) {out_of_memory();}
+
+  mandel_columns (x, nc, mandelX0, dx, mandelCol0, false);
   for (r = 0; r < nr; r++) {
-    for (c = 0; c < nc; c++) {
-      MATRIX_RECT(matrix, r, c) = mandel_calc (mandelX0 + (c * dx),
-          mandelY0 + (r * dy));
-    }
+    mandel_row (view.row(r), x, nc,
+        mandel_coordinate (mandelY0, mandelRow0 + r, dy), mandelMaxIter,
+        mandelInfinity);
   }
+
+  DELETE_ARRAY(x);
 }
 
-namespace cowichan_serial
+void CowichanSerial::mandelHalf (IntMatrix matrix)
 {
+  MatrixView<INT_TYPE> view = rectView(matrix);
+  index_t r;
+  real dx, dy;
+  real* x = NULL;
 
-INT_TYPE mandel_calc (real x, real y)
-{
-  real r = 0.0, i = 0.0; // real and imaginary parts
-  real rs = 0.0, is = 0.0; // " ", squared
-  INT_TYPE iter = 0; // number of iterations
-
-  do {
-    i = (((real)2.0) * r * i) + x;
-    r = (rs - is) + y;
-    iter++;
-    rs = r * r;
-    is = i * i;
-  } while ((iter < MANDEL_MAX_ITER) && ((rs + is) < MANDEL_INFINITY));
-
-  return iter;
-}
+  dx = mandelDx / (nc - 1);
+  dy = mandelDy / (nr - 1);
+
+  index_t middle_r = (nr + 1) / 2;
+
+  try {
+    x = NEW_VECTOR_SZ(real, nc);
+  }
+  catch (...) {out_of_memory();}
+
+  // compute the points that half would move here
+  mandel_columns (x, nc, mandelX0, dx, mandelCol0, true);
+  for (r = 0; r < nr; r++) {
+    index_t previous_r = half_source (r, middle_r);
+    mandel_row (view.row(r), x, nc,
+        mandel_coordinate (mandelY0, mandelRow0 + previous_r, dy),
+        mandelMaxIter, mandelInfinity);
+  }
 
+  DELETE_ARRAY(x);
 }
 
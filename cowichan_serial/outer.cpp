@@ -12,6 +12,7 @@ void CowichanSerial::outer (PointVector points, Matrix matrix, Vector vector)
   real d; // distance between points
   real dMax = -1.0; // maximum distance
   index_t r, c; // loop indices
+  MatrixView<real> distances = squareView(matrix);
 
   // all elements except matrix diagonal
   for (r = 0; r < n; r++) {
@@ -21,14 +22,14 @@ void CowichanSerial::outer (PointVector points, Matrix matrix, Vector vector)
       if (d > dMax) {
         dMax = d;
       }
-      MATRIX_SQUARE(matrix, r, c) = MATRIX_SQUARE(matrix, c, r) = d;
+      distances(r, c) = distances(c, r) = d;
     }
   }
 
   // matrix diagonal
   dMax *= n;
   for (r = 0; r < n; r++) {
-    MATRIX_SQUARE(matrix, r, r) = dMax;
+    distances(r, r) = dMax;
   }
 }
 
@@ -8,13 +8,17 @@
 
 void CowichanSerial::product (Matrix matrix, Vector candidate, Vector solution)
 {
+  MatrixView<real> view = squareView(matrix);
+  const real* RESTRICT x = candidate;
   index_t r, c;
 
   for (r = 0; r < n; r++) {
-    solution[r] = MATRIX_SQUARE(matrix, r, 0) * candidate[0];
+    const real* RESTRICT row = view.row(r);
+    real sum = row[0] * x[0];
     for (c = 1; c < n; c++) {
-      solution[r] += MATRIX_SQUARE(matrix, r, c) * candidate[c];
+      sum += row[c] * x[c];
     }
+    solution[r] = sum;
   }
 }
 
@@ -8,14 +8,22 @@
 
 void CowichanSerial::randmat (IntMatrix matrix)
 {
-  index_t r, c;
-  INT_TYPE v = seed % RAND_M;
+  // the matrix holds the sequence row after row
+  randmat_fill (matrix, nr * nc, seed, 0, 1);
+}
+
+void CowichanSerial::randmatHalf (IntMatrix matrix)
+{
+  MatrixView<INT_TYPE> view = rectView(matrix);
+  index_t r;
+
+  index_t middle_r = (nr + 1) / 2;
+  index_t middle_c = (nc + 1) / 2;
 
   for (r = 0; r < nr; r++) {
-    for (c = 0; c < nc; c++) {
-      MATRIX_RECT(matrix, r, c) = v;
-      v = (RANDMAT_A * v + RANDMAT_C) % RAND_M;
-    }
+    // half moves even columns to the left half, odd ones to the right half
+    INT_TYPE* even = view.row(half_position(r, middle_r));
+    randmat_fill (even, middle_c, seed, (UINT64)r * nc, 2);
+    randmat_fill (even + middle_c, nc / 2, seed, (UINT64)r * nc + 1, 2);
   }
 }
-
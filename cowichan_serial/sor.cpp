@@ -12,31 +12,34 @@ void CowichanSerial::sor (Matrix matrix, Vector target, Vector solution)
   real sum;
   real oldSolution;
   real diff, maxDiff;
+  MatrixView<real> view = squareView(matrix);
 
   // initialize
   for (r = 0; r < n; r++) {
     solution[r] = 1.0;
   }
-  maxDiff = (real)(2 * SOR_TOLERANCE); // to forestall early exit
+  maxDiff = (real)(2 * sorTolerance); // to forestall early exit
 
-  for (t = 0; (t < SOR_MAX_ITERS) && (maxDiff >= SOR_TOLERANCE); t++) {
+  for (t = 0; (t < sorMaxIters) && (maxDiff >= sorTolerance); t++) {
 
     maxDiff = 0.0;
 
     for (r = 0; r < n; r++) {
+      const real* row = view.row(r);
+
       // compute sum
       sum = 0.0;
       for (c = 0; c < r; c++) {
-        sum += MATRIX_SQUARE(matrix, r, c) * solution[c];
+        sum += row[c] * solution[c];
       }
       for (c = r + 1; c < n; c++) {
-        sum += MATRIX_SQUARE(matrix, r, c) * solution[c];
+        sum += row[c] * solution[c];
       }
     
       // calculate new solution
       oldSolution = solution[r];
-      solution[r] = (real)((1.0 - SOR_OMEGA) * oldSolution + SOR_OMEGA *
-          (target[r] - sum) / MATRIX_SQUARE(matrix, r, r));
+      solution[r] = (real)((1.0 - sorOmega) * oldSolution + sorOmega *
+          (target[r] - sum) / row[r]);
 
       // compute difference
       diff = (real)fabs((double)(oldSolution - solution[r]));
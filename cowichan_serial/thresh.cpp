@@ -6,59 +6,86 @@
 
 #include "cowichan_serial.hpp"
 
+namespace cowichan_serial
+{
+
+/**
+ * Find the largest value that is not retained.
+ * \param values image.
+ * \param percent fraction of the cells to retain.
+ * \return Cells greater than this value are retained.
+ */
+index_t thresh_retain(const MatrixView<INT_TYPE>& values, real percent);
+
+}
+
+/*****************************************************************************/
+
 /**
  * Works only on positive input.
  */
 void CowichanSerial::thresh(IntMatrix matrix, BoolMatrix mask) {
 
-  index_t* hist = NULL; // histogram
-  index_t i;
-  index_t r, c;
-  INT_TYPE vMax; // max value in matrix
-  index_t retain; // selection
+  index_t r;
+  MatrixView<INT_TYPE> values = rectView(matrix);
+  MatrixView<bool> selected = rectView(mask);
+
+  index_t retain = thresh_retain (values, threshPercent);
+
+  // threshold
+  for (r = 0; r < nr; r++) {
+    thresh_bools (selected.row(r), values.row(r), nc, retain);
+  }
+
+}
+
+void CowichanSerial::threshBits(IntMatrix matrix, BitMatrix& mask) {
+
+  index_t r;
+  MatrixView<INT_TYPE> values = rectView(matrix);
+
+  index_t retain = thresh_retain (values, threshPercent);
 
-  // find max value in matrix
-  vMax = 0;
+  // threshold, 64 cells per word
   for (r = 0; r < nr; r++) {
-    for (c = 0; c < nc; c++) {
-      if (vMax < MATRIX_RECT(matrix, r, c)) {
-        vMax = MATRIX_RECT(matrix, r, c);
-      }
-    }
+    thresh_bits (mask.row(r), values.row(r), nc, retain);
   }
 
-  // initialize histogram
+}
+
+/*****************************************************************************/
+
+namespace cowichan_serial
+{
+
+index_t thresh_retain(const MatrixView<INT_TYPE>& values, real percent) {
+
+  index_t* hist = NULL; // histogram
+  index_t i;
+  ThreshHistogram counts;
+
+  // count, in one pass
+  counts.count (values, 0, values.rows());
+
   try {
-    hist = NEW_VECTOR_SZ(index_t, vMax + 1);
+    hist = NEW_VECTOR_SZ(index_t, counts.bins());
   }
   catch (...) {out_of_memory();}
 
-  for (i = 0; i <= (index_t)vMax; i++) {
+  for (i = 0; i < counts.bins(); i++) {
     hist[i] = 0;
   }
-
-  // count
-  for (r = 0; r < nr; r++) {
-    for (c = 0; c < nc; c++) {
-      hist[MATRIX_RECT(matrix, r, c)]++;
-    }
-  }
+  counts.add (hist, 0, counts.bins());
 
   // include
-  retain = (index_t)(threshPercent * nc * nr);
-  for (i = vMax; ((i >= 0) && (retain > 0)); i--) {
-    retain -= hist[i];
-  }
-  retain = i;
+  index_t retain = thresh_level (hist, counts.bins(),
+      (index_t)(percent * values.cols() * values.rows()));
 
-  delete [] hist;
+  DELETE_ARRAY(hist);
 
-  // threshold
-  for (r = 0; r < nr; r++) {
-    for (c = 0; c < nc; c++) {
-      MATRIX_RECT(mask, r, c) = ((index_t)MATRIX_RECT(matrix, r, c)) > retain;
-    }
-  }
+  return retain;
+
+}
 
 }
 
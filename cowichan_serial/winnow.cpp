@@ -12,11 +12,19 @@ namespace cowichan_serial
 /**
  * Count the number of set cells in the mask.
  * \param mask boolean mask.
- * \param nr number of rows.
- * \param nc number of columns.
  * \return Number of set cells in the mask.
  */
-index_t mask_count(BoolMatrix mask, index_t nr, index_t nc);
+index_t mask_count(const MatrixView<bool>& mask);
+
+/**
+ * Sort weighted points and select n of them evenly, heaviest last.
+ * \param weightedPoints weighted points (sorted in place).
+ * \param len number of weighted points.
+ * \param points selected points.
+ * \param n number of points to select.
+ */
+void winnow_select(WeightedPointVector weightedPoints, index_t len,
+    PointVector points, index_t n);
 
 }
 
@@ -25,11 +33,12 @@ void CowichanSerial::winnow(IntMatrix matrix, BoolMatrix mask,
 
   index_t r, c;
   index_t len; // number of points
-  index_t stride; // selection stride
-  index_t i, j;
+  index_t i;
+  MatrixView<INT_TYPE> values = rectView(matrix);
+  MatrixView<bool> selected = rectView(mask);
 
   // count set cell
-  len = mask_count (mask, nr, nc);
+  len = mask_count (selected);
 
   if (len < n) {
     not_enough_points();
@@ -45,13 +54,67 @@ void CowichanSerial::winnow(IntMatrix matrix, BoolMatrix mask,
   i = 0;
   for (r = 0; r < nr; r++) {
     for (c = 0; c < nc; c++) {
-      if (MATRIX_RECT(mask, r, c)) {
-        weightedPoints[i++] = WeightedPoint((real)c, (real)r,
-            MATRIX_RECT(matrix, r, c));
+      if (selected(r, c)) {
+        weightedPoints[i++] = WeightedPoint((real)c, (real)r, values(r, c));
       }
     }
   }
 
+  winnow_select (weightedPoints, len, points, n);
+
+  DELETE_ARRAY(weightedPoints);
+
+}
+
+void CowichanSerial::winnowBits(IntMatrix matrix, const BitMatrix& mask,
+    PointVector points) {
+
+  index_t r, w;
+  index_t len; // number of points
+  index_t i;
+  MatrixView<INT_TYPE> values = rectView(matrix);
+
+  // count set cell
+  len = mask.count ();
+
+  if (len < n) {
+    not_enough_points();
+  }
+
+  WeightedPointVector weightedPoints = NULL;
+  try {
+    weightedPoints = NEW_VECTOR_SZ(WeightedPoint, len);
+  }
+  catch (...) {out_of_memory();}
+
+  // fill temporary vector, visiting only the set bits
+  i = 0;
+  for (r = 0; r < nr; r++) {
+    const UINT64* RESTRICT bits = mask.row(r);
+    const INT_TYPE* RESTRICT row = values.row(r);
+    for (w = 0; w < mask.rowWords(); w++) {
+      for (UINT64 word = bits[w]; word != 0; word &= word - 1) {
+        index_t c = w * BITS_PER_WORD + lowest_bit64(word);
+        weightedPoints[i++] = WeightedPoint((real)c, (real)r, row[c]);
+      }
+    }
+  }
+
+  winnow_select (weightedPoints, len, points, n);
+
+  DELETE_ARRAY(weightedPoints);
+
+}
+
+namespace cowichan_serial
+{
+
+void winnow_select(WeightedPointVector weightedPoints, index_t len,
+    PointVector points, index_t n) {
+
+  index_t i, j;
+  index_t stride; // selection stride
+
 #ifdef SORT_TIME
   INT64 start, end;
   start = get_ticks ();
@@ -80,22 +143,16 @@ void CowichanSerial::winnow(IntMatrix matrix, BoolMatrix mask,
   std::cout << std::endl;
 #endif
 
-  delete [] weightedPoints;
-
 }
 
-namespace cowichan_serial
-{
-
-index_t mask_count(BoolMatrix mask, index_t nr, index_t nc) {
+index_t mask_count(const MatrixView<bool>& mask) {
 
   index_t r, c, sum = 0;
 
-  for (r = 0; r < nr; r++) {
-    for (c = 0; c < nc; c++) {
-      if (MATRIX_RECT_NC(mask, r, c, nc)) {
-        sum++;
-      }
+  for (r = 0; r < mask.rows(); r++) {
+    const bool* RESTRICT row = mask.row(r);
+    for (c = 0; c < mask.cols(); c++) {
+      sum += row[c];
     }
   }
 
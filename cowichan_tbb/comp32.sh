@@ -1,4 +1,4 @@
 #!/bin/sh
 # not tested
-g++ -Wall -m32 -ltbb -O2 -D LIN32 -c ../cowichan/cowichan.cpp
-g++ -Wall -m32 -ltbb -O2 -D LIN32 -o cowichan_tbb *.cpp cowichan.o
+g++ -Wall -m32 -ltbb -O2 -D LIN32 -c ../cowichan/*.cpp
+g++ -Wall -m32 -ltbb -O2 -D LIN32 -o cowichan_tbb *.cpp *.o
@@ -14,10 +14,169 @@ int main(int argc, char* argv[])
 {
   Cowichan* tbb = new CowichanTBB ();
 
-  task_scheduler_init init(2);
-
   tbb->main(argc, argv, false, true);
 
   return 0;
 }
 
+/**
+ * \brief Zeroes rows of a freshly allocated array.
+ */
+class FirstToucher {
+
+  char* array;
+  size_t rowBytes;
+
+public:
+
+  FirstToucher(void* array, size_t rowBytes): array((char*)array),
+      rowBytes(rowBytes) { }
+
+  /**
+   * Zero the given rows.
+   * \param rows range of rows to zero.
+   */
+  void operator()(const Range& rows) const {
+    memset(array + rows.begin() * rowBytes, 0,
+        (rows.end() - rows.begin()) * rowBytes);
+  }
+
+};
+
+/**
+ * \brief Runs a RowTask over ranges of rows and sums the results.
+ */
+class RowTaskRunner {
+
+  RowTask* task;
+  index_t sum;
+
+public:
+
+  RowTaskRunner(RowTask* task): task(task), sum(0) { }
+
+  RowTaskRunner(RowTaskRunner& other, split): task(other.task), sum(0) { }
+
+  /**
+   * Run the task on the given rows.
+   * \param rows range of rows.
+   */
+  void operator()(const Range& rows) {
+    sum += task->run(rows.begin(), rows.end());
+  }
+
+  /**
+   * Add the sum of another runner.
+   * \param other the other runner.
+   */
+  void join(const RowTaskRunner& other) {
+    sum += other.sum;
+  }
+
+  /**
+   * \return Sum of the task results.
+   */
+  index_t getSum() const {
+    return sum;
+  }
+
+};
+
+ThreadPinner::ThreadPinner()
+{
+  next = 1;
+}
+
+void ThreadPinner::restart()
+{
+  observe(false);
+  next = 1;
+  observe(true);
+}
+
+void ThreadPinner::on_scheduler_entry(bool is_worker)
+{
+  if (is_worker) {
+    affinity_pin(next++);
+  }
+}
+
+/**
+ * \brief Runs one chain branch as a root task.
+ */
+class BranchTask: public task {
+
+  ChainBranch* branch;
+
+public:
+
+  BranchTask(ChainBranch* branch): branch(branch) { }
+
+  task* execute() {
+    branch->run();
+    return NULL;
+  }
+
+};
+
+CowichanTBB::CowichanTBB() : scheduler(NULL), pinner(NULL)
+{
+}
+
+CowichanTBB::~CowichanTBB()
+{
+  delete pinner;
+  delete scheduler;
+}
+
+index_t CowichanTBB::setNumThreads(index_t threads)
+{
+  // only one scheduler may be active at a time
+  delete scheduler;
+  scheduler = NULL;
+
+  try {
+    scheduler = new task_scheduler_init((int)threads);
+  }
+  catch (...) {out_of_memory();}
+
+  return threads;
+}
+
+void CowichanTBB::pinThreads()
+{
+  if (pinner == NULL) {
+    try {
+      pinner = new ThreadPinner();
+    }
+    catch (...) {out_of_memory();}
+  }
+
+  affinity_pin(0);
+  pinner->restart();
+}
+
+
+void CowichanTBB::firstTouch(void* array, index_t rows, size_t rowBytes)
+{
+  // the row kernels replay this partitioning through rowPartitioner
+  parallel_for(Range(0, rows), FirstToucher(array, rowBytes),
+    rowPartitioner);
+}
+
+index_t CowichanTBB::parallelRows(index_t rows, RowTask& task)
+{
+  RowTaskRunner runner(&task);
+  parallel_reduce(Range(0, rows), runner, rowPartitioner);
+  return runner.getSum();
+}
+
+void CowichanTBB::runBranches(ChainBranch& first, ChainBranch& second,
+    index_t /* firstThreads */)
+{
+  // the kernels of both branches share the workers by work stealing
+  task_list branches;
+  branches.push_back(*new(task::allocate_root()) BranchTask(&first));
+  branches.push_back(*new(task::allocate_root()) BranchTask(&second));
+  task::spawn_root_and_wait(branches);
+}
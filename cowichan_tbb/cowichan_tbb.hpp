@@ -11,10 +11,13 @@
 // THREADING BUILDING BLOCKS ================================================// 
 
 #include "tbb/task_scheduler_init.h"
+#include "tbb/task_scheduler_observer.h"
+#include "tbb/atomic.h"
 #include "tbb/blocked_range2d.h"
 #include "tbb/parallel_for.h"
 #include "tbb/parallel_reduce.h"
 #include "tbb/parallel_sort.h"
+#include "tbb/task.h"
 using namespace tbb;
 
 /**
@@ -32,6 +35,31 @@ typedef blocked_range2d<index_t, index_t> Range2D;
  */
 namespace cowichan_tbb
 {
+
+/**
+ * \brief Pins each worker thread to the next slot as it joins the scheduler.
+ */
+class ThreadPinner: public task_scheduler_observer {
+
+  /**
+   * Slot of the next worker (the main thread has slot 0).
+   */
+  atomic<index_t> next;
+
+public:
+
+  ThreadPinner();
+
+  /**
+   * Start again from slot 1, so that every worker is pinned again when it
+   * next takes part in stealing.
+   */
+  void restart();
+
+  void on_scheduler_entry(bool is_worker);
+
+};
+
 }
 
 // using a namespace to avoid (documentation) name clashes
@@ -60,6 +88,40 @@ protected:
   void product(Matrix matrix, Vector candidate, Vector solution);
   real vecdiff(Vector actual, Vector computed);
 
+  void lifeBits(BitMatrix& world);
+
+  index_t setNumThreads(index_t threads);
+  void pinThreads();
+  void firstTouch(void* array, index_t rows, size_t rowBytes);
+  index_t parallelRows(index_t rows, RowTask& task);
+  void runBranches(ChainBranch& first, ChainBranch& second,
+      index_t firstThreads);
+
+public:
+
+  CowichanTBB();
+
+  ~CowichanTBB();
+
+private:
+
+  /**
+   * Scheduler, re-created whenever the number of threads changes.
+   */
+  task_scheduler_init* scheduler;
+
+  /**
+   * Pins worker threads, created on the first call to pinThreads.
+   */
+  ThreadPinner* pinner;
+
+  /**
+   * Remembers which thread took each range of rows in firstTouch, so that
+   * parallelRows and the row kernels (randmat, life) give the same rows to
+   * the same threads.
+   */
+  affinity_partitioner rowPartitioner;
+
 };
 
 #endif
@@ -18,18 +18,13 @@ private:
   /**
    * Matrix.
    */
-  Matrix _matrix;
+  MatrixView<real> _matrix;
 
   /**
    * Target vector.
    */
   Vector _target;
 
-  /**
-   * Matrix size.
-   */
-  index_t n;
-
   /**
    * Current row index.
    */
@@ -46,17 +41,16 @@ public:
    * Construct a row elimination object.
    * \param matrix matrix.
    * \param target target vector.
-   * \param n matrix size.
    */
-  RowElimination(Matrix matrix, Vector target, index_t n) : _matrix(matrix),
-      _target(target), n(n) { };
+  RowElimination(const MatrixView<real>& matrix, Vector target) :
+      _matrix(matrix), _target(target) { };
 
   /**
    * Set current row index.
    */
   void setI(index_t i) {
     this->i = i;
-    column_i = MATRIX(_matrix, i, i);
+    column_i = _matrix(i, i);
   }
 
   /**
@@ -66,13 +60,14 @@ public:
   void operator()(const Range& rows) const {
     
     // Get pointers locally.
-    Matrix matrix = _matrix;
+    const real* RESTRICT rowI = _matrix.row(i);
     Vector target = _target;
     
     for (index_t j = rows.begin(); j != rows.end(); ++j) {
-      real factor = -(MATRIX(matrix, j, i) / column_i);
-      for (index_t k = n - 1; k >= i; k--) {
-        MATRIX(matrix, j, k) += MATRIX(matrix, i, k) * factor;
+      real* RESTRICT rowJ = _matrix.row(j);
+      real factor = -(rowJ[i] / column_i);
+      for (index_t k = _matrix.cols() - 1; k >= i; k--) {
+        rowJ[k] += rowI[k] * factor;
       }
       target[j] += target[i] * factor;
     }
@@ -84,26 +79,31 @@ public:
 
 void CowichanTBB::gauss (Matrix matrix, Vector target, Vector solution)
 {
+  MatrixView<real> a = squareView(matrix);
   index_t i, j, k;
 
-  RowElimination rowElimination(matrix, target, n);
+  RowElimination rowElimination(a, target);
 
   // forward elimination
   for (i = 0; i < n; i++) {
     // get row with maximum column i
     index_t max = i;
     for (j = i + 1; j < n; j++) {
-      if (fabs(MATRIX(matrix, j, i)) > fabs(MATRIX(matrix, max, i))) {
+      if (fabs(a(j, i)) > fabs(a(max, i))) {
         max = j;
       }
     }
 
     real tmp;
     // swap max row with row i
-    for (j = i; j < n; j++) {
-      tmp = MATRIX(matrix, i, j);
-      MATRIX(matrix, i, j) = MATRIX(matrix, max, j);
-      MATRIX(matrix, max, j) = tmp;
+    real* RESTRICT rowI = a.row(i);
+    real* RESTRICT rowMax = a.row(max);
+    if (max != i) {
+      for (j = i; j < n; j++) {
+        tmp = rowI[j];
+        rowI[j] = rowMax[j];
+        rowMax[j] = tmp;
+      }
     }
     tmp = target[i];
     target[i] = target[max];
@@ -116,9 +116,9 @@ void CowichanTBB::gauss (Matrix matrix, Vector target, Vector solution)
 
   // back substitution
   for (k = (n - 1); k >= 0; k--) {
-    solution[k] = target[k] / MATRIX_SQUARE(matrix, k, k);
+    solution[k] = target[k] / a(k, k);
     for (i = k - 1; i >= 0; i--) {
-      target[i] = target[i] - (MATRIX_SQUARE(matrix, i, k) * solution[k]);
+      target[i] = target[i] - (a(i, k) * solution[k]);
     }
   }
 }
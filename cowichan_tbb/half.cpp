@@ -15,85 +15,32 @@ namespace cowichan_tbb
 class Shuffle {
 private:
 
-  /**
-   * Middle x.
-   */
-  index_t xBreak;
-  
-  /**
-   * Middle y;
-   */
-  index_t yBreak;
-
-  /**
-   * Number of rows in the matrix.
-   */
-  index_t nr;
-  
-  /**
-   * Number of columns in the matrix.
-   */
-  index_t nc;
-
   /**
    * Input matrix.
    */
-  IntMatrix _input;
+  MatrixView<INT_TYPE> _input;
   
   /**
    * Output matrix.
    */
-  IntMatrix _output;
+  MatrixView<INT_TYPE> _output;
 
 public:
   
   /**
    * Construct a halving shuffle object.
    */
-  Shuffle(IntMatrix input, IntMatrix output, index_t nr, index_t nc):
-      _input(input), _output(output),
-      nr(nr), nc(nc),
-      xBreak((nc + 1) / 2),
-      yBreak((nr + 1) / 2) {}
+  Shuffle(const MatrixView<INT_TYPE>& input,
+      const MatrixView<INT_TYPE>& output):
+      _input(input), _output(output) {}
 
   /**
    * Performs the halving shuffle over the given range.
-   * \param range two-dimensional range.
+   * \param pairs range of row pairs (see half_pairs).
    */
-  void operator()(const Range2D& range) const {
-    
-    IntMatrix input = _input;
-    IntMatrix output = _output;
-    const Range& rows = range.rows();
-    const Range& cols = range.cols();
+  void operator()(const Range& pairs) const {
     
-    index_t xSrc, ySrc;
-    for (index_t y = rows.begin(); y != rows.end(); ++y) {
-      for (index_t x = cols.begin(); x != cols.end(); ++x) {
-        
-        // calculate unswapped x co-ordinate.
-        if (x < xBreak) {
-          // odd columns
-          xSrc = x * 2;
-        } else {
-          // even columns
-          xSrc = (x - xBreak) * 2 + 1;
-        }
-        
-        // calculate unswapped y co-ordinate.
-        if (y < yBreak) {
-          // odd rows
-          ySrc = y * 2;
-        } else {
-          // even columns
-          ySrc = (y - yBreak) * 2 + 1;
-        }
-              
-        // assign new values in the output matrix.
-        MATRIX_RECT(output, y, x) = MATRIX_RECT(input, ySrc, xSrc);
-        
-      }
-    }
+    half_pairs(_input, _output, pairs.begin(), pairs.end());
     
   }
 };
@@ -105,9 +52,8 @@ public:
 void CowichanTBB::half(IntMatrix matrixIn, IntMatrix matrixOut) {
 
   // perform the halving shuffle.
-  Shuffle shuffle(matrixIn, matrixOut, nr, nc);
-  parallel_for(Range2D(0, nr, 0, nc), shuffle,
+  Shuffle shuffle(rectView(matrixIn), rectView(matrixOut));
+  parallel_for(Range(0, (nr + 1) / 2), shuffle,
       auto_partitioner());
     
 }
-
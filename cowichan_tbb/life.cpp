@@ -13,6 +13,7 @@ namespace cowichan_tbb
  * \brief Ping-pong solution to game of life.
  *
  * This class does the game of life, and facilitates a ping-pong memory model.
+ * Both generations are bit-packed; see life_row.
  */
 class GameOfLife {
 
@@ -21,60 +22,18 @@ private:
   /**
    * First matrix (read from).
    */
-  BoolMatrix _first;
+  BitMatrix* _first;
   
   /**
    * Second matrix (write to).
    */
-  BoolMatrix _second;
-
-  /**
-   * Number of rows in matrices.
-   */
-  index_t nr;
-  
-  /**
-   * Number of column in matrices.
-   */
-  index_t nc;
+  BitMatrix* _second;
 
   /**
    * Number of alive cells.
    */
   index_t aliveCount;
 
-private:
-
-  /**
-   * Calculate number of peers.
-   * \param x x-coordinate.
-   * \param y y-coordinate.
-   * \return Number of peers.
-   */
-  index_t sumNeighbours(index_t x, index_t y) const {
-
-    index_t peers = 0;
-
-    // calculate possible neighbour positions
-    bool l = (x > 0);
-    bool r = (x < (nc - 1));
-    bool u = (y > 0);
-    bool d = (y < (nr - 1));    
-
-    // calculate no. of neighbours
-    if (l &&       MATRIX_RECT(_first, y    , x - 1)) ++peers;
-    if (l && u &&  MATRIX_RECT(_first, y - 1, x - 1)) ++peers;
-    if (u &&       MATRIX_RECT(_first, y - 1, x    )) ++peers;
-    if (r && u &&  MATRIX_RECT(_first, y - 1, x + 1)) ++peers;
-    if (r &&       MATRIX_RECT(_first, y    , x + 1)) ++peers;
-    if (r && d &&  MATRIX_RECT(_first, y + 1, x + 1)) ++peers;
-    if (d &&       MATRIX_RECT(_first, y + 1, x    )) ++peers;
-    if (l && d &&  MATRIX_RECT(_first, y + 1, x - 1)) ++peers;
-    
-    return peers;
-    
-  }
-
 public:
 
   /**
@@ -90,51 +49,28 @@ public:
    * Construct a game of life object.
    * \param first matrix to read from initially.
    * \param second matrix to write to initially.
-   * \param nr number of rows in matrices.
-   * \param nc number of columns in matrices.
    */
-  GameOfLife(BoolMatrix first, BoolMatrix second, index_t nr, index_t nc):
-    _first(first), _second(second), nr(nr), nc(nc), aliveCount(0) { }
+  GameOfLife(BitMatrix* first, BitMatrix* second):
+    _first(first), _second(second), aliveCount(0) { }
 
   /**
-   * Swap the matrices.
+   * Swap the matrices and reset the alive count.
    */
   void swap() {
-    BoolMatrix temp = _first;
+    BitMatrix* temp = _first;
     _first = _second;
     _second = temp;
+    aliveCount = 0;
   }
 
   /**
-   * Performs the game of life operation over the given range.
-   * \param range row/column range.
+   * Performs the game of life operation over the given rows.
+   * \param rows row range.
    */
-  void operator()(const Range2D& range) {
-    
-    BoolMatrix first = _first;
-    BoolMatrix second = _second;
-    
-    const Range& rows = range.rows();
-    const Range& cols = range.cols();
-    
+  void operator()(const Range& rows) {
     for (index_t y = rows.begin(); y != rows.end(); ++y) {
-      for (index_t x = cols.begin(); x != cols.end(); ++x) {
-        
-        index_t peers = sumNeighbours(x, y);
-        if (peers < 2 || peers > 3) {
-          MATRIX_RECT(second, y, x) = false; // hunger/overcrowding
-        } else if (peers == 3) {
-          MATRIX_RECT(second, y, x) = true; // breeding
-        } else {
-          MATRIX_RECT(second, y, x) = MATRIX_RECT(first, y, x); // nothing
-        }
-        
-        if (MATRIX_RECT(second, y, x)) {
-          aliveCount++;
-        }
-      }
+      aliveCount += life_row(*_first, *_second, y);
     }
-    
   }
 
   /**
@@ -142,7 +78,7 @@ public:
    * \param other object to split.
    */
   GameOfLife(GameOfLife& other, split) : _first(other._first),
-      _second(other._second), nr(other.nr), nc(other.nc), aliveCount(0) { }
+      _second(other._second), aliveCount(0) { }
 
   /**
    * Joiner (TBB).
@@ -154,17 +90,75 @@ public:
 
 };
 
+/**
+ * \brief Converts rows between a BoolMatrix and a BitMatrix.
+ */
+class LifePacker {
+
+  BitMatrix* bits;
+  BoolMatrix cells;
+  bool packing;
+
+public:
+
+  /**
+   * Construct a packer.
+   * \param bits packed matrix.
+   * \param cells unpacked matrix.
+   * \param packing true to pack cells into bits, false to unpack.
+   */
+  LifePacker(BitMatrix* bits, BoolMatrix cells, bool packing): bits(bits),
+      cells(cells), packing(packing) { }
+
+  /**
+   * Convert the given rows.
+   * \param rows row range.
+   */
+  void operator()(const Range& rows) const {
+    if (packing) {
+      bits->pack(cells, rows.begin(), rows.end());
+    } else {
+      bits->unpack(cells, rows.begin(), rows.end());
+    }
+  }
+
+};
+
 }
 
 /*****************************************************************************/
 
 void CowichanTBB::life(BoolMatrix input, BoolMatrix output) {
-  GameOfLife game(input, output, nr, nc);
+  BitMatrix* world = NULL;
+  try {
+    world = new BitMatrix(nr, nc);
+  }
+  catch (...) {out_of_memory();}
+
+  parallel_for(Range(0, nr), LifePacker(world, input, true),
+      rowPartitioner);
 
-  for (index_t i = 0; i < LIFE_ITERATIONS; ++i) {
+  lifeBits(*world);
+
+  parallel_for(Range(0, nr), LifePacker(world, output, false),
+      rowPartitioner);
+
+  delete world;
+}
+
+void CowichanTBB::lifeBits(BitMatrix& world) {
+  BitMatrix* next = NULL;
+  try {
+    next = new BitMatrix(nr, nc);
+  }
+  catch (...) {out_of_memory();}
+
+  GameOfLife game(&world, next);
+
+  for (index_t i = 0; i < lifeIterations; ++i) {
 
     // update CA simulation
-    parallel_reduce(Range2D(0, nr, 0, nc), game, auto_partitioner());
+    parallel_reduce(Range(0, nr), game, rowPartitioner);
 
     // check if there are alive cells
     if (!game.isAlive()) {
@@ -176,13 +170,11 @@ void CowichanTBB::life(BoolMatrix input, BoolMatrix output) {
 
   }
 
-  // final result is in input - copy to output
-  if (LIFE_ITERATIONS % 2 == 0) {
-    for (index_t r = 0; r < nr; r++) {
-      for (index_t c = 0; c < nc; c++) {
-        MATRIX_RECT(output, r, c) = MATRIX_RECT(input, r, c);
-      }
-    }
+  // final result is in world after an even number of swaps, next otherwise
+  if (lifeIterations % 2 != 0) {
+    world.swap(*next);
   }
+
+  delete next;
 }
 
@@ -18,89 +18,56 @@ private:
   /**
    * Matrix.
    */
-  IntMatrix _matrix;    // to store the result.
+  MatrixView<INT_TYPE> _matrix;    // to store the result.
 
   /**
-   * Number of rows in the matrix.
+   * x-coordinate of each column.
    */
-  index_t nr;
-  
-  /**
-   * Number of columns in the matrix.
-   */
-  index_t nc;
-
-  /**
-   * x-coordinate of the lower left corner.
-   */
-  real baseX;
+  const real* x;
   
   /**
    * y-coordinate of the lower left corner.
    */
   real baseY;
 
-  /**
-   * Extent of the region along the x axis.
-   */
-  real dX;
-  
   /**
    * Extent of the region along the y axis.
    */
   real dY;
 
-private:
+  /**
+   * Lattice row of the first row.
+   */
+  index_t row0;
 
   /**
-   * Performs the mandelbrot value calculation.
-   * \param x x-coordinate.
-   * \param y y-coordinate.
+   * Maximum number of iterations.
    */
-  INT_TYPE mandelCalc(real x, real y) const {
+  index_t maxIter;
+
+  /**
+   * Squared magnitude considered divergent.
+   */
+  real infinity;
 
-    real r = 0.0, i = 0.0;
-    real rs = 0.0, is = 0.0;
-    INT_TYPE numIterations = 0;    
-    do {
-    
-      // calculate the complex value according to the mandelbrot set specs.
-      i = (((real)2.0) * r * i) + x;
-      r = (rs - is) + y;
-      
-      // calculate squared complex value
-      rs = r * r;
-      is = i * i;
-      
-      // "step" the simulation for this co-ordinate.
-      ++numIterations;      
-      
-    } while ((numIterations < MANDEL_MAX_ITER) && ((rs + is) < MANDEL_INFINITY));
-    
-    // we are interested if the series converges or diverges. Return the
-    // number of iterations before such an event (divergence).
-    return numIterations;
-    
-  }
-  
 public:
 
   /**
    * Construct a mandelbrot generation object.
    * \param matrix matrix to fill.
-   * \param nr number of rows.
-   * \param nc number of columns.
-   * \param x base x.
+   * \param x x-coordinate of each column (see mandel_columns).
    * \param y base y.
-   * \param width width.
    * \param height height.
+   * \param row0 lattice row of the first row.
+   * \param maxIter maximum number of iterations.
+   * \param infinity squared magnitude considered divergent.
    */
-  Mandelbrot(IntMatrix matrix, index_t nr, index_t nc, real x, real y,
-      real width, real height) : _matrix(matrix), nr(nr), nc(nc), baseX(x),
-      baseY(y) {
+  Mandelbrot(const MatrixView<INT_TYPE>& matrix, const real* x, real y,
+      real height, index_t row0, index_t maxIter, real infinity) :
+      _matrix(matrix), x(x), baseY(y), row0(row0), maxIter(maxIter),
+      infinity(infinity) {
     
-    dX = width / (nc - 1);
-    dY = height / (nr - 1);
+    dY = height / (matrix.rows() - 1);
       
   }
 
@@ -110,15 +77,13 @@ public:
    */
   void operator()(const Range2D& range) const {
 
-    IntMatrix matrix = _matrix;
-
     const Range& rows = range.rows();
     const Range& cols = range.cols();
     
     for (index_t y = rows.begin(); y != rows.end(); ++y) {
-      for (index_t x = cols.begin(); x != cols.end(); ++x) {
-        MATRIX_RECT(matrix, y, x) = mandelCalc(baseX + (x * dX), baseY + (y * dY));
-      }
+      mandel_row(_matrix.row(y) + cols.begin(), x + cols.begin(),
+          cols.end() - cols.begin(), mandel_coordinate(baseY, row0 + y, dY),
+          maxIter, infinity);
     }
     
   }
@@ -131,9 +96,21 @@ public:
 
 void CowichanTBB::mandel(IntMatrix matrix)
 {
-  Mandelbrot mandel(matrix, nr, nc, mandelX0, mandelY0, mandelDx, mandelDy);
+  real* x = NULL;
+
+  try {
+    x = NEW_VECTOR_SZ(real, nc);
+  }
+  catch (...) {out_of_memory();}
+
+  mandel_columns(x, nc, mandelX0, mandelDx / (nc - 1), mandelCol0, false);
+
+  Mandelbrot mandel(rectView(matrix), x, mandelY0, mandelDy, mandelRow0,
+      mandelMaxIter, mandelInfinity);
 
   parallel_for(Range2D(0, nr, 0, nc), mandel,
     auto_partitioner());
+
+  DELETE_ARRAY(x);
 }
 
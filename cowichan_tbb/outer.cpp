@@ -22,18 +22,13 @@ class PointDistances {
   /**
    * Matrix to fill.
    */
-  Matrix _matrix;
+  MatrixView<real> _matrix;
 
   /**
    * Vector to fill.
    */
   Vector _vector;
 
-  /**
-   * Matrix size.
-   */
-  index_t n;
-
   /**
    * Maximum distance.
    */
@@ -46,10 +41,10 @@ public:
    * \param points given points.
    * \param matrix matrix to fill.
    * \param vector vector to fill.
-   * \param n matrix size.
    */
-  PointDistances(PointVector points, Matrix matrix, Vector vector, index_t n)
-      : _points(points), _matrix(matrix), _vector(vector), n(n), _max(-1) { }
+  PointDistances(PointVector points, const MatrixView<real>& matrix,
+      Vector vector)
+      : _points(points), _matrix(matrix), _vector(vector), _max(-1) { }
 
   /**
    * Get maximum of the distances.
@@ -66,7 +61,7 @@ public:
   void operator()(const Range& rows) {
     
     PointVector points = _points;
-    Matrix matrix = _matrix;
+    MatrixView<real> matrix = _matrix;
     Vector vector = _vector;
     
     for (index_t y = rows.begin(); y != rows.end(); ++y) {
@@ -80,7 +75,7 @@ public:
         if (d > _max) {
           _max = d;
         }
-        MATRIX(matrix, y, x) = MATRIX(matrix, x, y) = d;
+        matrix(y, x) = matrix(x, y) = d;
       }
     }
   }
@@ -90,7 +85,7 @@ public:
    * \param other object to split.
    */
   PointDistances(PointDistances& other, split) : _points(other._points),
-      _matrix(other._matrix), _vector(other._vector), n(other.n), _max(-1) { }
+      _matrix(other._matrix), _vector(other._vector), _max(-1) { }
 
   /**
    * Joiner (TBB).
@@ -115,12 +110,7 @@ class MakeDominant {
   /**
    * Matrix to modify.
    */
-  Matrix _matrix;
-
-  /**
-   * Matrix size.
-   */
-  index_t n;
+  MatrixView<real> _matrix;
 
   /**
    * Value to use for diagonal.
@@ -132,21 +122,18 @@ public:
   /**
    * Construct a make dominant object.
    * \param matrix matrix to modify.
-   * \param n matrix size.
    * \param value value for diagonal.
    */
-  MakeDominant(Matrix matrix, index_t n, real value):
-    _matrix(matrix), n(n), value(value) { }
+  MakeDominant(const MatrixView<real>& matrix, real value):
+    _matrix(matrix), value(value) { }
   
   /**
    * Sets diagonal elements to a given constant.
    * \param rows range of rows to work on.
    */  
   void operator()(const Range& rows) const {
-    Matrix matrix = _matrix;
-    
     for (index_t i = rows.begin(); i != rows.end(); ++i) {
-      DIAG(matrix, i) = value;
+      _matrix(i, i) = value;
     }
   }
   
@@ -159,11 +146,11 @@ public:
 void CowichanTBB::outer(PointVector points, Matrix matrix, Vector vector) {
   
   // figure out the matrix and vector
-  PointDistances dist(points, matrix, vector, n);
+  PointDistances dist(points, squareView(matrix), vector);
   parallel_reduce(Range(0, n), dist, auto_partitioner());
 
   // fix up the diagonal
-  MakeDominant dom(matrix, n, dist.getMaximum() * n);
+  MakeDominant dom(squareView(matrix), dist.getMaximum() * n);
   parallel_for(Range(0, n), dom, auto_partitioner());
   
 }
@@ -22,7 +22,7 @@ class Product {
   /**
    * Given matrix.
    */
-  Matrix _matrix;
+  MatrixView<real> _matrix;
 
   /**
    * Given vector.
@@ -34,11 +34,6 @@ class Product {
    */
   Vector _result;
 
-  /**
-   * Matrix size.
-   */
-  index_t n;
-
 public:
 
   /**
@@ -46,10 +41,9 @@ public:
    * \param matrix given matrix.
    * \param vector given vector.
    * \param result solution vector.
-   * \param n matrix size.
    */
-  Product(Matrix matrix, Vector vector, Vector result, index_t n):
-    _matrix(matrix), _vector(vector), _result(result), n(n) { }
+  Product(const MatrixView<real>& matrix, Vector vector, Vector result):
+    _matrix(matrix), _vector(vector), _result(result) { }
 
   /**
    * Performs matrix-vector multiplication on the given row range.
@@ -57,16 +51,18 @@ public:
    */
   void operator()(const Range& rows) const {
     
-    Matrix matrix = _matrix;
-    Vector vector = _vector;
+    const real* RESTRICT vector = _vector;
     Vector result = _result;
+    index_t n = _matrix.cols();
     
     for (index_t row = rows.begin(); row != rows.end(); ++row) {
       
-      VECTOR(result, row) = 0.0;
+      const real* RESTRICT matrix = _matrix.row(row);
+      real sum = 0.0;
       for (index_t col = 0; col < n; ++col) {
-        VECTOR(result, row) += MATRIX(matrix, row,col) * VECTOR(vector, col);
+        sum += matrix[col] * vector[col];
       }
+      VECTOR(result, row) = sum;
       
     }
     
@@ -79,7 +75,7 @@ public:
 
 void CowichanTBB::product(Matrix matrix, Vector candidate, Vector solution)
 {
-  Product product(matrix, candidate, solution, n);
+  Product product(squareView(matrix), candidate, solution);
   parallel_for(Range(0, n), product, auto_partitioner());
 }
 
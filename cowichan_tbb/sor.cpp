@@ -18,7 +18,7 @@ private:
   /**
    * Matrix to use.
    */
-  Matrix _matrix;
+  MatrixView<real> _matrix;
 
   /**
    * Given target vector.
@@ -31,9 +31,9 @@ private:
   Vector _solution;
 
   /**
-   * Matrix size.
+   * Relaxation factor.
    */
-  index_t n;
+  double omega;
 
   /**
    * Maximum difference found.
@@ -47,10 +47,11 @@ public:
    * \param matrix matrix to use.
    * \param target target vector.
    * \param solution solution vector.
-   * \param n matrix size.
+   * \param omega relaxation factor.
    */
-  Relaxer(Matrix matrix, Vector target, Vector solution, index_t n)
-      : _matrix(matrix), _target(target), _solution(solution), n(n) { }
+  Relaxer(const MatrixView<real>& matrix, Vector target, Vector solution,
+      double omega) : _matrix(matrix), _target(target), _solution(solution),
+      omega(omega) { }
 
   /**
    * Get maximum difference.
@@ -67,9 +68,9 @@ public:
   void operator()(const Range& range) {
 
     // get pointers locally.
-    Matrix matrix = _matrix;
     Vector target = _target;
     Vector solution = _solution;
+    index_t n = _matrix.cols();
 
     index_t c;
     real diff;
@@ -79,19 +80,21 @@ public:
     maxDiff = 0.0;
 
     for (index_t r = range.begin(); r != range.end(); r++) {
+      const real* row = _matrix.row(r);
+
       // compute sum
       sum = 0.0;
       for (c = 0; c < r; c++) {
-        sum += MATRIX_SQUARE(matrix, r, c) * solution[c];
+        sum += row[c] * solution[c];
       }
       for (c = r + 1; c < n; c++) {
-        sum += MATRIX_SQUARE(matrix, r, c) * solution[c];
+        sum += row[c] * solution[c];
       }
     
       // calculate new solution
       oldSolution = solution[r];
-      solution[r] = (real)((1.0 - SOR_OMEGA) * oldSolution + SOR_OMEGA *
-          (target[r] - sum) / MATRIX_SQUARE(matrix, r, r));
+      solution[r] = (real)((1.0 - omega) * oldSolution + omega *
+          (target[r] - sum) / row[r]);
 
       // compute difference
       diff = (real)fabs((double)(oldSolution - solution[r]));
@@ -107,7 +110,8 @@ public:
    * \param other object to split.
    */
   Relaxer(Relaxer& other, split) : _matrix(other._matrix),
-      _target(other._target), _solution(other._solution), n(other.n) { }
+      _target(other._target), _solution(other._solution),
+      omega(other.omega) { }
 
   /**
    * Joiner (TBB).
@@ -134,11 +138,11 @@ void CowichanTBB::sor(Matrix matrix, Vector target, Vector solution)
   for (r = 0; r < n; r++) {
     solution[r] = 1.0;
   }
-  maxDiff = (real)(2 * SOR_TOLERANCE); // to forestall early exit
+  maxDiff = (real)(2 * sorTolerance); // to forestall early exit
 
-  Relaxer relaxer(matrix, target, solution, n);
+  Relaxer relaxer(squareView(matrix), target, solution, sorOmega);
 
-  for (t = 0; (t < SOR_MAX_ITERS) && (maxDiff >= SOR_TOLERANCE); t++) {
+  for (t = 0; (t < sorMaxIters) && (maxDiff >= sorTolerance); t++) {
     parallel_reduce(Range(0, n), relaxer, auto_partitioner()); 
     maxDiff = relaxer.getMaxDiff();
   }
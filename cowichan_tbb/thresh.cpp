@@ -18,27 +18,21 @@ private:
   /**
    * Image matrix.
    */
-  IntMatrix _image;
+  MatrixView<INT_TYPE> _image;
 
   /**
    * Maximum value.
    */
   INT_TYPE _max;
 
-  /**
-   * Number of columns in the matrix.
-   */
-  const index_t nc;
-
 public:
 
   /**
    * Constructs a max reducer. Initialise max with the lowest possible value.
    * \param image image matrix.
-   * \param nc number of matrix columns.
    */
-  MaxReducer(IntMatrix image, index_t nc):
-    _image(image), _max(MINIMUM_INT), nc(nc) { }
+  MaxReducer(const MatrixView<INT_TYPE>& image):
+    _image(image), _max(MINIMUM_INT) { }
 
   /**
    * Get maximum value.
@@ -54,18 +48,20 @@ public:
    */
   void operator()(const Range2D& range) {
 
-    IntMatrix image = _image;
-
     const Range& rows = range.rows();
     const Range& cols = range.cols();
+    INT_TYPE max = _max;
     
     for (index_t y = rows.begin(); y != rows.end(); ++y) {
+      const INT_TYPE* RESTRICT image = _image.row(y);
       for (index_t x = cols.begin(); x != cols.end(); ++x) {
-        if (_max < MATRIX_RECT(image, y, x)) {
-          _max = MATRIX_RECT(image, y, x);
+        if (max < image[x]) {
+          max = image[x];
         }
       }
     }
+
+    _max = max;
     
   }
   
@@ -74,7 +70,7 @@ public:
    * \param other object to split.
    */
   MaxReducer(MaxReducer& other, split) : _image(other._image),
-      _max(MINIMUM_INT), nc(other.nc) { }
+      _max(MINIMUM_INT) { }
 
   /**
    * Joiner (TBB).
@@ -96,7 +92,7 @@ class Histogram {
   /**
    * Image matrix.
    */
-  IntMatrix _image;
+  MatrixView<INT_TYPE> _image;
   
   /**
    * Histogram values.
@@ -107,16 +103,6 @@ class Histogram {
    * Number of bins in the histogram.
    */
   const index_t bins;
-  
-  /**
-   * Number of rows in the matrix.
-   */
-  const index_t nr;
-  
-  /**
-   * Number of columns in the matrix.
-   */
-  const index_t nc;
 
 public:
 
@@ -124,11 +110,9 @@ public:
    * Construct a histogram object.
    * \param image image matrix.
    * \param maxValue number of bins to use.
-   * \param nr number of rows in the matrix.
-   * \param nc number of columns in the matrix.
    */
-  Histogram(IntMatrix image, INT_TYPE maxValue, index_t nr, index_t nc)
-      : _image(image), bins(maxValue), nr(nr), nc(nc)
+  Histogram(const MatrixView<INT_TYPE>& image, INT_TYPE maxValue)
+      : _image(image), bins(maxValue)
   {
     histogram = new index_t[maxValue + 1];
 
@@ -144,7 +128,7 @@ public:
    */
   index_t getValue(real cutoff) const {
     index_t i;
-    index_t retain = (index_t)(cutoff * nc * nr);
+    index_t retain = (index_t)(cutoff * _image.cols() * _image.rows());
 
     for (i = bins; (i >= 0) && (retain > 0); --i) {
       retain -= histogram[i];
@@ -158,15 +142,15 @@ public:
    * \param range row/column range to work on.
    */
   void operator()(const Range2D& range) const {
-    IntMatrix image = _image;
-    index_t* hist = histogram;
+    index_t* RESTRICT hist = histogram;
     
     const Range& rows = range.rows();
     const Range& cols = range.cols();
     
     for (index_t y = rows.begin(); y != rows.end(); ++y) {
+      const INT_TYPE* RESTRICT image = _image.row(y);
       for (index_t x = cols.begin(); x != cols.end(); ++x) {
-        hist[MATRIX_RECT(image, y, x)]++;
+        hist[image[x]]++;
       }
     }
   }
@@ -175,8 +159,7 @@ public:
    * Splitting (TBB) constructor.
    * \param other object to split.
    */
-  Histogram(Histogram& other, split): _image(other._image), bins(other.bins),
-      nr(other.nr), nc(other.nc)
+  Histogram(Histogram& other, split): _image(other._image), bins(other.bins)
   {
     histogram = new index_t[bins + 1];
 
@@ -206,23 +189,18 @@ class Threshold {
   /**
    * Image matrix.
    */
-  IntMatrix _image;
+  MatrixView<INT_TYPE> _image;
   
   /**
    * Resulting boolean matrix.
    */
-  BoolMatrix _result;
+  MatrixView<bool> _result;
 
   /**
    * Retention value.
    */
   const index_t retain;
 
-  /**
-   * Number of columns in the matrix.
-   */
-  const index_t nc;
-
 public:
 
   /**
@@ -230,16 +208,14 @@ public:
    * \param range row/column range to operate on.
    */
   void operator()(const Range2D& range) const {
-    IntMatrix image = _image;
-    BoolMatrix result = _result;
-    
     const Range& rows = range.rows();
     const Range& cols = range.cols();
     
     for (index_t y = rows.begin(); y != rows.end(); ++y) {
+      const INT_TYPE* RESTRICT image = _image.row(y);
+      bool* RESTRICT result = _result.row(y);
       for (index_t x = cols.begin(); x != cols.end(); ++x) {
-        MATRIX_RECT(result, y, x) =
-            ((index_t)MATRIX_RECT(image, y, x)) > retain;
+        result[x] = ((index_t)image[x]) > retain;
       }
     }
   }
@@ -249,10 +225,10 @@ public:
    * \param image image matrix.
    * \param retain retention value.
    * \param result result matrix to fill.
-   * \param nc number of columns in the matrix.
    */
-  Threshold(IntMatrix image, index_t retain, BoolMatrix result, index_t nc):
-    _image(image), _result(result), retain(retain), nc(nc) { }
+  Threshold(const MatrixView<INT_TYPE>& image, index_t retain,
+      const MatrixView<bool>& result):
+    _image(image), _result(result), retain(retain) { }
 
 };
 
@@ -266,16 +242,17 @@ public:
 void CowichanTBB::thresh(IntMatrix matrix, BoolMatrix mask) {
   
   // get the maximum value in the matrix (need 0-that number of bins)
-  MaxReducer reducer(matrix, nc);
+  MaxReducer reducer(rectView(matrix));
   parallel_reduce(Range2D(0, nr, 0, nc), reducer, auto_partitioner());
   INT_TYPE max = reducer.getMaximum();
   
   // compute the histogram to get a thresholding value
-  Histogram hist(matrix, max, nr, nc);
+  Histogram hist(rectView(matrix), max);
   parallel_reduce(Range2D(0, nr, 0, nc), hist, auto_partitioner());
   
   // perform the thresholding opearation
-  Threshold thresh(matrix, hist.getValue(THRESH_PERCENT), mask, nc);
+  Threshold thresh(rectView(matrix), hist.getValue(threshPercent),
+      rectView(mask));
   parallel_for(Range2D(0, nr, 0, nc), thresh, auto_partitioner());
 
 }
@@ -18,17 +18,12 @@ private:
   /**
    * Candidate points matrix.
    */
-  IntMatrix _candidates;
+  MatrixView<INT_TYPE> _candidates;
 
   /**
    * Mask.
    */
-  BoolMatrix _mask;
-
-  /**
-   * Number of columns in the matrix.
-   */
-  index_t nc;
+  MatrixView<bool> _mask;
 
   /**
    * Number of points to sort.
@@ -49,10 +44,10 @@ public:
    * Construct a point count object.
    * \param candidates candidate points matrix.
    * \param mask mask.
-   * \param nc number of columns in the matrix.
    */
-  PointCount(IntMatrix candidates, BoolMatrix mask, index_t nc):
-    _candidates(candidates), _mask(mask), nc(nc), count(0) { }
+  PointCount(const MatrixView<INT_TYPE>& candidates,
+      const MatrixView<bool>& mask):
+    _candidates(candidates), _mask(mask), count(0) { }
 
   /**
    * Calculate number of points to sort (TBB).
@@ -60,22 +55,19 @@ public:
    */
   void operator()(const Range2D& range) {
     
-    // bring pointers into cache
-    const BoolMatrix mask = _mask;
-    const IntMatrix candidates = _candidates;
     const Range& rows = range.rows();
     const Range& cols = range.cols();
+    index_t sum = 0;
 
     // count values marked as good by the mask.
     for (index_t y = rows.begin(); y != rows.end(); ++y) {
+      const bool* RESTRICT mask = _mask.row(y);
       for (index_t x = cols.begin(); x != cols.end(); ++x) {
-        
-        if (MATRIX_RECT(mask, y, x)) {
-          count++;
-        }
-        
+        sum += mask[x];
       }
     }
+
+    count += sum;
     
   }
   
@@ -84,7 +76,7 @@ public:
    * \param other object to split.
    */
   PointCount(PointCount& other, split) : _candidates(other._candidates),
-      _mask(other._mask), nc(other.nc), count(0) { }
+      _mask(other._mask), count(0) { }
 
   /**
    * Joiner (TBB).
@@ -104,7 +96,9 @@ void CowichanTBB::winnow(IntMatrix matrix, BoolMatrix mask,
     PointVector points) {
 
   // count points to sort
-  PointCount pc(matrix, mask, nc);
+  MatrixView<INT_TYPE> values = rectView(matrix);
+  MatrixView<bool> selected = rectView(mask);
+  PointCount pc(values, selected);
   parallel_reduce(Range2D(0, nr, 0, nc), pc, auto_partitioner());
 
   index_t len = pc.getCount();
@@ -120,9 +114,8 @@ void CowichanTBB::winnow(IntMatrix matrix, BoolMatrix mask,
   // fill in weighted points
   for (index_t y = 0; y != nr; ++y) {
     for (index_t x = 0; x != nc; ++x) {
-      if (MATRIX_RECT(mask, y, x)) {
-        weightedPoints[i++] = WeightedPoint((real)x, (real)y,
-            MATRIX_RECT(matrix, y, x));
+      if (selected(y, x)) {
+        weightedPoints[i++] = WeightedPoint((real)x, (real)y, values(y, x));
       }
     }
   }
@@ -0,0 +1,73 @@
+#!/bin/sh
+#
+# Runs the chain with and without --chain-dag in each memory mode and checks
+# that the checkpoints of both are identical.
+#
+# usage: chain_dag.sh [-s SIZE] [-c SOURCE] [-o DIR] [-x OPTIONS] [MODE...]
+#
+#   -s SIZE      matrix size (default 500)
+#   -c SOURCE    chain source, randmat or mandel (default randmat)
+#   -o DIR       checkpoint directories go to DIR/MODE (default dag)
+#   -x OPTIONS   more options, for example "--chain-fusion on"
+#   MODE         memory mode to check (default: fresh arena)
+#
+# The binary is $SERIAL (default ../cowichan_serial/cowichan_serial). The
+# OpenMP sor reads values other threads are updating, so its results vary
+# from run to run unless it runs with --threads 1.
+
+SERIAL=${SERIAL:-../cowichan_serial/cowichan_serial}
+SIZE=500
+SOURCE=randmat
+OUT=dag
+EXTRA=""
+
+while getopts "s:c:o:x:" OPTION; do
+    case $OPTION in
+	s) SIZE=$OPTARG ;;
+	c) SOURCE=$OPTARG ;;
+	o) OUT=$OPTARG ;;
+	x) EXTRA=$OPTARG ;;
+	*) sed -n '6,15p' $0; exit 1 ;;
+    esac
+done
+shift `expr $OPTIND - 1`
+
+MODES="$*"
+if [ "$MODES" = "" ]; then
+    MODES="fresh arena"
+fi
+
+FAILED=0
+for MODE in $MODES; do
+    for DAG in off on; do
+	rm -rf $OUT/$MODE/$DAG
+	mkdir -p $OUT/$MODE/$DAG
+	if ! $SERIAL chain --size $SIZE --chain-source $SOURCE \
+	    --chain-mask thresh --chain-memory $MODE --chain-dag $DAG \
+	    --checkpoint $OUT/$MODE/$DAG $EXTRA > /dev/null
+	then
+	    echo " * The chain failed ($MODE, --chain-dag $DAG)"
+	    FAILED=1
+	fi
+    done
+
+    # both runs write the same steps in the same order
+    COUNT=`ls $OUT/$MODE/on | wc -l`
+    ls $OUT/$MODE/off > $OUT/off.txt
+    ls $OUT/$MODE/on | paste -d ' ' $OUT/off.txt - | while read OFF ON
+    do
+	if [ "$OFF" != "$ON" ] \
+	    || ! cmp -s $OUT/$MODE/off/$OFF $OUT/$MODE/on/$ON; then
+	    echo " * $MODE: --chain-dag on differs: $ON ($OFF)"
+	fi
+    done > $OUT/diff.txt
+    if [ -s $OUT/diff.txt ] || [ $COUNT -eq 0 ]; then
+	cat $OUT/diff.txt
+	FAILED=1
+    else
+	echo "$MODE: $COUNT checkpoints identical with --chain-dag on"
+    fi
+    rm -f $OUT/off.txt $OUT/diff.txt
+done
+
+exit $FAILED
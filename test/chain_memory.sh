@@ -0,0 +1,74 @@
+#!/bin/sh
+#
+# Runs the chain with each memory mode (--chain-memory) and checks that the
+# checkpoints of every mode are identical to those of fresh.
+#
+# usage: chain_memory.sh [-s SIZE] [-c SOURCE] [-o DIR] [-x OPTIONS] [MODE...]
+#
+#   -s SIZE      matrix size (default 500)
+#   -c SOURCE    chain source, randmat or mandel (default randmat)
+#   -o DIR       checkpoint directories go to DIR/MODE (default chain)
+#   -x OPTIONS   more options, for example "--chain-fusion on"
+#   MODE         memory mode to check (default: arena stream lazy)
+#
+# The binary is $SERIAL (default ../cowichan_serial/cowichan_serial). Stream
+# and lazy run randmat and half as one step: their first checkpoint is
+# compared with the half checkpoint of fresh.
+
+SERIAL=${SERIAL:-../cowichan_serial/cowichan_serial}
+SIZE=500
+SOURCE=randmat
+OUT=chain
+EXTRA=""
+
+while getopts "s:c:o:x:" OPTION; do
+    case $OPTION in
+	s) SIZE=$OPTARG ;;
+	c) SOURCE=$OPTARG ;;
+	o) OUT=$OPTARG ;;
+	x) EXTRA=$OPTARG ;;
+	*) sed -n '6,15p' $0; exit 1 ;;
+    esac
+done
+shift `expr $OPTIND - 1`
+
+MODES="$*"
+if [ "$MODES" = "" ]; then
+    MODES="arena stream lazy"
+fi
+
+FAILED=0
+for MODE in fresh $MODES; do
+    rm -rf $OUT/$MODE
+    mkdir -p $OUT/$MODE
+    if ! $SERIAL chain --size $SIZE --chain-source $SOURCE \
+	--chain-mask thresh --chain-memory $MODE --checkpoint $OUT/$MODE \
+	$EXTRA > /dev/null
+    then
+	echo " * The chain failed ($MODE)"
+	FAILED=1
+	continue
+    fi
+    if [ $MODE = fresh ]; then
+	continue
+    fi
+
+    # the last checkpoints of fresh line up with those of the mode
+    COUNT=`ls $OUT/$MODE | wc -l`
+    ls $OUT/fresh | tail -n $COUNT > $OUT/fresh.txt
+    ls $OUT/$MODE | paste -d ' ' $OUT/fresh.txt - | while read FRESH OTHER
+    do
+	if ! cmp -s $OUT/fresh/$FRESH $OUT/$MODE/$OTHER; then
+	    echo " * $MODE differs from fresh: $OTHER ($FRESH)"
+	fi
+    done > $OUT/diff.txt
+    if [ -s $OUT/diff.txt ] || [ $COUNT -eq 0 ]; then
+	cat $OUT/diff.txt
+	FAILED=1
+    else
+	echo "$MODE: $COUNT checkpoints identical to fresh"
+    fi
+    rm -f $OUT/fresh.txt $OUT/diff.txt
+done
+
+exit $FAILED
@@ -1,255 +0,0 @@
-/**
- * \file cowichan_defaults.hpp
- * \brief Defaults for Cowichan programs.
- */
-#ifndef __cowichan_defaults_hpp__
-#define __cowichan_defaults_hpp__
-
-// common
-/**
- * Default number of rows for rectangular matrices for all problems.
- */
-#define ALL_NR 15000
-
-/**
- * Default number of columns for rectangular matrices for all problems.
- */
-#define ALL_NC 15000
-
-/**
- * Default matrix size for square matrices for all problems.
- */
-#define ALL_N 15000
-
-/**
- * Default random number mean for inputs.
- */
-#define RAND_MEAN 0
-
-/**
- * Default random number range for inputs.
- */
-#define RAND_RANGE 20
-
-/**
- * Default random number seed.
- */
-#define RAND_SEED 681304
-
-/**
- * Default random number limit.
- */
-#define RAND_M 56197
-
-// mandel
-/**
- * Default number of rows for mandel.
- */
-#define MANDEL_NR ALL_NR
-
-/**
- * Default number of columns for mandel.
- */
-#define MANDEL_NC ALL_NC
-
-/**
- * Default x-coordinate of the lower left corner.
- */
-#define MANDEL_X0 0
-
-/**
- * Default y-coordinate of the lower left corner
- */
-#define MANDEL_Y0 0
-
-/**
- * Default extent of the region along the x axis.
- */
-#define MANDEL_DX 1.5
-
-/**
- * Default extent of the region along the y axis.
- */
-#define MANDEL_DY 1.5
-
-/**
- * Default mandel infinity.
- */
-#define MANDEL_INFINITY 2.0
-
-/**
- * Default mandel maximum number of iterations.
- */
-#define MANDEL_MAX_ITER 150
-
-// randmat
-/**
- * Default number of rows for randmat.
- */
-#define RANDMAT_NR ALL_NR
-
-/**
- * Default number of columns for randmat.
- */
-#define RANDMAT_NC ALL_NC
-
-/**
- * Default constant A for randmat.
- */
-#define RANDMAT_A  1291
-
-/**
- * Default constant C for randmat.
- */
-#define RANDMAT_C   917
-
-// half
-/**
- * Default number of rows for half.
- */
-#define HALF_NR ALL_NR
-
-/**
- * Default number of columns for half.
- */
-#define HALF_NC ALL_NC
-
-// invperc
-/**
- * Default number of rows for invperc.
- */
-#define INVPERC_NR ALL_NR
-
-/**
- * Default number of columns for invperc.
- */
-#define INVPERC_NC ALL_NC
-
-/**
- * Default number of cells to fill.
- */
-#define INVPERC_NFILL 1000000
-
-// thresh
-/**
- * Default number of rows for thresh.
- */
-#define THRESH_NR ALL_NR
-
-/**
- * Default number of columns for thresh.
- */
-#define THRESH_NC ALL_NC
-
-/**
- * Default threshold percentage.
- */
-#define THRESH_PERCENT 0.5
-
-// life
-/**
- * Default number of rows for life.
- */
-#define LIFE_NR ALL_NR
-
-/**
- * Default number of columns for life.
- */
-#define LIFE_NC ALL_NC
-
-/**
- * Default number of life iterations.
- */
-#define LIFE_ITERATIONS 3
-
-// winnow
-/**
- * Default rectangular matrix number of rows for winnow.
- */
-#define WINNOW_NR ALL_NR
-
-/**
- * Default rectangular matrix number of columns for winnow.
- */
-#define WINNOW_NC ALL_NC
-
-/**
- * Default square matrix size for winnow.
- */
-#define WINNOW_N ALL_N
-
-// norm
-/**
- * Default square matrix size for norm.
- */
-#define NORM_N ALL_N
-
-// hull
-/**
- * Default square matrix size for hull.
- */
-#define HULL_N ALL_N
-
-// outer
-/**
- * Default square matrix size for outer.
- */
-#define OUTER_N ALL_N
-
-// gauss
-/**
- * Default square matrix size for gauss.
- */
-#define GAUSS_N ALL_N
-
-// sor
-/**
- * Default square matrix size for sor.
- */
-#define SOR_N ALL_N
-
-/**
- * Default omega for sor.
- */
-#define SOR_OMEGA 0.9
-
-/**
- * Default floating point tolerance for sor.
- */
-#define SOR_TOLERANCE 10e-6
-
-/**
- * Default maximum number of iterations for sor.
- */
-#define SOR_MAX_ITERS 1000000
-
-// product
-/**
- * Default square matrix size for product.
- */
-#define PRODUCT_N ALL_N
-
-// vecdiff
-/**
- * Default square matrix size for vecdiff.
- */
-#define VECDIFF_N ALL_N
-
-// chain
-/**
- * Default number of rows for rectangular matrices for chain.
- */
-#define CHAIN_NR ALL_NR
-
-/**
- * Default number of columns for rectangular matrices for chain.
- */
-#define CHAIN_NC ALL_NC
-
-/**
- * Default matrix size for square matrices for chain.
- */
-#define CHAIN_N ALL_N
-
-#endif
-
@@ -0,0 +1,48 @@
+#!/bin/sh
+#
+# Times invperc with each queue (--invperc-queue) for several fill counts,
+# and checks that both queues fill the same cells.
+#
+# usage: invperc_queues.sh [-s SIZE] [-r REPEAT] [-x OPTIONS] [NFILL...]
+#
+#   -s SIZE      matrix size (default 8000)
+#   -r REPEAT    recorded runs per queue and fill count (default 5)
+#   -x OPTIONS   more options, for example "--warmup 1"
+#   NFILL        cells to fill (default: 10000 100000 1000000)
+#
+# The binary is $SERIAL (default ../cowichan_serial/cowichan_serial); the
+# check needs a build with OUTPUT_DATA, and is skipped otherwise.
+
+SERIAL=${SERIAL:-../cowichan_serial/cowichan_serial}
+SIZE=8000
+REPEAT=5
+EXTRA=""
+
+while getopts "s:r:x:" OPTION; do
+    case $OPTION in
+	s) SIZE=$OPTARG ;;
+	r) REPEAT=$OPTARG ;;
+	x) EXTRA=$OPTARG ;;
+	*) sed -n '6,14p' $0; exit 1 ;;
+    esac
+done
+shift `expr $OPTIND - 1`
+
+NFILLS="$*"
+if [ "$NFILLS" = "" ]; then
+    NFILLS="10000 100000 1000000"
+fi
+
+for NFILL in $NFILLS; do
+    for QUEUE in bucket heap; do
+	echo "$QUEUE: `$SERIAL invperc --size $SIZE --invperc-nfill $NFILL \
+	    --invperc-queue $QUEUE --repeat $REPEAT $EXTRA | grep seconds`"
+	$SERIAL invperc --size $SIZE --invperc-nfill $NFILL \
+	    --invperc-queue $QUEUE $EXTRA | grep -v seconds > queue_$QUEUE.txt
+    done
+    if [ -s queue_bucket.txt ] && ! cmp -s queue_bucket.txt queue_heap.txt
+    then
+	echo " * The queues fill different cells ($NFILL)"
+    fi
+    rm -f queue_bucket.txt queue_heap.txt
+done
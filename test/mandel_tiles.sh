@@ -0,0 +1,45 @@
+#!/bin/sh
+#
+# Compares tile shapes of the OpenMP mandel with one row at a time (tile
+# shape 1x0) across thread counts, through scaling.sh.
+#
+# usage: mandel_tiles.sh [-p P] [-t LIST] [-s SIZE] [-r REPEAT] [-b PIN]
+#                        [-o DIR] [-x OPTIONS] [SHAPE...]
+#
+#   -p, -t, -s, -r, -b, -o   as for scaling.sh (default -s 4000 -o tiles)
+#   -x OPTIONS   more mandel options, for example "--mandel-max-iter 1000"
+#   SHAPE        ROWSxCOLS (default: 1x0 1x256 4x256 16x128 64x64 256x16)
+#
+# The binary is $OPENMP (default ../cowichan_openmp/cowichan_openmp).
+
+OPENMP=${OPENMP:-../cowichan_openmp/cowichan_openmp}
+ARGS="-s 4000 -o tiles"
+THREADS=""
+EXTRA=""
+
+while getopts "p:t:s:r:b:o:x:" OPTION; do
+    case $OPTION in
+	t) THREADS=$OPTARG ;;
+	x) EXTRA=$OPTARG ;;
+	p|s|r|b|o) ARGS="$ARGS -$OPTION $OPTARG" ;;
+	*) sed -n '6,13p' $0; exit 1 ;;
+    esac
+done
+shift `expr $OPTIND - 1`
+
+SHAPES="$*"
+if [ "$SHAPES" = "" ]; then
+    SHAPES="1x0 1x256 4x256 16x128 64x64 256x16"
+fi
+
+# one implementation per shape
+set --
+for SHAPE in $SHAPES; do
+    set -- "$@" "$SHAPE=$OPENMP -- --mandel-tile $SHAPE $EXTRA"
+done
+
+if [ "$THREADS" = "" ]; then
+    `dirname $0`/scaling.sh $ARGS -k mandel "$@"
+else
+    `dirname $0`/scaling.sh $ARGS -t "$THREADS" -k mandel "$@"
+fi
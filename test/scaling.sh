@@ -0,0 +1,154 @@
+#!/bin/sh
+#
+# Runs every kernel and the chain at 1..P threads with several
+# implementations and prints one comparison table: median seconds, speedup
+# and parallel efficiency over the implementation's own 1-thread run, the
+# Karp-Flatt serial fraction, and the speedup over the serial implementation.
+#
+# usage: scaling.sh [-p P] [-t LIST] [-s SIZE] [-r REPEAT] [-b PIN]
+#                   [-k PROBLEMS] [-o DIR] NAME=COMMAND...
+#
+#   -p P         largest thread count; runs 1, 2, 4, ... and P (default: the
+#                number of processors)
+#   -t LIST      thread counts instead, for example "1 2 3 4"
+#   -s SIZE      --size for every problem (default: the problem defaults)
+#   -r REPEAT    recorded runs per point (default 3, after one warmup run)
+#   -b PIN       --pin mode: none, compact or scatter (default compact)
+#   -k PROBLEMS  problems to run (default: all kernels and the chain)
+#   -o DIR       where to keep the reports (default scaling)
+#
+# COMMAND runs one implementation; %p in it is replaced by the thread count,
+# and options after " -- " in it go after the problem name. An
+# implementation named serial is run at 1 thread only. For example:
+#
+#   ./scaling.sh -p 8 -s 4000 serial=../cowichan_serial/cowichan_serial \
+#       openmp=../cowichan_openmp/cowichan_openmp \
+#       tbb=../cowichan_tbb/cowichan_tbb \
+#       mpi="mpirun -np %p ../cowichan_mpi/cowichan_mpi"
+#
+# The table is also written to DIR/scaling.csv.
+
+MAX_THREADS=`getconf _NPROCESSORS_ONLN 2>/dev/null || echo 1`
+THREADS=""
+SIZE=""
+REPEAT=3
+PIN=compact
+PROBLEMS="mandel randmat half invperc thresh life winnow norm hull outer
+          gauss sor product vecdiff chain"
+DIR=scaling
+
+while getopts "p:t:s:r:b:k:o:" OPTION; do
+    case $OPTION in
+	p) MAX_THREADS=$OPTARG ;;
+	t) THREADS=$OPTARG ;;
+	s) SIZE="--size $OPTARG" ;;
+	r) REPEAT=$OPTARG ;;
+	b) PIN=$OPTARG ;;
+	k) PROBLEMS=$OPTARG ;;
+	o) DIR=$OPTARG ;;
+	*) sed -n '8,17p' $0; exit 1 ;;
+    esac
+done
+shift `expr $OPTIND - 1`
+
+if [ $# -eq 0 ]; then
+    sed -n '8,29p' $0
+    exit 1
+fi
+
+if [ "$THREADS" = "" ]; then
+    P=1
+    while [ $P -lt $MAX_THREADS ]; do
+	THREADS="$THREADS $P"
+	P=`expr $P \* 2`
+    done
+    THREADS="$THREADS $MAX_THREADS"
+fi
+
+mkdir -p $DIR || exit 1
+rm -f $DIR/*.csv
+
+# one report per implementation, problem and thread count
+for IMPL in "$@"; do
+    NAME=${IMPL%%=*}
+    COMMAND=${IMPL#*=}
+    OPTIONS=""
+    case "$COMMAND" in
+	*" -- "*) OPTIONS=${COMMAND#* -- }; COMMAND=${COMMAND%% -- *} ;;
+    esac
+    for P in $THREADS; do
+	if [ "$NAME" = "serial" ] && [ $P -ne 1 ]; then
+	    continue
+	fi
+	RUN=`echo "$COMMAND" | sed "s/%p/$P/g"`
+	RUN_OPTIONS=`echo "$OPTIONS" | sed "s/%p/$P/g"`
+	for PROBLEM in $PROBLEMS; do
+	    echo "$NAME: $PROBLEM at $P threads" >&2
+	    $RUN $PROBLEM $RUN_OPTIONS $SIZE --threads $P --pin $PIN --warmup 1 \
+		--repeat $REPEAT --format csv \
+		--output $DIR/$NAME-$PROBLEM-$P.csv > /dev/null \
+		|| echo " * $NAME failed on $PROBLEM at $P threads" >&2
+	done
+    done
+done
+
+# implementation, name, nr, nc, n, threads (as reported), median
+for IMPL in "$@"; do
+    NAME=${IMPL%%=*}
+    for FILE in $DIR/$NAME-*.csv; do
+	[ -f "$FILE" ] && tail -n +2 $FILE | cut -d, -f1-5,8 | sed "s/^/$NAME,/"
+    done
+done > $DIR/medians.tmp
+
+awk -F, -v csv=$DIR/scaling.csv '
+{
+    key = $2 "," $3 "," $4 "," $5
+    if (!(key in seen)) {
+	seen[key] = 1
+	keys[++nkeys] = key
+    }
+    if (!(key SUBSEP $1 SUBSEP $6 in time)) {
+	rows[key] = rows[key] " " NR
+    }
+    time[key, $1, $6] = $7
+    impl[NR] = $1
+    threads[NR] = $6
+}
+function fraction(s, p) {
+    return (p > 1 && s > 0) ? sprintf("%.4f", (1 / s - 1 / p) / (1 - 1 / p)) : ""
+}
+END {
+    print "name,nr,nc,n,implementation,threads,median,speedup,efficiency," \
+	"serial_fraction,vs_serial" > csv
+    printf "%-8s %-17s %-8s %7s %12s %8s %6s %7s %9s\n", "problem", "size",
+	"impl", "threads", "median (s)", "speedup", "eff", "serial",
+	"vs serial"
+    for (k = 1; k <= nkeys; k++) {
+	key = keys[k]
+	split(key, f, ",")
+	serial = ((key SUBSEP "serial" SUBSEP 1) in time) \
+	    ? time[key, "serial", 1] : ""
+	n = split(rows[key], list, " ")
+	for (i = 1; i <= n; i++) {
+	    r = list[i]
+	    t = time[key, impl[r], threads[r]]
+	    base = ((key SUBSEP impl[r] SUBSEP 1) in time) \
+		? time[key, impl[r], 1] : ""
+	    s = (base != "" && t > 0) ? base / t : 0
+	    speedup = s > 0 ? sprintf("%.3f", s) : ""
+	    efficiency = s > 0 ? sprintf("%.3f", s / threads[r]) : ""
+	    serialFraction = fraction(s, threads[r])
+	    vsSerial = (serial != "" && t > 0) ? sprintf("%.3f", serial / t) : ""
+	    # sizes the problem does not use are empty
+	    size = (f[2] != "") ? f[2] "x" f[3] : ""
+	    size = (f[4] == "") ? size : (size != "") ? size "/" f[4] : f[4]
+	    printf "%-8s %-17s %-8s %7d %12.6f %8s %6s %7s %9s\n", f[1],
+		size, impl[r], threads[r], t, speedup,
+		efficiency, serialFraction, vsSerial
+	    print key "," impl[r] "," threads[r] "," t "," speedup "," \
+		efficiency "," serialFraction "," vsSerial > csv
+	}
+    }
+}' $DIR/medians.tmp
+
+rm -f $DIR/medians.tmp
@@ -1,119 +1,24 @@
 /**
- * \file cowichan.cpp
- * \brief Implementation for Cowichan class and common routines for Cowichan
- * programs.
+ * \file test.cpp
+ * \brief Test driver: runs one serial kernel on inputs read from files and
+ * writes its output, in text or binary matrix file format.
  */
 
-#include "cowichan.hpp"
+#include "../cowichan_serial/cowichan_serial.hpp"
 #include <assert.h>
 #include <fstream>
 
-real uniform(real mean, real range) {
-  return (rand() / (real)RAND_MAX) * (2.0f * range) - range + mean;
-}
-
-/*****************************************************************************/
-
-void out_of_memory() {
-  std::cout << "--- Out of memory! ---";
-  exit(1);
-}
-
-void not_enough_points() {
-  std::cout << "--- Not enough points! ---";
-  exit(1);
-}
-
-void no_cells_alive() {
-  std::cout << "--- No cells alive! ---";
-  exit(1);
-}
-
-#ifdef OUTPUT_DATA
-void Cowichan::print_vector(PointVector points)
-{
-  index_t r;
-
-  for (r = 0; r < n; r++) {
-    std::cout << "[" << points[r].x << ", " << points[r].y << "]\n";
-  }
-  std::cout << "\n";
-}
-#else
-void Cowichan::print_vector(PointVector /* points */) { }
-#endif
-
-/*****************************************************************************/
-
-INT64 get_ticks ()
-{
-  INT64 count;
-#if defined(WIN32) || defined(WIN64)   // Windows
-  if (! QueryPerformanceCounter((LARGE_INTEGER *) &count)) {
-    count = GetTickCount (); // ms
-  }
-#else                // Linux
-  tms tm;
-  count = times (&tm);
-#endif               // end of Windows/Linux definitions
-  return count;
-}
-
-INT64 get_freq ()
-{
-  INT64 freq;
-#if defined(WIN32) || defined(WIN64)   // Windows
-  if (! QueryPerformanceFrequency((LARGE_INTEGER *) &freq)) {
-    freq = 1000; // ms
-  }
-#else                // Linux
-  freq = sysconf (_SC_CLK_TCK);
-#endif               // end of Windows/Linux definitions
-  return freq;
-}
-
-void print_elapsed_time (INT64 start, INT64 end)
-{
-  INT64 freq = get_freq ();
-  std::cout.precision(5);
-  std::cout << (((double) (end - start)) / ((double) freq)) << " seconds";
-  std::cout.flush();
-}
-
-void timeInfo(INT64 *start, INT64 *end, std::string message) {
-  *start = *end;
-  *end = get_ticks();
-  #ifdef TEST_TIME
-    std::cout << message << ": ";
-    print_elapsed_time(*start, *end);
-    std::cout << std::endl;
-  #endif
-}
-
-/*****************************************************************************/
-
-const char* Cowichan::CHAIN = "chain";
-const char* Cowichan::MANDEL = "mandel";
-const char* Cowichan::RANDMAT = "randmat";
-const char* Cowichan::HALF = "half";
-const char* Cowichan::INVPERC = "invperc";
-const char* Cowichan::THRESH = "thresh";
-const char* Cowichan::LIFE = "life";
-const char* Cowichan::WINNOW = "winnow";
-const char* Cowichan::NORM = "norm";
-const char* Cowichan::HULL = "hull";
-const char* Cowichan::OUTER = "outer";
-const char* Cowichan::GAUSS = "gauss";
-const char* Cowichan::SOR = "sor";
-const char* Cowichan::PRODUCT = "product";
-const char* Cowichan::VECDIFF = "vecdiff";
-
-
 using namespace std;
 
 int g_argc;
 char **g_argv;
 
+/**
+ * Inputs to free at exit: mapped matrix files, and arrays parsed from text.
+ */
+vector<MatrixFile*> g_files;
+vector<void*> g_arrays;
+
 void read_const(istream &in, string str) {
     const char* cur = str.c_str();
     string read("");
@@ -130,8 +35,21 @@ void read_const(istream &in, string str) {
     }
 }
 
+ostream &operator<<(ostream &out, const Point &p) {
+    out << "(" << p.x << ", " << p.y << ")";
+    return out;
+}
+
+istream &operator>>(istream &in, Point &p) {
+    read_const(in, "(");
+    in >> p.x;
+    read_const(in, ",");
+    in >> p.y;
+    read_const(in, ")");
+    return in;
+}
+
 bool get_arg_value (const char *key, char *&val) {
-    int i = 0;
     for (int i = 2; i < (g_argc - 1); i++) {
 	if (strcmp (g_argv[i], key) == 0) {
 	    val = g_argv[i + 1];
@@ -150,43 +68,62 @@ char *must_get_arg_value (const char *key) {
     return val;
 }
 
-bool get_int_arg_value (const char *key, int &val) {
-    char *val_str;
-    if (get_arg_value(key, val_str)) {
-	val = atoi(val_str);
-    } else {
-	return false;
-    }
-}
-
 int must_get_int_arg_value (const char *key) {
     return atoi(must_get_arg_value(key));
 }
 
+/**
+ * The integer data and baselines are signed text, as when INT_TYPE was
+ * INT32: integers are read and printed as INT32, whose 32 bits INT_TYPE
+ * keeps.
+ */
+template <class T>
+void value_parser (istream &in, T &value) {
+    in >> value;
+}
+
+template <>
+void value_parser (istream &in, INT_TYPE &value) {
+    INT32 read;
+    in >> read;
+    value = (INT_TYPE)read;
+}
+
+template <class T>
+void value_print (ostream &out, const T &value) {
+    out << value;
+}
+
+template <>
+void value_print (ostream &out, const INT_TYPE &value) {
+    out << (INT32)value;
+}
+
 template <class T>
-T *mat_parser (istream &in, int &rows, int &cols) {
+T *mat_parser (istream &in, index_t &rows, index_t &cols) {
 	T *mat;
 	in >> boolalpha;
 	in >> rows;
 	read_const(in, "x");
 	in >> cols;
-	mat = new T[rows * cols];
-	for (int i = 0; i < cols*rows; i += cols) {
+	mat = NEW_VECTOR_SZ(T, rows * cols);
+	g_arrays.push_back(mat);
+	for (index_t i = 0; i < cols*rows; i += cols) {
 	    read_const(in, "\n");
-	    for (int j = 0; j < cols; j++) {
-		in >> mat[i + j];
+	    for (index_t j = 0; j < cols; j++) {
+		value_parser(in, mat[i + j]);
 	    }
 	}
 	return mat;
 }
 
 template <class T>
-void mat_print (ostream &out, T *mat, int rows, int cols) {
+void mat_print (ostream &out, T *mat, index_t rows, index_t cols) {
     out << boolalpha;
     out << rows << 'x' << cols << endl;
-    for (int i = 0; i < rows*cols; i += cols) {
-	for (int j = 0; j < cols; j++) {
-	    out << mat[i + j];
+    for (index_t i = 0; i < rows*cols; i += cols) {
+	for (index_t j = 0; j < cols; j++) {
+	    value_print(out, mat[i + j]);
 	    if (j < (cols - 1)) { out << " "; }
 	}
 	out << endl;
@@ -194,23 +131,50 @@ void mat_print (ostream &out, T *mat, int rows, int cols) {
 }
 
 template <class T>
-T *vec_parser (istream &in, int &size) {
+T *vec_parser (istream &in, index_t &size) {
     T *vec;
     in >> size;
-    vec = new T[size];
-    for (int i = 0; i < size; i++) {
+    vec = NEW_VECTOR_SZ(T, size);
+    g_arrays.push_back(vec);
+    for (index_t i = 0; i < size; i++) {
 	read_const(in, "\n");
-	in >> vec[i];
+	value_parser(in, vec[i]);
     }
     return vec;
 }
 
 template <class T>
-void vec_print (ostream &out, T *vec, int size) {
+void vec_print (ostream &out, T *vec, index_t size) {
     out << size << endl;
-    for (int i = 0; i < size; i++) {
-	out << vec[i] << endl;
+    for (index_t i = 0; i < size; i++) {
+	value_print(out, vec[i]);
+	out << endl;
+    }
+}
+
+/**
+ * Outputs whose file name ends in MATRIX_FILE_EXTENSION are written as
+ * binary matrix files; everything else is text.
+ */
+bool is_binary_name (const char *file_name) {
+    size_t len = strlen(file_name);
+    size_t ext = strlen(MATRIX_FILE_EXTENSION);
+    return (len >= ext)
+	&& (strcmp(file_name + len - ext, MATRIX_FILE_EXTENSION) == 0);
+}
+
+/**
+ * Map an input if it is a binary matrix file (whatever its name).
+ * \return The file, or NULL if the input is text or standard input.
+ */
+MatrixFile *get_matrix_file_arg(const char *name) {
+    char *file_name;
+    if (get_arg_value(name, file_name) && is_matrix_file(file_name)) {
+	MatrixFile *file = new MatrixFile(file_name);
+	g_files.push_back(file);
+	return file;
     }
+    return NULL;
 }
 
 istream *get_istream_arg(const char *name) {
@@ -233,84 +197,145 @@ ostream *get_ostream_arg(const char *name) {
 
 void istream_close (istream *stream) {
     if (stream != &cin) {
-	//((ifstream*) stream)->close();
-	//delete stream;
+	delete stream;
     }
 }
 
 void ostream_close (ostream *stream) {
     if (stream != &cout) {
-	//((ofstream*) stream)->close();
-	//delete stream;
+	delete stream;
     }
 }
 
 template <class T>
-void get_matrix_arg(const char *name, T *&mat, int &rows, int &cols) {
+void get_matrix_arg(const char *name, T *&mat, index_t &rows, index_t &cols) {
+    MatrixFile *file = get_matrix_file_arg(name);
+    if (file != NULL) {
+	mat = file->data<T>();
+	rows = file->rows();
+	cols = file->cols();
+	return;
+    }
     istream *in = get_istream_arg(name);
     mat = mat_parser<T>(*in, rows, cols);
     istream_close(in);
 }
 
 template <class T>
-void get_matrix_arg_in(T *&mat, int &rows, int &cols) {
+void get_matrix_arg_in(T *&mat, index_t &rows, index_t &cols) {
     get_matrix_arg<T>("--in", mat, rows, cols);
 }
 
 template <class T>
-void put_matrix_arg(const char *name, T *mat, int rows, int cols) {
+void put_matrix_arg(const char *name, T *mat, index_t rows, index_t cols) {
+    char *file_name;
+    if (get_arg_value(name, file_name) && is_binary_name(file_name)) {
+	matrix_file_write(file_name, mat, rows, cols);
+	return;
+    }
     ostream *out = get_ostream_arg(name);
     mat_print<T>(*out, mat, rows, cols);
     ostream_close(out);
 }
 
 template <class T>
-void put_matrix_arg_out(T *mat, int rows, int cols) {
+void put_matrix_arg_out(T *mat, index_t rows, index_t cols) {
     put_matrix_arg<T>("--out", mat, rows, cols);
 }
 
 template <class T>
-void get_vector_arg(const char *name, T *&vec, int &size) {
+void get_vector_arg(const char *name, T *&vec, index_t &size) {
+    MatrixFile *file = get_matrix_file_arg(name);
+    if (file != NULL) {
+	vec = file->data<T>();
+	size = file->rows() * file->cols();
+	return;
+    }
     istream *in = get_istream_arg(name);
     vec = vec_parser<T>(*in, size);
     istream_close(in);
 }
 
 template <class T>
-void get_vector_arg_in(T *&vec, int &size) {
+void get_vector_arg_in(T *&vec, index_t &size) {
     get_vector_arg<T>("--in", vec, size);
 }
 
 template <class T>
-void put_vector_arg(const char *name, T* vec, int size) {
+void put_vector_arg(const char *name, T* vec, index_t size) {
+    char *file_name;
+    if (get_arg_value(name, file_name) && is_binary_name(file_name)) {
+	matrix_file_write(file_name, vec, size, 1);
+	return;
+    }
     ostream *out = get_ostream_arg(name);
     vec_print<T>(*out, vec, size);
     ostream_close(out);
 }
 
 template <class T>
-void put_vector_arg_out(T* vec, int size) {
+void put_vector_arg_out(T* vec, index_t size) {
     put_vector_arg<T>("--out", vec, size);
 }
 
-void Cowichan::main(int argc, char *argv[], bool, bool) {
+/**
+ * Copy a matrix from --in to --out, converting between text and binary.
+ */
+template <class T>
+void convert_matrix() {
+    T *mat;
+    index_t rows, cols;
+    get_matrix_arg_in<T>(mat, rows, cols);
+    put_matrix_arg_out<T>(mat, rows, cols);
+}
+
+/**
+ * Copy a vector from --in to --out, converting between text and binary.
+ */
+template <class T>
+void convert_vector() {
+    T *vec;
+    index_t size;
+    get_vector_arg_in<T>(vec, size);
+    put_vector_arg_out<T>(vec, size);
+}
+
+/**
+ * \brief The serial implementation, with its kernels driven from files.
+ */
+class CowichanTest : public CowichanSerial {
+public:
+
+  /**
+   * Run the command named by argv[1].
+   * \param argc number of command line arguments.
+   * \param argv command line arguments.
+   */
+  void test(int argc, char *argv[]);
+
+};
+
+void CowichanTest::test(int argc, char *argv[]) {
     g_argc = argc;
     g_argv = argv;
 
+    if (argc < 2) {
+	cout << "usage: " << argv[0] << " command [--name value]..." << endl;
+	exit(-1);
+    }
+
     if (strcmp(argv[1], "gauss") == 0) {
 	Matrix mat;
 	Vector target;
 	Vector solution;
-	int size; /* throw out */
 
 	get_matrix_arg<real>("--matrix", mat, nr, nc);
-	get_vector_arg<real>("--target", target, size);
+	get_vector_arg<real>("--target", target, n);
+	solution = NEW_VECTOR(real);
 	gauss(mat, target, solution);
-	put_vector_arg_out<real>(solution, size);
+	put_vector_arg_out<real>(solution, n);
 
-	delete [] mat;
-	delete [] target;
-	delete [] solution;
+	DELETE_ARRAY(solution);
 
     } else if (strcmp(argv[1], "half") == 0) {
 	IntMatrix mat;
@@ -320,33 +345,32 @@ void Cowichan::main(int argc, char *argv[], bool, bool) {
 	res = NEW_MATRIX_RECT(INT_TYPE);
 	half(mat, res);
 	put_matrix_arg_out<INT_TYPE>(res, nr, nc);
-	
-	delete [] mat;
-	delete [] res;
-	
+
+	DELETE_ARRAY(res);
+
     } else if (strcmp(argv[1], "hull") == 0) {
 	PointVector points;
 	PointVector hull_points;
-	
+
 	get_vector_arg_in<Point>(points, n);
 	hull_points = NEW_VECTOR(Point);
 	hull(points, hull_points);
 	put_vector_arg_out<Point>(hull_points, n);
 
-	delete [] points;
-	delete [] hull_points;
+	DELETE_ARRAY(hull_points);
+
     } else if (strcmp(argv[1], "invperc") == 0) {
 	IntMatrix mat;
 	BoolMatrix mask;
 
 	get_matrix_arg_in<INT_TYPE>(mat, nr, nc);
 	mask = NEW_MATRIX_RECT(bool);
+	memset(mask, 0, nr * nc * sizeof(bool));
 	invpercNFill = must_get_int_arg_value("--fill");
 	invperc(mat, mask);
 	put_matrix_arg_out<bool>(mask, nr, nc);
 
-	delete [] mat;
-	delete [] mask;
+	DELETE_ARRAY(mask);
 
     } else if (strcmp(argv[1], "life") == 0) {
 	BoolMatrix mat;
@@ -358,22 +382,22 @@ void Cowichan::main(int argc, char *argv[], bool, bool) {
 	life(mat, res);
 	put_matrix_arg_out<bool>(res, nr, nc);
 
-	delete [] mat;
-	delete [] res;
+	DELETE_ARRAY(res);
 
     } else if (strcmp(argv[1], "mandel") == 0) {
 	IntMatrix mat;
 
-	mandelX0 = must_get_int_arg_value("--x");
-	mandelY0 = must_get_int_arg_value("--y");
-	mandelDx = must_get_int_arg_value("--dx");
-	mandelDy = must_get_int_arg_value("--dy");
+	mandelX0 = atof(must_get_arg_value("--x"));
+	mandelY0 = atof(must_get_arg_value("--y"));
+	mandelDx = atof(must_get_arg_value("--dx"));
+	mandelDy = atof(must_get_arg_value("--dy"));
 	nr = must_get_int_arg_value("--rows");
 	nc = must_get_int_arg_value("--cols");
+	mat = NEW_MATRIX_RECT(INT_TYPE);
 	mandel(mat);
 	put_matrix_arg_out<INT_TYPE>(mat, nr, nc);
 
-	delete [] mat;
+	DELETE_ARRAY(mat);
 
     } else if (strcmp(argv[1], "norm") == 0) {
 	PointVector points_in;
@@ -384,8 +408,7 @@ void Cowichan::main(int argc, char *argv[], bool, bool) {
 	norm(points_in, points_out);
 	put_vector_arg_out<Point>(points_out, n);
 
-	delete [] points_in;
-	delete [] points_out;
+	DELETE_ARRAY(points_out);
 
     } else if (strcmp(argv[1], "outer") == 0) {
 	PointVector points;
@@ -401,10 +424,9 @@ void Cowichan::main(int argc, char *argv[], bool, bool) {
 	put_matrix_arg<real>("--mout", mat, nr, nc);
 	put_vector_arg<real>("--vout", vec, n);
 
-	delete [] points;
-	delete [] mat;
-	delete [] vec;
-	
+	DELETE_ARRAY(mat);
+	DELETE_ARRAY(vec);
+
     } else if (strcmp(argv[1], "product") == 0) {
 	/* product seems to deviate from the paper! */
 	Matrix matrix;
@@ -417,9 +439,7 @@ void Cowichan::main(int argc, char *argv[], bool, bool) {
 	product(matrix, candidate, solution);
 	put_vector_arg_out<real>(solution, n);
 
-	delete [] matrix;
-	delete [] candidate;
-	delete [] solution;
+	DELETE_ARRAY(solution);
 
     } else if (strcmp(argv[1], "randmat") == 0) {
 	IntMatrix mat;
@@ -430,8 +450,8 @@ void Cowichan::main(int argc, char *argv[], bool, bool) {
 	mat = NEW_MATRIX_RECT(INT_TYPE);
 	randmat(mat);
 	put_matrix_arg_out<INT_TYPE>(mat, nr, nc);
-	
-	delete [] mat;
+
+	DELETE_ARRAY(mat);
 
     } else if (strcmp(argv[1], "sor") == 0) {
 	/* sor deviates from paper... tolerance should be a parameter */
@@ -447,9 +467,7 @@ void Cowichan::main(int argc, char *argv[], bool, bool) {
 	sor(matrix, target, solution);
 	put_vector_arg_out<real>(solution, n);
 
-	delete [] matrix;
-	delete [] target;
-	delete [] solution;
+	DELETE_ARRAY(solution);
 
     } else if (strcmp(argv[1], "thresh") == 0) {
 	IntMatrix mat;
@@ -461,31 +479,26 @@ void Cowichan::main(int argc, char *argv[], bool, bool) {
 	thresh(mat, mask);
 	put_matrix_arg_out<bool>(mask, nr, nc);
 
-	delete [] mat;
-	delete [] mask;
+	DELETE_ARRAY(mask);
 
     } else if (strcmp(argv[1], "vecdiff") == 0) {
 	Vector v1;
 	Vector v2;
-	int m;
+	index_t m;
 	ostream *out;
-	real result;
-	
+
 	get_vector_arg<real>("--v1", v1, n);
 	get_vector_arg<real>("--v2", v2, m);
 	assert(m == n);
 	out = get_ostream_arg("--out");
 	*out << vecdiff(v1, v2) << endl;
 	ostream_close(out);
-	
-	delete [] v1;
-	delete [] v2;
 
     } else if (strcmp(argv[1], "winnow") == 0) {
 	IntMatrix matrix;
 	BoolMatrix mask;
 	PointVector points;
-	int mr, mc;
+	index_t mr, mc;
 
 	get_matrix_arg<INT_TYPE>("--matrix", matrix, nr, nc);
 	get_matrix_arg<bool>("--mask", mask, mr, mc);
@@ -494,17 +507,53 @@ void Cowichan::main(int argc, char *argv[], bool, bool) {
 	points = NEW_VECTOR(Point);
 	winnow(matrix, mask, points);
 	put_vector_arg_out<Point>(points, n);
-	
-	delete [] matrix;
-	delete [] mask;
-	delete [] points;
+
+	DELETE_ARRAY(points);
 
     } else if (strcmp(argv[1], "echo") == 0) {
-	IntMatrix matrix;
-	get_matrix_arg_in<INT_TYPE>(matrix, nr, nc);
-	put_matrix_arg_out<INT_TYPE>(matrix, nr,nc);
-	delete [] matrix;
+	convert_matrix<INT_TYPE>();
+
+    } else if (strcmp(argv[1], "convert") == 0) {
+	/* --type picks the element type and text layout of the input */
+	string type(must_get_arg_value("--type"));
+	if (type == "int") {
+	    convert_matrix<INT_TYPE>();
+	} else if (type == "bool") {
+	    convert_matrix<bool>();
+	} else if (type == "float") {
+	    convert_matrix<real>();
+	} else if (type == "vector") {
+	    convert_vector<real>();
+	} else if (type == "point") {
+	    convert_vector<Point>();
+	} else {
+	    cout << "unknown type `" << type << "`" << endl;
+	    exit(-1);
+	}
+
     } else {
 	cout << "Comand not recognized" << endl;
     }
+
+    for (size_t i = 0; i < g_files.size(); i++) {
+	delete g_files[i];
+    }
+    for (size_t i = 0; i < g_arrays.size(); i++) {
+	memory_free(g_arrays[i]);
+    }
+}
+
+/**
+ * Main method - creates a CowichanTest instance and runs one command.
+ * \param argc number of command line arguments.
+ * \param argv command line arguments.
+ */
+int main(int argc, char* argv[])
+{
+  CowichanTest* test = new CowichanTest ();
+
+  test->test(argc, argv);
+
+  delete test;
+  return 0;
 }
@@ -155,6 +155,7 @@ invperc_tests() {
     invperc_test invperc3 data/mat_50x50_nat 50
     invperc_test invperc4 data/mat_50x50_nat 75
     invperc_test invperc5 data/mat_50x50_nat 100
+    invperc_test invperc6 data/mat_20x20_mixed 150
 }
 
 life_tests() {